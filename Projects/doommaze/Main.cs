@@ -159,6 +159,7 @@ public partial class Main : Node
 		if (raycaster != null)
 		{
 			raycaster.SetProcess(false);
+			raycaster.SetPhysicsProcess(false);
 			raycaster.SetProcessInput(false);
 		}
 
@@ -170,29 +171,41 @@ public partial class Main : Node
 	// ============================
 	private void LoadTextures()
 	{
-		if (ResourceLoader.Exists("res://textures/wall.jpg"))
+		string[,] textures =
 		{
-			var wallTexture = Image.LoadFromFile("res://textures/wall.jpg");
-			raycaster.Call("set_wall_texture", wallTexture);
-		}
+			{ "res://textures/wall.jpg", "set_wall_texture" },
+			{ "res://textures/floor.jpg", "set_floor_texture" },
+			{ "res://textures/skybox.png", "set_ceiling_texture" },
+			{ "res://textures/key.png", "set_key_texture" },
+		};
 
-		if (ResourceLoader.Exists("res://textures/floor.jpg"))
+		var paths = new List<string>();
+		var setters = new List<string>();
+		for (int i = 0; i < textures.GetLength(0); i++)
 		{
-			var floorTexture = Image.LoadFromFile("res://textures/floor.jpg");
-			raycaster.Call("set_floor_texture", floorTexture);
+			if (ResourceLoader.Exists(textures[i, 0]))
+			{
+				paths.Add(textures[i, 0]);
+				setters.Add(textures[i, 1]);
+			}
 		}
 
-		if (ResourceLoader.Exists("res://textures/skybox.png"))
-		{
-			var ceilingTexture = Image.LoadFromFile("res://textures/skybox.png");
-			raycaster.Call("set_ceiling_texture", ceilingTexture);
-		}
+		if (paths.Count == 0)
+			return;
 
-		if (ResourceLoader.Exists("res://textures/key.png"))
+		// Decode all textures at once on the worker threads, they are handed to the raycaster on the main thread
+		var target = raycaster;
+		ClassDB.ClassCallStatic("Image", "load_from_files_async", paths.ToArray(), Callable.From((Godot.Collections.Array images) =>
 		{
-			var keyTexture = Image.LoadFromFile("res://textures/key.png");
-			raycaster.Call("set_key_texture", keyTexture);
-		}
+			if (!IsInstanceValid(target))
+				return;
+
+			for (int i = 0; i < images.Count; i++)
+			{
+				if (images[i].VariantType != Variant.Type.Nil)
+					target.Call(setters[i], images[i]);
+			}
+		}));
 	}
 
 	// ============================
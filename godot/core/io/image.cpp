@@ -37,7 +37,9 @@
 #include "core/io/resource_loader.h"
 #include "core/math/math_funcs.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/parallel_for.h"
 #include "core/variant/dictionary.h"
+#include "core/variant/typed_array.h"
 
 #include <cmath>
 
@@ -493,6 +495,31 @@ int Image::get_mipmap_count() const {
 	}
 }
 
+// Below this many pixels, the cost of posting tasks outweighs the gain from splitting.
+static constexpr int64_t IMAGE_PARALLEL_MIN_PIXELS = 256 * 256;
+static constexpr int64_t IMAGE_PARALLEL_BLOCK_PIXELS = 32 * 1024;
+
+// Calls p_func(from_row, to_row) over blocks of rows covering [0, p_height), on the
+// WorkerThreadPool for large images. Blocks never share rows, so functions writing
+// whole rows of the destination need no synchronization.
+// Small images, and calls made from a pool thread (e.g. threaded resource loading,
+// which is already parallel across files), run inline: waiting for a group from a
+// pool thread would block it.
+template <typename F>
+static void _for_each_row_block(int p_width, int p_height, const F &p_func) {
+	if ((int64_t)p_width * p_height < IMAGE_PARALLEL_MIN_PIXELS) {
+		p_func(0, p_height);
+		return;
+	}
+
+	const int rows_per_block = MAX(1, (int)(IMAGE_PARALLEL_BLOCK_PIXELS / MAX(p_width, 1)));
+	parallel_for(
+			0, p_height, [&p_func](int64_t p_from, int64_t p_to) {
+				p_func((int)p_from, (int)p_to);
+			},
+			rows_per_block);
+}
+
 // Using template generates perfectly optimized code due to constant expression reduction and unused variable removal present in all compilers.
 template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
 static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
@@ -556,6 +583,148 @@ static void _convert_fast(int p_width, int p_height, const T *p_src, T *p_dst) {
 	}
 }
 
+// Conversions between bit depths (8-bit, half and float) go through a row of RGBA floats.
+// They use the same arithmetic as get_pixel()/set_pixel(), so results match the per-pixel path
+// exactly, but each row is decoded and encoded in tight loops without per-pixel format dispatch.
+static _FORCE_INLINE_ float _channel_to_float(uint8_t p_value) {
+	return p_value / 255.0;
+}
+
+static _FORCE_INLINE_ float _channel_to_float(uint16_t p_value) {
+	return Math::half_to_float(p_value);
+}
+
+static _FORCE_INLINE_ float _channel_to_float(float p_value) {
+	return p_value;
+}
+
+static _FORCE_INLINE_ void _channel_from_float(float p_value, uint8_t &r_value) {
+	r_value = uint8_t(CLAMP(p_value * 255.0, 0, 255));
+}
+
+static _FORCE_INLINE_ void _channel_from_float(float p_value, uint16_t &r_value) {
+	r_value = Math::make_half_float(p_value);
+}
+
+static _FORCE_INLINE_ void _channel_from_float(float p_value, float &r_value) {
+	r_value = p_value;
+}
+
+template <typename T, uint32_t channels, bool gray>
+static void _decode_row(const uint8_t *p_src, float *__restrict p_rgba, int p_width) {
+	const T *__restrict src = (const T *)p_src;
+
+	for (int x = 0; x < p_width; x++) {
+		float rgba[4] = { 0, 0, 0, 1 };
+		for (uint32_t i = 0; i < channels; i++) {
+			rgba[i] = _channel_to_float(src[x * channels + i]);
+		}
+
+		if constexpr (gray) {
+			// L8 and LA8 store luminance and alpha.
+			rgba[3] = channels == 2 ? rgba[1] : 1;
+			rgba[1] = rgba[0];
+			rgba[2] = rgba[0];
+		}
+
+		memcpy(p_rgba + x * 4, rgba, sizeof(rgba));
+	}
+}
+
+template <typename T, uint32_t channels, bool gray>
+static void _encode_row(const float *__restrict p_rgba, uint8_t *p_dst, int p_width) {
+	T *__restrict dst = (T *)p_dst;
+
+	for (int x = 0; x < p_width; x++) {
+		const float *rgba = p_rgba + x * 4;
+
+		if constexpr (gray) {
+			// Same as Color::get_v().
+			_channel_from_float(MAX(MAX(rgba[0], rgba[1]), rgba[2]), dst[x * channels]);
+			if constexpr (channels == 2) {
+				_channel_from_float(rgba[3], dst[x * channels + 1]);
+			}
+		} else {
+			for (uint32_t i = 0; i < channels; i++) {
+				_channel_from_float(rgba[i], dst[x * channels + i]);
+			}
+		}
+	}
+}
+
+typedef void (*ImageRowDecodeFunc)(const uint8_t *p_src, float *p_rgba, int p_width);
+typedef void (*ImageRowEncodeFunc)(const float *p_rgba, uint8_t *p_dst, int p_width);
+
+static ImageRowDecodeFunc _get_row_decode_func(Image::Format p_format) {
+	switch (p_format) {
+		case Image::FORMAT_L8:
+			return _decode_row<uint8_t, 1, true>;
+		case Image::FORMAT_LA8:
+			return _decode_row<uint8_t, 2, true>;
+		case Image::FORMAT_R8:
+			return _decode_row<uint8_t, 1, false>;
+		case Image::FORMAT_RG8:
+			return _decode_row<uint8_t, 2, false>;
+		case Image::FORMAT_RGB8:
+			return _decode_row<uint8_t, 3, false>;
+		case Image::FORMAT_RGBA8:
+			return _decode_row<uint8_t, 4, false>;
+		case Image::FORMAT_RH:
+			return _decode_row<uint16_t, 1, false>;
+		case Image::FORMAT_RGH:
+			return _decode_row<uint16_t, 2, false>;
+		case Image::FORMAT_RGBH:
+			return _decode_row<uint16_t, 3, false>;
+		case Image::FORMAT_RGBAH:
+			return _decode_row<uint16_t, 4, false>;
+		case Image::FORMAT_RF:
+			return _decode_row<float, 1, false>;
+		case Image::FORMAT_RGF:
+			return _decode_row<float, 2, false>;
+		case Image::FORMAT_RGBF:
+			return _decode_row<float, 3, false>;
+		case Image::FORMAT_RGBAF:
+			return _decode_row<float, 4, false>;
+		default:
+			return nullptr;
+	}
+}
+
+static ImageRowEncodeFunc _get_row_encode_func(Image::Format p_format) {
+	switch (p_format) {
+		case Image::FORMAT_L8:
+			return _encode_row<uint8_t, 1, true>;
+		case Image::FORMAT_LA8:
+			return _encode_row<uint8_t, 2, true>;
+		case Image::FORMAT_R8:
+			return _encode_row<uint8_t, 1, false>;
+		case Image::FORMAT_RG8:
+			return _encode_row<uint8_t, 2, false>;
+		case Image::FORMAT_RGB8:
+			return _encode_row<uint8_t, 3, false>;
+		case Image::FORMAT_RGBA8:
+			return _encode_row<uint8_t, 4, false>;
+		case Image::FORMAT_RH:
+			return _encode_row<uint16_t, 1, false>;
+		case Image::FORMAT_RGH:
+			return _encode_row<uint16_t, 2, false>;
+		case Image::FORMAT_RGBH:
+			return _encode_row<uint16_t, 3, false>;
+		case Image::FORMAT_RGBAH:
+			return _encode_row<uint16_t, 4, false>;
+		case Image::FORMAT_RF:
+			return _encode_row<float, 1, false>;
+		case Image::FORMAT_RGF:
+			return _encode_row<float, 2, false>;
+		case Image::FORMAT_RGBF:
+			return _encode_row<float, 3, false>;
+		case Image::FORMAT_RGBAF:
+			return _encode_row<float, 4, false>;
+		default:
+			return nullptr;
+	}
+}
+
 static bool _are_formats_compatible(Image::Format p_format0, Image::Format p_format1) {
 	if (p_format0 <= Image::FORMAT_RGBA8 && p_format1 <= Image::FORMAT_RGBA8) {
 		return true;
@@ -582,7 +751,40 @@ void Image::convert(Format p_new_format) {
 	const int mipmap_count = get_mipmap_count() + 1;
 
 	if (!_are_formats_compatible(format, p_new_format)) {
-		// Use put/set pixel which is slower but works with non-byte formats.
+		const ImageRowDecodeFunc decode_func = _get_row_decode_func(format);
+		const ImageRowEncodeFunc encode_func = _get_row_encode_func(p_new_format);
+
+		if (decode_func && encode_func) {
+			Image new_img(width, height, mipmaps, p_new_format);
+			const int src_pixel_size = get_format_pixel_size(format);
+			const int dst_pixel_size = get_format_pixel_size(p_new_format);
+
+			for (int mip = 0; mip < mipmap_count; mip++) {
+				int64_t mip_offset = 0;
+				int64_t mip_size = 0;
+				int mip_width = 0;
+				int mip_height = 0;
+				get_mipmap_offset_size_and_dimensions(mip, mip_offset, mip_size, mip_width, mip_height);
+
+				const uint8_t *rptr = data.ptr() + mip_offset;
+				uint8_t *wptr = new_img.data.ptrw() + new_img.get_mipmap_offset(mip);
+
+				_for_each_row_block(mip_width, mip_height, [&](int p_from, int p_to) {
+					LocalVector<float> row;
+					row.resize(mip_width * 4);
+					for (int y = p_from; y < p_to; y++) {
+						decode_func(rptr + (int64_t)y * mip_width * src_pixel_size, row.ptr(), mip_width);
+						encode_func(row.ptr(), wptr + (int64_t)y * mip_width * dst_pixel_size, mip_width);
+					}
+				});
+			}
+
+			_copy_internals_from(new_img);
+
+			return;
+		}
+
+		// Use put/set pixel which is slower but works with any uncompressed format.
 		Image new_img(width, height, mipmaps, p_new_format);
 
 		for (int mip = 0; mip < mipmap_count; mip++) {
@@ -611,6 +813,8 @@ void Image::convert(Format p_new_format) {
 	Image new_img(width, height, mipmaps, p_new_format);
 
 	const int conversion_type = format | p_new_format << 8;
+	const int src_pixel_size = get_format_pixel_size(format);
+	const int dst_pixel_size = get_format_pixel_size(p_new_format);
 
 	for (int mip = 0; mip < mipmap_count; mip++) {
 		int64_t mip_offset = 0;
@@ -619,173 +823,179 @@ void Image::convert(Format p_new_format) {
 		int mip_height = 0;
 		get_mipmap_offset_size_and_dimensions(mip, mip_offset, mip_size, mip_width, mip_height);
 
-		const uint8_t *rptr = data.ptr() + mip_offset;
-		uint8_t *wptr = new_img.data.ptrw() + new_img.get_mipmap_offset(mip);
+		const uint8_t *mip_rptr = data.ptr() + mip_offset;
+		uint8_t *mip_wptr = new_img.data.ptrw() + new_img.get_mipmap_offset(mip);
 
-		switch (conversion_type) {
-			case FORMAT_L8 | (FORMAT_LA8 << 8):
-				_convert<1, false, 1, true, true, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_L8 | (FORMAT_R8 << 8):
-				_convert<1, false, 1, false, true, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_L8 | (FORMAT_RG8 << 8):
-				_convert<1, false, 2, false, true, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_L8 | (FORMAT_RGB8 << 8):
-				_convert<1, false, 3, false, true, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_L8 | (FORMAT_RGBA8 << 8):
-				_convert<1, false, 3, true, true, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_LA8 | (FORMAT_L8 << 8):
-				_convert<1, true, 1, false, true, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_LA8 | (FORMAT_R8 << 8):
-				_convert<1, true, 1, false, true, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_LA8 | (FORMAT_RG8 << 8):
-				_convert<1, true, 2, false, true, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_LA8 | (FORMAT_RGB8 << 8):
-				_convert<1, true, 3, false, true, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_LA8 | (FORMAT_RGBA8 << 8):
-				_convert<1, true, 3, true, true, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_R8 | (FORMAT_L8 << 8):
-				_convert<1, false, 1, false, false, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_R8 | (FORMAT_LA8 << 8):
-				_convert<1, false, 1, true, false, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_R8 | (FORMAT_RG8 << 8):
-				_convert<1, false, 2, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_R8 | (FORMAT_RGB8 << 8):
-				_convert<1, false, 3, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_R8 | (FORMAT_RGBA8 << 8):
-				_convert<1, false, 3, true, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RG8 | (FORMAT_L8 << 8):
-				_convert<2, false, 1, false, false, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RG8 | (FORMAT_LA8 << 8):
-				_convert<2, false, 1, true, false, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RG8 | (FORMAT_R8 << 8):
-				_convert<2, false, 1, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RG8 | (FORMAT_RGB8 << 8):
-				_convert<2, false, 3, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RG8 | (FORMAT_RGBA8 << 8):
-				_convert<2, false, 3, true, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGB8 | (FORMAT_L8 << 8):
-				_convert<3, false, 1, false, false, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGB8 | (FORMAT_LA8 << 8):
-				_convert<3, false, 1, true, false, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGB8 | (FORMAT_R8 << 8):
-				_convert<3, false, 1, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGB8 | (FORMAT_RG8 << 8):
-				_convert<3, false, 2, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGB8 | (FORMAT_RGBA8 << 8):
-				_convert<3, false, 3, true, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGBA8 | (FORMAT_L8 << 8):
-				_convert<3, true, 1, false, false, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGBA8 | (FORMAT_LA8 << 8):
-				_convert<3, true, 1, true, false, true>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGBA8 | (FORMAT_R8 << 8):
-				_convert<3, true, 1, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGBA8 | (FORMAT_RG8 << 8):
-				_convert<3, true, 2, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RGBA8 | (FORMAT_RGB8 << 8):
-				_convert<3, true, 3, false, false, false>(mip_width, mip_height, rptr, wptr);
-				break;
-			case FORMAT_RH | (FORMAT_RGH << 8):
-				_convert_fast<uint16_t, 1, 2, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RH | (FORMAT_RGBH << 8):
-				_convert_fast<uint16_t, 1, 3, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RH | (FORMAT_RGBAH << 8):
-				_convert_fast<uint16_t, 1, 4, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGH | (FORMAT_RH << 8):
-				_convert_fast<uint16_t, 2, 1, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGH | (FORMAT_RGBH << 8):
-				_convert_fast<uint16_t, 2, 3, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGH | (FORMAT_RGBAH << 8):
-				_convert_fast<uint16_t, 2, 4, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGBH | (FORMAT_RH << 8):
-				_convert_fast<uint16_t, 3, 1, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGBH | (FORMAT_RGH << 8):
-				_convert_fast<uint16_t, 3, 2, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGBH | (FORMAT_RGBAH << 8):
-				_convert_fast<uint16_t, 3, 4, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGBAH | (FORMAT_RH << 8):
-				_convert_fast<uint16_t, 4, 1, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGBAH | (FORMAT_RGH << 8):
-				_convert_fast<uint16_t, 4, 2, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RGBAH | (FORMAT_RGBH << 8):
-				_convert_fast<uint16_t, 4, 3, 0x0000, 0x3C00>(mip_width, mip_height, (const uint16_t *)rptr, (uint16_t *)wptr);
-				break;
-			case FORMAT_RF | (FORMAT_RGF << 8):
-				_convert_fast<uint32_t, 1, 2, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RF | (FORMAT_RGBF << 8):
-				_convert_fast<uint32_t, 1, 3, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RF | (FORMAT_RGBAF << 8):
-				_convert_fast<uint32_t, 1, 4, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGF | (FORMAT_RF << 8):
-				_convert_fast<uint32_t, 2, 1, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGF | (FORMAT_RGBF << 8):
-				_convert_fast<uint32_t, 2, 3, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGF | (FORMAT_RGBAF << 8):
-				_convert_fast<uint32_t, 2, 4, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGBF | (FORMAT_RF << 8):
-				_convert_fast<uint32_t, 3, 1, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGBF | (FORMAT_RGF << 8):
-				_convert_fast<uint32_t, 3, 2, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGBF | (FORMAT_RGBAF << 8):
-				_convert_fast<uint32_t, 3, 4, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGBAF | (FORMAT_RF << 8):
-				_convert_fast<uint32_t, 4, 1, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGBAF | (FORMAT_RGF << 8):
-				_convert_fast<uint32_t, 4, 2, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-			case FORMAT_RGBAF | (FORMAT_RGBF << 8):
-				_convert_fast<uint32_t, 4, 3, 0x00000000, 0x3F800000>(mip_width, mip_height, (const uint32_t *)rptr, (uint32_t *)wptr);
-				break;
-		}
+		_for_each_row_block(mip_width, mip_height, [&](int p_from, int p_to) {
+			const uint8_t *rptr = mip_rptr + (int64_t)p_from * mip_width * src_pixel_size;
+			uint8_t *wptr = mip_wptr + (int64_t)p_from * mip_width * dst_pixel_size;
+			const int rows = p_to - p_from;
+
+			switch (conversion_type) {
+				case FORMAT_L8 | (FORMAT_LA8 << 8):
+					_convert<1, false, 1, true, true, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_L8 | (FORMAT_R8 << 8):
+					_convert<1, false, 1, false, true, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_L8 | (FORMAT_RG8 << 8):
+					_convert<1, false, 2, false, true, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_L8 | (FORMAT_RGB8 << 8):
+					_convert<1, false, 3, false, true, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_L8 | (FORMAT_RGBA8 << 8):
+					_convert<1, false, 3, true, true, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_LA8 | (FORMAT_L8 << 8):
+					_convert<1, true, 1, false, true, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_LA8 | (FORMAT_R8 << 8):
+					_convert<1, true, 1, false, true, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_LA8 | (FORMAT_RG8 << 8):
+					_convert<1, true, 2, false, true, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_LA8 | (FORMAT_RGB8 << 8):
+					_convert<1, true, 3, false, true, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_LA8 | (FORMAT_RGBA8 << 8):
+					_convert<1, true, 3, true, true, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_R8 | (FORMAT_L8 << 8):
+					_convert<1, false, 1, false, false, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_R8 | (FORMAT_LA8 << 8):
+					_convert<1, false, 1, true, false, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_R8 | (FORMAT_RG8 << 8):
+					_convert<1, false, 2, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_R8 | (FORMAT_RGB8 << 8):
+					_convert<1, false, 3, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_R8 | (FORMAT_RGBA8 << 8):
+					_convert<1, false, 3, true, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RG8 | (FORMAT_L8 << 8):
+					_convert<2, false, 1, false, false, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RG8 | (FORMAT_LA8 << 8):
+					_convert<2, false, 1, true, false, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RG8 | (FORMAT_R8 << 8):
+					_convert<2, false, 1, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RG8 | (FORMAT_RGB8 << 8):
+					_convert<2, false, 3, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RG8 | (FORMAT_RGBA8 << 8):
+					_convert<2, false, 3, true, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGB8 | (FORMAT_L8 << 8):
+					_convert<3, false, 1, false, false, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGB8 | (FORMAT_LA8 << 8):
+					_convert<3, false, 1, true, false, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGB8 | (FORMAT_R8 << 8):
+					_convert<3, false, 1, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGB8 | (FORMAT_RG8 << 8):
+					_convert<3, false, 2, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGB8 | (FORMAT_RGBA8 << 8):
+					_convert<3, false, 3, true, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGBA8 | (FORMAT_L8 << 8):
+					_convert<3, true, 1, false, false, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGBA8 | (FORMAT_LA8 << 8):
+					_convert<3, true, 1, true, false, true>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGBA8 | (FORMAT_R8 << 8):
+					_convert<3, true, 1, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGBA8 | (FORMAT_RG8 << 8):
+					_convert<3, true, 2, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RGBA8 | (FORMAT_RGB8 << 8):
+					_convert<3, true, 3, false, false, false>(mip_width, rows, rptr, wptr);
+					break;
+				case FORMAT_RH | (FORMAT_RGH << 8):
+					_convert_fast<uint16_t, 1, 2, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RH | (FORMAT_RGBH << 8):
+					_convert_fast<uint16_t, 1, 3, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RH | (FORMAT_RGBAH << 8):
+					_convert_fast<uint16_t, 1, 4, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGH | (FORMAT_RH << 8):
+					_convert_fast<uint16_t, 2, 1, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGH | (FORMAT_RGBH << 8):
+					_convert_fast<uint16_t, 2, 3, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGH | (FORMAT_RGBAH << 8):
+					_convert_fast<uint16_t, 2, 4, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGBH | (FORMAT_RH << 8):
+					_convert_fast<uint16_t, 3, 1, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGBH | (FORMAT_RGH << 8):
+					_convert_fast<uint16_t, 3, 2, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGBH | (FORMAT_RGBAH << 8):
+					_convert_fast<uint16_t, 3, 4, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGBAH | (FORMAT_RH << 8):
+					_convert_fast<uint16_t, 4, 1, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGBAH | (FORMAT_RGH << 8):
+					_convert_fast<uint16_t, 4, 2, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RGBAH | (FORMAT_RGBH << 8):
+					_convert_fast<uint16_t, 4, 3, 0x0000, 0x3C00>(mip_width, rows, (const uint16_t *)rptr, (uint16_t *)wptr);
+					break;
+				case FORMAT_RF | (FORMAT_RGF << 8):
+					_convert_fast<uint32_t, 1, 2, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RF | (FORMAT_RGBF << 8):
+					_convert_fast<uint32_t, 1, 3, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RF | (FORMAT_RGBAF << 8):
+					_convert_fast<uint32_t, 1, 4, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGF | (FORMAT_RF << 8):
+					_convert_fast<uint32_t, 2, 1, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGF | (FORMAT_RGBF << 8):
+					_convert_fast<uint32_t, 2, 3, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGF | (FORMAT_RGBAF << 8):
+					_convert_fast<uint32_t, 2, 4, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGBF | (FORMAT_RF << 8):
+					_convert_fast<uint32_t, 3, 1, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGBF | (FORMAT_RGF << 8):
+					_convert_fast<uint32_t, 3, 2, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGBF | (FORMAT_RGBAF << 8):
+					_convert_fast<uint32_t, 3, 4, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGBAF | (FORMAT_RF << 8):
+					_convert_fast<uint32_t, 4, 1, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGBAF | (FORMAT_RGF << 8):
+					_convert_fast<uint32_t, 4, 2, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+				case FORMAT_RGBAF | (FORMAT_RGBF << 8):
+					_convert_fast<uint32_t, 4, 3, 0x00000000, 0x3F800000>(mip_width, rows, (const uint32_t *)rptr, (uint32_t *)wptr);
+					break;
+			}
+		});
 	}
 
 	_copy_internals_from(new_img);
@@ -809,91 +1019,99 @@ static double _bicubic_interp_kernel(double x) {
 	return bc;
 }
 
+template <typename T>
+static _FORCE_INLINE_ double _cubic_tap(const T *p_src, uint32_t p_index) {
+	if constexpr (sizeof(T) == 2) { //half float
+		return Math::half_to_float(p_src[p_index]);
+	} else {
+		return p_src[p_index];
+	}
+}
+
 template <int CC, typename T>
 static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	// get source image size
-	int width = p_src_width;
-	int height = p_src_height;
-	double xfac = (double)width / p_dst_width;
-	double yfac = (double)height / p_dst_height;
-	// coordinates of source points and coefficients
-	double ox, oy, dx, dy;
-	int ox1, oy1, ox2, oy2;
-	// destination pixel values
+	const double xfac = (double)p_src_width / p_dst_width;
+	const double yfac = (double)p_src_height / p_dst_height;
 	// width and height decreased by 1
-	int ymax = height - 1;
-	int xmax = width - 1;
-	// temporary pointer
-
-	for (uint32_t y = 0; y < p_dst_height; y++) {
-		// Y coordinates
-		oy = (double)y * yfac - 0.5f;
-		oy1 = (int)oy;
-		dy = oy - (double)oy1;
-
-		for (uint32_t x = 0; x < p_dst_width; x++) {
-			// X coordinates
-			ox = (double)x * xfac - 0.5f;
-			ox1 = (int)ox;
-			dx = ox - (double)ox1;
+	const int xmax = p_src_width - 1;
+	const int ymax = p_src_height - 1;
+
+	// The bicubic kernel is separable, so rows are filtered horizontally first and the results
+	// are combined vertically. The horizontal taps and weights are the same for every row.
+	LocalVector<uint32_t> x_taps;
+	LocalVector<double> x_weights;
+	x_taps.resize(p_dst_width * 4);
+	x_weights.resize(p_dst_width * 4);
+
+	for (uint32_t x = 0; x < p_dst_width; x++) {
+		double ox = (double)x * xfac - 0.5f;
+		int ox1 = (int)ox;
+		double dx = ox - (double)ox1;
+
+		for (int m = -1; m < 3; m++) {
+			x_taps[x * 4 + m + 1] = CLAMP(ox1 + m, 0, xmax) * CC;
+			x_weights[x * 4 + m + 1] = _bicubic_interp_kernel((double)m - dx);
+		}
+	}
 
-			// initial pixel value
+	_for_each_row_block(p_dst_width, p_dst_height, [&](int p_from, int p_to) {
+		// Horizontally filtered source rows. Consecutive destination rows share most of their
+		// source rows, and the (at most 4) rows one destination row needs never share a slot.
+		LocalVector<double> filtered[4];
+		int filtered_row[4] = { -1, -1, -1, -1 };
+		for (int i = 0; i < 4; i++) {
+			filtered[i].resize(p_dst_width * CC);
+		}
 
-			T *__restrict dst = ((T *)p_dst) + (y * p_dst_width + x) * CC;
+		for (int y = p_from; y < p_to; y++) {
+			double oy = (double)y * yfac - 0.5f;
+			int oy1 = (int)oy;
+			double dy = oy - (double)oy1;
 
-			double color[CC];
-			for (int i = 0; i < CC; i++) {
-				color[i] = 0;
-			}
+			const double *rows[4];
+			double y_weights[4];
 
 			for (int n = -1; n < 3; n++) {
-				// get Y coefficient
-				[[maybe_unused]] double k1 = _bicubic_interp_kernel(dy - (double)n);
-
-				oy2 = oy1 + n;
-				if (oy2 < 0) {
-					oy2 = 0;
-				}
-				if (oy2 > ymax) {
-					oy2 = ymax;
-				}
-
-				for (int m = -1; m < 3; m++) {
-					// get X coefficient
-					[[maybe_unused]] double k2 = k1 * _bicubic_interp_kernel((double)m - dx);
-
-					ox2 = ox1 + m;
-					if (ox2 < 0) {
-						ox2 = 0;
-					}
-					if (ox2 > xmax) {
-						ox2 = xmax;
-					}
-
-					// get pixel of original image
-					const T *__restrict p = ((T *)p_src) + (oy2 * p_src_width + ox2) * CC;
-
-					for (int i = 0; i < CC; i++) {
-						if constexpr (sizeof(T) == 2) { //half float
-							color[i] = Math::half_to_float(p[i]);
-						} else {
-							color[i] += p[i] * k2;
+				const int oy2 = CLAMP(oy1 + n, 0, ymax);
+				const int slot = oy2 & 3;
+
+				if (filtered_row[slot] != oy2) {
+					const T *__restrict src_row = ((const T *)p_src) + oy2 * p_src_width * CC;
+					double *__restrict row = filtered[slot].ptr();
+
+					for (uint32_t x = 0; x < p_dst_width; x++) {
+						const uint32_t *taps = &x_taps[x * 4];
+						const double *weights = &x_weights[x * 4];
+
+						for (int i = 0; i < CC; i++) {
+							row[x * CC + i] = _cubic_tap(src_row, taps[0] + i) * weights[0] +
+									_cubic_tap(src_row, taps[1] + i) * weights[1] +
+									_cubic_tap(src_row, taps[2] + i) * weights[2] +
+									_cubic_tap(src_row, taps[3] + i) * weights[3];
 						}
 					}
+					filtered_row[slot] = oy2;
 				}
+
+				rows[n + 1] = filtered[slot].ptr();
+				y_weights[n + 1] = _bicubic_interp_kernel(dy - (double)n);
 			}
 
-			for (int i = 0; i < CC; i++) {
+			T *__restrict dst = ((T *)p_dst) + y * p_dst_width * CC;
+
+			for (uint32_t i = 0; i < p_dst_width * CC; i++) {
+				double color = rows[0][i] * y_weights[0] + rows[1][i] * y_weights[1] + rows[2][i] * y_weights[2] + rows[3][i] * y_weights[3];
+
 				if constexpr (sizeof(T) == 1) { //byte
-					dst[i] = CLAMP(Math::fast_ftoi(color[i]), 0, 255);
+					dst[i] = CLAMP(Math::fast_ftoi(color), 0, 255);
 				} else if constexpr (sizeof(T) == 2) { //half float
-					dst[i] = Math::make_half_float(color[i]);
+					dst[i] = Math::make_half_float(color);
 				} else {
-					dst[i] = color[i];
+					dst[i] = color;
 				}
 			}
 		}
-	}
+	});
 }
 
 template <int CC, typename T>
@@ -903,106 +1121,129 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 	constexpr uint32_t FRAC_HALF = (FRAC_LEN >> 1);
 	constexpr uint32_t FRAC_MASK = FRAC_LEN - 1;
 
-	for (uint32_t i = 0; i < p_dst_height; i++) {
-		// Add 0.5 in order to interpolate based on pixel center
-		uint32_t src_yofs_up_fp = (i + 0.5) * p_src_height * FRAC_LEN / p_dst_height;
-		// Calculate nearest src pixel center above current, and truncate to get y index
-		uint32_t src_yofs_up = src_yofs_up_fp >= FRAC_HALF ? (src_yofs_up_fp - FRAC_HALF) >> FRAC_BITS : 0;
-		uint32_t src_yofs_down = (src_yofs_up_fp + FRAC_HALF) >> FRAC_BITS;
-		if (src_yofs_down >= p_src_height) {
-			src_yofs_down = p_src_height - 1;
+	struct Tap {
+		uint32_t left = 0;
+		uint32_t right = 0;
+		uint32_t frac = 0;
+	};
+
+	// The horizontal taps are the same for every row, so compute them once.
+	LocalVector<Tap> x_taps;
+	x_taps.resize(p_dst_width);
+
+	for (uint32_t j = 0; j < p_dst_width; j++) {
+		uint32_t src_xofs_left_fp = (j + 0.5) * p_src_width * FRAC_LEN / p_dst_width;
+		uint32_t src_xofs_left = src_xofs_left_fp >= FRAC_HALF ? (src_xofs_left_fp - FRAC_HALF) >> FRAC_BITS : 0;
+		uint32_t src_xofs_right = (src_xofs_left_fp + FRAC_HALF) >> FRAC_BITS;
+		if (src_xofs_right >= p_src_width) {
+			src_xofs_right = p_src_width - 1;
 		}
-		// Calculate distance to pixel center of src_yofs_up
-		uint32_t src_yofs_frac = src_yofs_up_fp & FRAC_MASK;
-		src_yofs_frac = src_yofs_frac >= FRAC_HALF ? src_yofs_frac - FRAC_HALF : src_yofs_frac + FRAC_HALF;
-
-		uint32_t y_ofs_up = src_yofs_up * p_src_width * CC;
-		uint32_t y_ofs_down = src_yofs_down * p_src_width * CC;
-
-		for (uint32_t j = 0; j < p_dst_width; j++) {
-			uint32_t src_xofs_left_fp = (j + 0.5) * p_src_width * FRAC_LEN / p_dst_width;
-			uint32_t src_xofs_left = src_xofs_left_fp >= FRAC_HALF ? (src_xofs_left_fp - FRAC_HALF) >> FRAC_BITS : 0;
-			uint32_t src_xofs_right = (src_xofs_left_fp + FRAC_HALF) >> FRAC_BITS;
-			if (src_xofs_right >= p_src_width) {
-				src_xofs_right = p_src_width - 1;
+		uint32_t src_xofs_frac = src_xofs_left_fp & FRAC_MASK;
+		src_xofs_frac = src_xofs_frac >= FRAC_HALF ? src_xofs_frac - FRAC_HALF : src_xofs_frac + FRAC_HALF;
+
+		x_taps[j].left = src_xofs_left * CC;
+		x_taps[j].right = src_xofs_right * CC;
+		x_taps[j].frac = src_xofs_frac;
+	}
+
+	_for_each_row_block(p_dst_width, p_dst_height, [&](int p_from, int p_to) {
+		for (uint32_t i = p_from; i < (uint32_t)p_to; i++) {
+			// Add 0.5 in order to interpolate based on pixel center
+			uint32_t src_yofs_up_fp = (i + 0.5) * p_src_height * FRAC_LEN / p_dst_height;
+			// Calculate nearest src pixel center above current, and truncate to get y index
+			uint32_t src_yofs_up = src_yofs_up_fp >= FRAC_HALF ? (src_yofs_up_fp - FRAC_HALF) >> FRAC_BITS : 0;
+			uint32_t src_yofs_down = (src_yofs_up_fp + FRAC_HALF) >> FRAC_BITS;
+			if (src_yofs_down >= p_src_height) {
+				src_yofs_down = p_src_height - 1;
 			}
-			uint32_t src_xofs_frac = src_xofs_left_fp & FRAC_MASK;
-			src_xofs_frac = src_xofs_frac >= FRAC_HALF ? src_xofs_frac - FRAC_HALF : src_xofs_frac + FRAC_HALF;
-
-			src_xofs_left *= CC;
-			src_xofs_right *= CC;
-
-			for (uint32_t l = 0; l < CC; l++) {
-				if constexpr (sizeof(T) == 1) { //uint8
-					uint32_t p00 = p_src[y_ofs_up + src_xofs_left + l] << FRAC_BITS;
-					uint32_t p10 = p_src[y_ofs_up + src_xofs_right + l] << FRAC_BITS;
-					uint32_t p01 = p_src[y_ofs_down + src_xofs_left + l] << FRAC_BITS;
-					uint32_t p11 = p_src[y_ofs_down + src_xofs_right + l] << FRAC_BITS;
-
-					uint32_t interp_up = p00 + (((p10 - p00) * src_xofs_frac) >> FRAC_BITS);
-					uint32_t interp_down = p01 + (((p11 - p01) * src_xofs_frac) >> FRAC_BITS);
-					uint32_t interp = interp_up + (((interp_down - interp_up) * src_yofs_frac) >> FRAC_BITS);
-					interp >>= FRAC_BITS;
-					p_dst[i * p_dst_width * CC + j * CC + l] = uint8_t(interp);
-				} else if constexpr (sizeof(T) == 2) { //half float
+			// Calculate distance to pixel center of src_yofs_up
+			uint32_t src_yofs_frac = src_yofs_up_fp & FRAC_MASK;
+			src_yofs_frac = src_yofs_frac >= FRAC_HALF ? src_yofs_frac - FRAC_HALF : src_yofs_frac + FRAC_HALF;
+
+			uint32_t y_ofs_up = src_yofs_up * p_src_width * CC;
+			uint32_t y_ofs_down = src_yofs_down * p_src_width * CC;
+
+			for (uint32_t j = 0; j < p_dst_width; j++) {
+				const uint32_t src_xofs_left = x_taps[j].left;
+				const uint32_t src_xofs_right = x_taps[j].right;
+				const uint32_t src_xofs_frac = x_taps[j].frac;
+
+				for (uint32_t l = 0; l < CC; l++) {
+					if constexpr (sizeof(T) == 1) { //uint8
+						uint32_t p00 = p_src[y_ofs_up + src_xofs_left + l] << FRAC_BITS;
+						uint32_t p10 = p_src[y_ofs_up + src_xofs_right + l] << FRAC_BITS;
+						uint32_t p01 = p_src[y_ofs_down + src_xofs_left + l] << FRAC_BITS;
+						uint32_t p11 = p_src[y_ofs_down + src_xofs_right + l] << FRAC_BITS;
+
+						uint32_t interp_up = p00 + (((p10 - p00) * src_xofs_frac) >> FRAC_BITS);
+						uint32_t interp_down = p01 + (((p11 - p01) * src_xofs_frac) >> FRAC_BITS);
+						uint32_t interp = interp_up + (((interp_down - interp_up) * src_yofs_frac) >> FRAC_BITS);
+						interp >>= FRAC_BITS;
+						p_dst[i * p_dst_width * CC + j * CC + l] = uint8_t(interp);
+					} else if constexpr (sizeof(T) == 2) { //half float
 
-					float xofs_frac = float(src_xofs_frac) / (1 << FRAC_BITS);
-					float yofs_frac = float(src_yofs_frac) / (1 << FRAC_BITS);
-					const T *src = ((const T *)p_src);
-					T *dst = ((T *)p_dst);
+						float xofs_frac = float(src_xofs_frac) / (1 << FRAC_BITS);
+						float yofs_frac = float(src_yofs_frac) / (1 << FRAC_BITS);
+						const T *src = ((const T *)p_src);
+						T *dst = ((T *)p_dst);
 
-					float p00 = Math::half_to_float(src[y_ofs_up + src_xofs_left + l]);
-					float p10 = Math::half_to_float(src[y_ofs_up + src_xofs_right + l]);
-					float p01 = Math::half_to_float(src[y_ofs_down + src_xofs_left + l]);
-					float p11 = Math::half_to_float(src[y_ofs_down + src_xofs_right + l]);
+						float p00 = Math::half_to_float(src[y_ofs_up + src_xofs_left + l]);
+						float p10 = Math::half_to_float(src[y_ofs_up + src_xofs_right + l]);
+						float p01 = Math::half_to_float(src[y_ofs_down + src_xofs_left + l]);
+						float p11 = Math::half_to_float(src[y_ofs_down + src_xofs_right + l]);
 
-					float interp_up = p00 + (p10 - p00) * xofs_frac;
-					float interp_down = p01 + (p11 - p01) * xofs_frac;
-					float interp = interp_up + ((interp_down - interp_up) * yofs_frac);
+						float interp_up = p00 + (p10 - p00) * xofs_frac;
+						float interp_down = p01 + (p11 - p01) * xofs_frac;
+						float interp = interp_up + ((interp_down - interp_up) * yofs_frac);
 
-					dst[i * p_dst_width * CC + j * CC + l] = Math::make_half_float(interp);
-				} else if constexpr (sizeof(T) == 4) { //float
+						dst[i * p_dst_width * CC + j * CC + l] = Math::make_half_float(interp);
+					} else if constexpr (sizeof(T) == 4) { //float
 
-					float xofs_frac = float(src_xofs_frac) / (1 << FRAC_BITS);
-					float yofs_frac = float(src_yofs_frac) / (1 << FRAC_BITS);
-					const T *src = ((const T *)p_src);
-					T *dst = ((T *)p_dst);
+						float xofs_frac = float(src_xofs_frac) / (1 << FRAC_BITS);
+						float yofs_frac = float(src_yofs_frac) / (1 << FRAC_BITS);
+						const T *src = ((const T *)p_src);
+						T *dst = ((T *)p_dst);
 
-					float p00 = src[y_ofs_up + src_xofs_left + l];
-					float p10 = src[y_ofs_up + src_xofs_right + l];
-					float p01 = src[y_ofs_down + src_xofs_left + l];
-					float p11 = src[y_ofs_down + src_xofs_right + l];
+						float p00 = src[y_ofs_up + src_xofs_left + l];
+						float p10 = src[y_ofs_up + src_xofs_right + l];
+						float p01 = src[y_ofs_down + src_xofs_left + l];
+						float p11 = src[y_ofs_down + src_xofs_right + l];
 
-					float interp_up = p00 + (p10 - p00) * xofs_frac;
-					float interp_down = p01 + (p11 - p01) * xofs_frac;
-					float interp = interp_up + ((interp_down - interp_up) * yofs_frac);
+						float interp_up = p00 + (p10 - p00) * xofs_frac;
+						float interp_down = p01 + (p11 - p01) * xofs_frac;
+						float interp = interp_up + ((interp_down - interp_up) * yofs_frac);
 
-					dst[i * p_dst_width * CC + j * CC + l] = interp;
+						dst[i * p_dst_width * CC + j * CC + l] = interp;
+					}
 				}
 			}
 		}
-	}
+	});
 }
 
 template <int CC, typename T>
 static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	for (uint32_t i = 0; i < p_dst_height; i++) {
-		uint32_t src_yofs = i * p_src_height / p_dst_height;
-		uint32_t y_ofs = src_yofs * p_src_width * CC;
+	LocalVector<uint32_t> x_offsets;
+	x_offsets.resize(p_dst_width);
+	for (uint32_t j = 0; j < p_dst_width; j++) {
+		x_offsets[j] = j * p_src_width / p_dst_width * CC;
+	}
 
-		for (uint32_t j = 0; j < p_dst_width; j++) {
-			uint32_t src_xofs = j * p_src_width / p_dst_width;
-			src_xofs *= CC;
+	_for_each_row_block(p_dst_width, p_dst_height, [&](int p_from, int p_to) {
+		const T *src = ((const T *)p_src);
+		T *dst = ((T *)p_dst);
 
-			for (uint32_t l = 0; l < CC; l++) {
-				const T *src = ((const T *)p_src);
-				T *dst = ((T *)p_dst);
+		for (uint32_t i = p_from; i < (uint32_t)p_to; i++) {
+			uint32_t src_yofs = i * p_src_height / p_dst_height;
+			uint32_t y_ofs = src_yofs * p_src_width * CC;
 
-				T p = src[y_ofs + src_xofs + l];
-				dst[i * p_dst_width * CC + j * CC + l] = p;
+			for (uint32_t j = 0; j < p_dst_width; j++) {
+				for (uint32_t l = 0; l < CC; l++) {
+					dst[i * p_dst_width * CC + j * CC + l] = src[y_ofs + x_offsets[j] + l];
+				}
 			}
 		}
-	}
+	});
 }
 
 #define LANCZOS_TYPE 3
@@ -1011,6 +1252,47 @@ static float _lanczos(float p_x) {
 	return Math::abs(p_x) >= LANCZOS_TYPE ? 0 : Math::sincn(p_x) * Math::sincn(p_x / LANCZOS_TYPE);
 }
 
+// Lanczos weights along one axis. Every destination pixel sums a run of source pixels, and the
+// runs and weights only depend on the position along the axis, so they are computed once per pass.
+struct LanczosWeights {
+	int32_t kernel_size = 0; // Stride of `weights`.
+	LocalVector<int32_t> start;
+	LocalVector<int32_t> count;
+	LocalVector<float> weights;
+	LocalVector<float> weight_sums;
+
+	LanczosWeights(int32_t p_src_size, int32_t p_dst_size) {
+		float scale = float(p_src_size) / float(p_dst_size);
+
+		float scale_factor = MAX(scale, 1); // A larger kernel is required only when downscaling
+		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
+
+		kernel_size = half_kernel * 2;
+		start.resize(p_dst_size);
+		count.resize(p_dst_size);
+		weights.resize(p_dst_size * kernel_size);
+		weight_sums.resize(p_dst_size);
+
+		for (int32_t dst = 0; dst < p_dst_size; dst++) {
+			// The corresponding point on the source image
+			float src_pos = (dst + 0.5f) * scale; // Offset by 0.5 so it uses the pixel's center
+			int32_t start_pos = MAX(0, int32_t(src_pos) - half_kernel + 1);
+			int32_t end_pos = MIN(p_src_size - 1, int32_t(src_pos) + half_kernel);
+
+			float weight = 0;
+			for (int32_t target = start_pos; target <= end_pos; target++) {
+				float lanczos_val = _lanczos((target + 0.5f - src_pos) / scale_factor);
+				weights[dst * kernel_size + target - start_pos] = lanczos_val;
+				weight += lanczos_val;
+			}
+
+			start[dst] = start_pos;
+			count[dst] = end_pos - start_pos + 1;
+			weight_sums[dst] = weight;
+		}
+	}
+};
+
 template <int CC, typename T>
 static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
 	int32_t src_width = p_src_width;
@@ -1021,106 +1303,74 @@ static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict
 	uint32_t buffer_size = src_height * dst_width * CC;
 	float *buffer = memnew_arr(float, buffer_size); // Store the first pass in a buffer
 
-	{ // FIRST PASS (horizontal)
-
-		float x_scale = float(src_width) / float(dst_width);
-
-		float scale_factor = MAX(x_scale, 1); // A larger kernel is required only when downscaling
-		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
-
-		float *kernel = memnew_arr(float, half_kernel * 2);
-
-		for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
-			// The corresponding point on the source image
-			float src_x = (buffer_x + 0.5f) * x_scale; // Offset by 0.5 so it uses the pixel's center
-			int32_t start_x = MAX(0, int32_t(src_x) - half_kernel + 1);
-			int32_t end_x = MIN(src_width - 1, int32_t(src_x) + half_kernel);
-
-			// Create the kernel used by all the pixels of the column
-			for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-				kernel[target_x - start_x] = _lanczos((target_x + 0.5f - src_x) / scale_factor);
-			}
-
-			for (int32_t buffer_y = 0; buffer_y < src_height; buffer_y++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+	{ // FIRST PASS (horizontal), row by row so the source is read sequentially
+		const LanczosWeights x_weights(src_width, dst_width);
 
-				for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-					float lanczos_val = kernel[target_x - start_x];
-					weight += lanczos_val;
+		_for_each_row_block(dst_width, src_height, [&](int p_from, int p_to) {
+			for (int32_t buffer_y = p_from; buffer_y < p_to; buffer_y++) {
+				const T *__restrict src_row = ((const T *)p_src) + buffer_y * src_width * CC;
 
-					const T *__restrict src_data = ((const T *)p_src) + (buffer_y * src_width + target_x) * CC;
+				for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
+					const float *kernel = &x_weights.weights[buffer_x * x_weights.kernel_size];
+					const T *__restrict src_data = src_row + x_weights.start[buffer_x] * CC;
+					float pixel[CC] = { 0 };
 
-					for (uint32_t i = 0; i < CC; i++) {
-						if constexpr (sizeof(T) == 2) { //half float
-							pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
-						} else {
-							pixel[i] += src_data[i] * lanczos_val;
+					for (int32_t k = 0; k < x_weights.count[buffer_x]; k++) {
+						for (uint32_t i = 0; i < CC; i++) {
+							if constexpr (sizeof(T) == 2) { //half float
+								pixel[i] += Math::half_to_float(src_data[k * CC + i]) * kernel[k];
+							} else {
+								pixel[i] += src_data[k * CC + i] * kernel[k];
+							}
 						}
 					}
-				}
 
-				float *dst_data = ((float *)buffer) + (buffer_y * dst_width + buffer_x) * CC;
+					float *dst_data = ((float *)buffer) + (buffer_y * dst_width + buffer_x) * CC;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
+					for (uint32_t i = 0; i < CC; i++) {
+						dst_data[i] = pixel[i] / x_weights.weight_sums[buffer_x]; // Normalize the sum of all the samples
+					}
 				}
 			}
-		}
-
-		memdelete_arr(kernel);
+		});
 	} // End of first pass
 
 	{ // SECOND PASS (vertical + result)
+		const LanczosWeights y_weights(src_height, dst_height);
 
-		float y_scale = float(src_height) / float(dst_height);
-
-		float scale_factor = MAX(y_scale, 1);
-		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
-
-		float *kernel = memnew_arr(float, half_kernel * 2);
-
-		for (int32_t dst_y = 0; dst_y < dst_height; dst_y++) {
-			float buffer_y = (dst_y + 0.5f) * y_scale;
-			int32_t start_y = MAX(0, int32_t(buffer_y) - half_kernel + 1);
-			int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + half_kernel);
+		_for_each_row_block(dst_width, dst_height, [&](int p_from, int p_to) {
+			for (int32_t dst_y = p_from; dst_y < p_to; dst_y++) {
+				const float *kernel = &y_weights.weights[dst_y * y_weights.kernel_size];
+				const int32_t start_y = y_weights.start[dst_y];
+				const float weight = y_weights.weight_sums[dst_y];
 
-			for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-				kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / scale_factor);
-			}
-
-			for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+				for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
+					float pixel[CC] = { 0 };
 
-				for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-					float lanczos_val = kernel[target_y - start_y];
-					weight += lanczos_val;
+					for (int32_t k = 0; k < y_weights.count[dst_y]; k++) {
+						float *buffer_data = ((float *)buffer) + ((start_y + k) * dst_width + dst_x) * CC;
 
-					float *buffer_data = ((float *)buffer) + (target_y * dst_width + dst_x) * CC;
-
-					for (uint32_t i = 0; i < CC; i++) {
-						pixel[i] += buffer_data[i] * lanczos_val;
+						for (uint32_t i = 0; i < CC; i++) {
+							pixel[i] += buffer_data[i] * kernel[k];
+						}
 					}
-				}
-
-				T *dst_data = ((T *)p_dst) + (dst_y * dst_width + dst_x) * CC;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					pixel[i] /= weight;
+					T *dst_data = ((T *)p_dst) + (dst_y * dst_width + dst_x) * CC;
 
-					if constexpr (sizeof(T) == 1) { //byte
-						dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
-					} else if constexpr (sizeof(T) == 2) { //half float
-						dst_data[i] = Math::make_half_float(pixel[i]);
-					} else { // float
-						dst_data[i] = pixel[i];
+					for (uint32_t i = 0; i < CC; i++) {
+						pixel[i] /= weight;
+
+						if constexpr (sizeof(T) == 1) { //byte
+							dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
+						} else if constexpr (sizeof(T) == 2) { //half float
+							dst_data[i] = Math::make_half_float(pixel[i]);
+						} else { // float
+							dst_data[i] = pixel[i];
+						}
 					}
 				}
 			}
-		}
-
-		memdelete_arr(kernel);
+		});
 	} // End of second pass
 
 	memdelete_arr(buffer);
@@ -1804,27 +2054,31 @@ static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint3
 	int right_step = (p_width == 1) ? 0 : CC;
 	int down_step = (p_height == 1) ? 0 : (p_width * CC);
 
-	for (uint32_t i = 0; i < dst_h; i++) {
-		const Component *rup_ptr = &p_src[i * 2 * down_step];
-		const Component *rdown_ptr = rup_ptr + down_step;
-		Component *dst_ptr = &p_dst[i * dst_w * CC];
-		uint32_t count = dst_w;
+	// Every level still depends on the previous one, but the rows of a level are independent.
+	// Levels below the row-block threshold (all the small ones) are generated inline.
+	_for_each_row_block(dst_w, dst_h, [&](int p_from, int p_to) {
+		for (uint32_t i = p_from; i < (uint32_t)p_to; i++) {
+			const Component *rup_ptr = &p_src[i * 2 * down_step];
+			const Component *rdown_ptr = rup_ptr + down_step;
+			Component *dst_ptr = &p_dst[i * dst_w * CC];
+			uint32_t count = dst_w;
+
+			while (count) {
+				count--;
+				for (int j = 0; j < CC; j++) {
+					average_func(dst_ptr[j], rup_ptr[j], rup_ptr[j + right_step], rdown_ptr[j], rdown_ptr[j + right_step]);
+				}
 
-		while (count) {
-			count--;
-			for (int j = 0; j < CC; j++) {
-				average_func(dst_ptr[j], rup_ptr[j], rup_ptr[j + right_step], rdown_ptr[j], rdown_ptr[j + right_step]);
-			}
+				if (renormalize) {
+					renormalize_func(dst_ptr);
+				}
 
-			if (renormalize) {
-				renormalize_func(dst_ptr);
+				dst_ptr += CC;
+				rup_ptr += right_step * 2;
+				rdown_ptr += right_step * 2;
 			}
-
-			dst_ptr += CC;
-			rup_ptr += right_step * 2;
-			rdown_ptr += right_step * 2;
 		}
-	}
+	});
 }
 
 void Image::_generate_mipmap_from_format(Image::Format p_format, const uint8_t *p_src, uint8_t *p_dst, uint32_t p_width, uint32_t p_height, bool p_renormalize) {
@@ -2547,13 +2801,18 @@ Error Image::load(const String &p_path) {
 	return ImageLoader::load_image(path, this);
 }
 
-Ref<Image> Image::load_from_file(const String &p_path) {
+static String _get_image_file_path(const String &p_path) {
 	String path = ResourceUID::ensure_path(p_path);
 #ifdef DEBUG_ENABLED
 	if (path.begins_with("res://") && ResourceLoader::exists(path)) {
 		WARN_PRINT(vformat("Loaded resource as image file, this will not work on export: '%s'. Instead, import the image file as an Image resource and load it normally as a resource.", path));
 	}
 #endif
+	return path;
+}
+
+Ref<Image> Image::load_from_file(const String &p_path) {
+	String path = _get_image_file_path(p_path);
 	Ref<Image> image;
 	image.instantiate();
 	Error err = ImageLoader::load_image(path, image);
@@ -2563,6 +2822,32 @@ Ref<Image> Image::load_from_file(const String &p_path) {
 	return image;
 }
 
+TypedArray<Image> Image::load_from_files(const PackedStringArray &p_paths, Format p_format, bool p_generate_mipmaps) {
+	PackedStringArray paths;
+	paths.resize(p_paths.size());
+	for (int i = 0; i < p_paths.size(); i++) {
+		paths.write[i] = _get_image_file_path(p_paths[i]);
+	}
+
+	const Vector<Ref<Image>> images = ImageLoader::load_images(paths, p_format, p_generate_mipmaps);
+	TypedArray<Image> result;
+	result.resize(images.size());
+	for (int i = 0; i < images.size(); i++) {
+		result[i] = images[i];
+	}
+	return result;
+}
+
+void Image::load_from_files_async(const PackedStringArray &p_paths, const Callable &p_on_loaded, Format p_format, bool p_generate_mipmaps) {
+	PackedStringArray paths;
+	paths.resize(p_paths.size());
+	for (int i = 0; i < p_paths.size(); i++) {
+		paths.write[i] = _get_image_file_path(p_paths[i]);
+	}
+
+	ImageLoader::load_images_async(paths, p_on_loaded, p_format, p_generate_mipmaps);
+}
+
 Error Image::save_png(const String &p_path) const {
 	if (save_png_func == nullptr) {
 		return ERR_UNAVAILABLE;
@@ -2863,6 +3148,71 @@ void Image::_get_clipped_src_and_dest_rects(const Ref<Image> &p_src, const Rect2
 	r_clipped_dest_rect.size.y = r_clipped_src_rect.size.y;
 }
 
+// Fills r_visible with whether each mask pixel in a row has a non-zero alpha, as `get_pixel().a != 0` would.
+static void _get_mask_row(const Image *p_mask, int p_x, int p_y, int p_count, uint8_t *r_visible) {
+	const int64_t ofs = (int64_t)p_y * p_mask->get_width() + p_x;
+
+	switch (p_mask->get_format()) {
+		case Image::FORMAT_LA8: {
+			const uint8_t *mask = p_mask->ptr() + ofs * 2;
+			for (int x = 0; x < p_count; x++) {
+				r_visible[x] = mask[x * 2 + 1] != 0;
+			}
+		} break;
+		case Image::FORMAT_RGBA8: {
+			const uint8_t *mask = p_mask->ptr() + ofs * 4;
+			for (int x = 0; x < p_count; x++) {
+				r_visible[x] = mask[x * 4 + 3] != 0;
+			}
+		} break;
+		case Image::FORMAT_L8:
+		case Image::FORMAT_R8:
+		case Image::FORMAT_RG8:
+		case Image::FORMAT_RGB8:
+		case Image::FORMAT_RGB565:
+		case Image::FORMAT_RF:
+		case Image::FORMAT_RGF:
+		case Image::FORMAT_RGBF:
+		case Image::FORMAT_RH:
+		case Image::FORMAT_RGH:
+		case Image::FORMAT_RGBH:
+		case Image::FORMAT_RGBE9995: {
+			// No alpha channel, every pixel is opaque.
+			memset(r_visible, 1, p_count);
+		} break;
+		default: {
+			for (int x = 0; x < p_count; x++) {
+				r_visible[x] = p_mask->get_pixel(p_x + x, p_y).a != 0;
+			}
+		}
+	}
+}
+
+// Blends a row of RGBA8 pixels over another, skipping pixels whose p_visible entry is 0 (if given).
+// The math is the same as get_pixel(), Color::blend() and set_pixel(), but opaque and fully
+// transparent source pixels, which make up most of typical UI and decal art, skip the float path.
+static void _blend_row_rgba8(const uint8_t *__restrict p_src, const uint8_t *__restrict p_visible, uint8_t *__restrict p_dst, int p_count) {
+	for (int x = 0; x < p_count; x++) {
+		const uint8_t *src = p_src + x * 4;
+		uint8_t *dst = p_dst + x * 4;
+
+		if (src[3] == 0 || (p_visible && !p_visible[x])) {
+			continue;
+		}
+		if (src[3] == 255) {
+			memcpy(dst, src, 4);
+			continue;
+		}
+
+		const Color sc = Color(src[0] / 255.0, src[1] / 255.0, src[2] / 255.0, src[3] / 255.0);
+		const Color dc = Color(dst[0] / 255.0, dst[1] / 255.0, dst[2] / 255.0, dst[3] / 255.0).blend(sc);
+		dst[0] = uint8_t(CLAMP(dc.r * 255.0, 0, 255));
+		dst[1] = uint8_t(CLAMP(dc.g * 255.0, 0, 255));
+		dst[2] = uint8_t(CLAMP(dc.b * 255.0, 0, 255));
+		dst[3] = uint8_t(CLAMP(dc.a * 255.0, 0, 255));
+	}
+}
+
 void Image::blit_rect(const Ref<Image> &p_src, const Rect2i &p_src_rect, const Point2i &p_dest) {
 	ERR_FAIL_COND_MSG(p_src.is_null(), "Cannot blit_rect an image: invalid source Image object.");
 	int dsize = data.size();
@@ -2879,30 +3229,23 @@ void Image::blit_rect(const Ref<Image> &p_src, const Rect2i &p_src_rect, const P
 		return;
 	}
 
-	uint8_t *wp = data.ptrw();
-	uint8_t *dst_data_ptr = wp;
-
-	const uint8_t *rp = p_src->data.ptr();
-	const uint8_t *src_data_ptr = rp;
-
-	int pixel_size = get_format_pixel_size(format);
-
-	for (int i = 0; i < dest_rect.size.y; i++) {
-		for (int j = 0; j < dest_rect.size.x; j++) {
-			int src_x = src_rect.position.x + j;
-			int src_y = src_rect.position.y + i;
-
-			int dst_x = dest_rect.position.x + j;
-			int dst_y = dest_rect.position.y + i;
+	// Holding the source data makes ptrw() copy it when blitting an image onto itself,
+	// so rows are always read from the unmodified source.
+	const Vector<uint8_t> src_data = p_src->data;
+	const uint8_t *src_data_ptr = src_data.ptr();
+	uint8_t *dst_data_ptr = data.ptrw();
 
-			const uint8_t *src = &src_data_ptr[(src_y * p_src->width + src_x) * pixel_size];
-			uint8_t *dst = &dst_data_ptr[(dst_y * width + dst_x) * pixel_size];
+	const int pixel_size = get_format_pixel_size(format);
+	const int src_width = p_src->width;
+	const int64_t row_size = (int64_t)dest_rect.size.x * pixel_size;
 
-			for (int k = 0; k < pixel_size; k++) {
-				dst[k] = src[k];
-			}
+	_for_each_row_block(dest_rect.size.x, dest_rect.size.y, [&](int p_from, int p_to) {
+		for (int i = p_from; i < p_to; i++) {
+			const uint8_t *src = &src_data_ptr[((int64_t)(src_rect.position.y + i) * src_width + src_rect.position.x) * pixel_size];
+			uint8_t *dst = &dst_data_ptr[((int64_t)(dest_rect.position.y + i) * width + dest_rect.position.x) * pixel_size];
+			memcpy(dst, src, row_size);
 		}
-	}
+	});
 }
 
 void Image::blit_rect_mask(const Ref<Image> &p_src, const Ref<Image> &p_mask, const Rect2i &p_src_rect, const Point2i &p_dest) {
@@ -2925,34 +3268,36 @@ void Image::blit_rect_mask(const Ref<Image> &p_src, const Ref<Image> &p_mask, co
 		return;
 	}
 
-	uint8_t *wp = data.ptrw();
-	uint8_t *dst_data_ptr = wp;
-
-	const uint8_t *rp = p_src->data.ptr();
-	const uint8_t *src_data_ptr = rp;
+	// Rows may be written in parallel, so never read the mask from the image being written.
+	Ref<Image> msk = p_mask;
+	if (msk.ptr() == this) {
+		msk = duplicate();
+	}
 
-	int pixel_size = get_format_pixel_size(format);
+	const Vector<uint8_t> src_data = p_src->data;
+	const uint8_t *src_data_ptr = src_data.ptr();
+	uint8_t *dst_data_ptr = data.ptrw();
 
-	Ref<Image> msk = p_mask;
+	const int pixel_size = get_format_pixel_size(format);
+	const int src_width = p_src->width;
 
-	for (int i = 0; i < dest_rect.size.y; i++) {
-		for (int j = 0; j < dest_rect.size.x; j++) {
-			int src_x = src_rect.position.x + j;
-			int src_y = src_rect.position.y + i;
+	_for_each_row_block(dest_rect.size.x, dest_rect.size.y, [&](int p_from, int p_to) {
+		LocalVector<uint8_t> visible;
+		visible.resize(dest_rect.size.x);
 
-			if (msk->get_pixel(src_x, src_y).a != 0) {
-				int dst_x = dest_rect.position.x + j;
-				int dst_y = dest_rect.position.y + i;
+		for (int i = p_from; i < p_to; i++) {
+			_get_mask_row(msk.ptr(), src_rect.position.x, src_rect.position.y + i, dest_rect.size.x, visible.ptr());
 
-				const uint8_t *src = &src_data_ptr[(src_y * p_src->width + src_x) * pixel_size];
-				uint8_t *dst = &dst_data_ptr[(dst_y * width + dst_x) * pixel_size];
+			const uint8_t *src = &src_data_ptr[((int64_t)(src_rect.position.y + i) * src_width + src_rect.position.x) * pixel_size];
+			uint8_t *dst = &dst_data_ptr[((int64_t)(dest_rect.position.y + i) * width + dest_rect.position.x) * pixel_size];
 
-				for (int k = 0; k < pixel_size; k++) {
-					dst[k] = src[k];
+			for (int j = 0; j < dest_rect.size.x; j++) {
+				if (visible[j]) {
+					memcpy(dst + j * pixel_size, src + j * pixel_size, pixel_size);
 				}
 			}
 		}
-	}
+	});
 }
 
 void Image::blend_rect(const Ref<Image> &p_src, const Rect2i &p_src_rect, const Point2i &p_dest) {
@@ -2970,6 +3315,22 @@ void Image::blend_rect(const Ref<Image> &p_src, const Rect2i &p_src_rect, const
 		return;
 	}
 
+	if (format == FORMAT_RGBA8) {
+		const Vector<uint8_t> src_data = p_src->data;
+		const uint8_t *src_data_ptr = src_data.ptr();
+		uint8_t *dst_data_ptr = data.ptrw();
+		const int src_width = p_src->width;
+
+		_for_each_row_block(dest_rect.size.x, dest_rect.size.y, [&](int p_from, int p_to) {
+			for (int i = p_from; i < p_to; i++) {
+				const uint8_t *src = &src_data_ptr[((int64_t)(src_rect.position.y + i) * src_width + src_rect.position.x) * 4];
+				uint8_t *dst = &dst_data_ptr[((int64_t)(dest_rect.position.y + i) * width + dest_rect.position.x) * 4];
+				_blend_row_rgba8(src, nullptr, dst, dest_rect.size.x);
+			}
+		});
+		return;
+	}
+
 	Ref<Image> img = p_src;
 
 	for (int i = 0; i < dest_rect.size.y; i++) {
@@ -3013,6 +3374,32 @@ void Image::blend_rect_mask(const Ref<Image> &p_src, const Ref<Image> &p_mask, c
 	Ref<Image> img = p_src;
 	Ref<Image> msk = p_mask;
 
+	if (format == FORMAT_RGBA8) {
+		// Rows may be written in parallel, so never read the mask from the image being written.
+		if (msk.ptr() == this) {
+			msk = duplicate();
+		}
+
+		const Vector<uint8_t> src_data = p_src->data;
+		const uint8_t *src_data_ptr = src_data.ptr();
+		uint8_t *dst_data_ptr = data.ptrw();
+		const int src_width = p_src->width;
+
+		_for_each_row_block(dest_rect.size.x, dest_rect.size.y, [&](int p_from, int p_to) {
+			LocalVector<uint8_t> visible;
+			visible.resize(dest_rect.size.x);
+
+			for (int i = p_from; i < p_to; i++) {
+				_get_mask_row(msk.ptr(), src_rect.position.x, src_rect.position.y + i, dest_rect.size.x, visible.ptr());
+
+				const uint8_t *src = &src_data_ptr[((int64_t)(src_rect.position.y + i) * src_width + src_rect.position.x) * 4];
+				uint8_t *dst = &dst_data_ptr[((int64_t)(dest_rect.position.y + i) * width + dest_rect.position.x) * 4];
+				_blend_row_rgba8(src, visible.ptr(), dst, dest_rect.size.x);
+			}
+		});
+		return;
+	}
+
 	for (int i = 0; i < dest_rect.size.y; i++) {
 		for (int j = 0; j < dest_rect.size.x; j++) {
 			int src_x = src_rect.position.x + j;
@@ -3360,6 +3747,125 @@ void Image::set_pixel(int p_x, int p_y, const Color &p_color) {
 	_set_color_at_ofs(data.ptrw(), ofs, p_color);
 }
 
+// Color is four packed floats, the layout the row converters of convert() read and write.
+static_assert(sizeof(Color) == sizeof(float) * 4);
+
+Vector<Color> Image::get_pixels_rect(const Rect2i &p_rect) const {
+	ERR_FAIL_COND_V_MSG(!_can_modify(format), Vector<Color>(), "Cannot get pixels of compressed or custom image formats.");
+	ERR_FAIL_COND_V_MSG(p_rect.size.x <= 0 || p_rect.size.y <= 0 || !Rect2i(0, 0, width, height).encloses(p_rect), Vector<Color>(), vformat("The rect %s must be inside the image (%dx%d).", p_rect, width, height));
+
+	Vector<Color> colors;
+	colors.resize(p_rect.size.x * p_rect.size.y);
+	Color *dst = colors.ptrw();
+	const uint8_t *src = data.ptr();
+	const int pixel_size = get_format_pixel_size(format);
+	const ImageRowDecodeFunc decode_func = _get_row_decode_func(format);
+
+	for (int y = 0; y < p_rect.size.y; y++) {
+		const int64_t ofs = (int64_t)(p_rect.position.y + y) * width + p_rect.position.x;
+		Color *dst_row = dst + (int64_t)y * p_rect.size.x;
+
+		if (decode_func) {
+			decode_func(src + ofs * pixel_size, (float *)dst_row, p_rect.size.x);
+		} else {
+			for (int x = 0; x < p_rect.size.x; x++) {
+				dst_row[x] = _get_color_at_ofs(src, ofs + x);
+			}
+		}
+	}
+
+	return colors;
+}
+
+void Image::set_pixels_rect(const Rect2i &p_rect, const Vector<Color> &p_colors) {
+	ERR_FAIL_COND_MSG(!_can_modify(format), "Cannot set pixels of compressed or custom image formats.");
+	ERR_FAIL_COND_MSG(p_rect.size.x <= 0 || p_rect.size.y <= 0 || !Rect2i(0, 0, width, height).encloses(p_rect), vformat("The rect %s must be inside the image (%dx%d).", p_rect, width, height));
+	ERR_FAIL_COND_MSG(p_colors.size() != p_rect.size.x * p_rect.size.y, vformat("Expected %d colors for the rect, got %d.", p_rect.size.x * p_rect.size.y, p_colors.size()));
+
+	const Color *src = p_colors.ptr();
+	uint8_t *dst = data.ptrw();
+	const int pixel_size = get_format_pixel_size(format);
+	const ImageRowEncodeFunc encode_func = _get_row_encode_func(format);
+
+	for (int y = 0; y < p_rect.size.y; y++) {
+		const int64_t ofs = (int64_t)(p_rect.position.y + y) * width + p_rect.position.x;
+		const Color *src_row = src + (int64_t)y * p_rect.size.x;
+
+		if (encode_func) {
+			encode_func((const float *)src_row, dst + ofs * pixel_size, p_rect.size.x);
+		} else {
+			for (int x = 0; x < p_rect.size.x; x++) {
+				_set_color_at_ofs(dst, ofs + x, src_row[x]);
+			}
+		}
+	}
+}
+
+Vector<uint8_t> Image::get_data_rect(const Rect2i &p_rect) const {
+	ERR_FAIL_COND_V_MSG(!_can_modify(format), Vector<uint8_t>(), "Cannot get pixels of compressed or custom image formats.");
+	ERR_FAIL_COND_V_MSG(p_rect.size.x <= 0 || p_rect.size.y <= 0 || !Rect2i(0, 0, width, height).encloses(p_rect), Vector<uint8_t>(), vformat("The rect %s must be inside the image (%dx%d).", p_rect, width, height));
+
+	const int pixel_size = get_format_pixel_size(format);
+	const int64_t row_size = (int64_t)p_rect.size.x * pixel_size;
+
+	Vector<uint8_t> rect_data;
+	rect_data.resize(row_size * p_rect.size.y);
+	uint8_t *dst = rect_data.ptrw();
+	const uint8_t *src = data.ptr();
+
+	for (int y = 0; y < p_rect.size.y; y++) {
+		const int64_t ofs = (int64_t)(p_rect.position.y + y) * width + p_rect.position.x;
+		memcpy(dst + y * row_size, src + ofs * pixel_size, row_size);
+	}
+
+	return rect_data;
+}
+
+void Image::set_data_rect(const Rect2i &p_rect, const Vector<uint8_t> &p_data) {
+	ERR_FAIL_COND_MSG(!_can_modify(format), "Cannot set pixels of compressed or custom image formats.");
+	ERR_FAIL_COND_MSG(p_rect.size.x <= 0 || p_rect.size.y <= 0 || !Rect2i(0, 0, width, height).encloses(p_rect), vformat("The rect %s must be inside the image (%dx%d).", p_rect, width, height));
+
+	const int pixel_size = get_format_pixel_size(format);
+	const int64_t row_size = (int64_t)p_rect.size.x * pixel_size;
+	ERR_FAIL_COND_MSG(p_data.size() != row_size * p_rect.size.y, vformat("Expected %d bytes for the rect, got %d.", row_size * p_rect.size.y, p_data.size()));
+
+	const uint8_t *src = p_data.ptr();
+	uint8_t *dst = data.ptrw();
+
+	for (int y = 0; y < p_rect.size.y; y++) {
+		const int64_t ofs = (int64_t)(p_rect.position.y + y) * width + p_rect.position.x;
+		memcpy(dst + ofs * pixel_size, src + y * row_size, row_size);
+	}
+}
+
+Image::PixelSpan<const uint8_t> Image::get_pixel_span(int p_mipmap) const {
+	ERR_FAIL_COND_V_MSG(!_can_modify(format), PixelSpan<const uint8_t>(), "Cannot access pixels of compressed or custom image formats.");
+	ERR_FAIL_COND_V(data.is_empty(), PixelSpan<const uint8_t>());
+	ERR_FAIL_INDEX_V(p_mipmap, get_mipmap_count() + 1, PixelSpan<const uint8_t>());
+
+	int64_t ofs;
+	PixelSpan<const uint8_t> span;
+	_get_mipmap_offset_and_size(p_mipmap, ofs, span.width, span.height);
+	span.pixel_size = get_format_pixel_size(format);
+	span.stride = (int64_t)span.width * span.pixel_size;
+	span.data = data.ptr() + ofs;
+	return span;
+}
+
+Image::PixelSpan<uint8_t> Image::get_pixel_span_w(int p_mipmap) {
+	ERR_FAIL_COND_V_MSG(!_can_modify(format), PixelSpan<uint8_t>(), "Cannot access pixels of compressed or custom image formats.");
+	ERR_FAIL_COND_V(data.is_empty(), PixelSpan<uint8_t>());
+	ERR_FAIL_INDEX_V(p_mipmap, get_mipmap_count() + 1, PixelSpan<uint8_t>());
+
+	int64_t ofs;
+	PixelSpan<uint8_t> span;
+	_get_mipmap_offset_and_size(p_mipmap, ofs, span.width, span.height);
+	span.pixel_size = get_format_pixel_size(format);
+	span.stride = (int64_t)span.width * span.pixel_size;
+	span.data = data.ptrw() + ofs;
+	return span;
+}
+
 const uint8_t *Image::ptr() const {
 	return data.ptr();
 }
@@ -3525,6 +4031,8 @@ void Image::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("load", "path"), &Image::load);
 	ClassDB::bind_static_method("Image", D_METHOD("load_from_file", "path"), &Image::load_from_file);
+	ClassDB::bind_static_method("Image", D_METHOD("load_from_files", "paths", "format", "generate_mipmaps"), &Image::load_from_files, DEFVAL(FORMAT_MAX), DEFVAL(false));
+	ClassDB::bind_static_method("Image", D_METHOD("load_from_files_async", "paths", "on_loaded", "format", "generate_mipmaps"), &Image::load_from_files_async, DEFVAL(FORMAT_MAX), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("save_png", "path"), &Image::save_png);
 	ClassDB::bind_method(D_METHOD("save_png_to_buffer"), &Image::save_png_to_buffer);
 	ClassDB::bind_method(D_METHOD("save_jpg", "path", "quality"), &Image::save_jpg, DEFVAL(0.75));
@@ -3575,6 +4083,10 @@ void Image::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_pixel", "x", "y"), &Image::get_pixel);
 	ClassDB::bind_method(D_METHOD("set_pixelv", "point", "color"), &Image::set_pixelv);
 	ClassDB::bind_method(D_METHOD("set_pixel", "x", "y", "color"), &Image::set_pixel);
+	ClassDB::bind_method(D_METHOD("get_pixels_rect", "rect"), &Image::get_pixels_rect);
+	ClassDB::bind_method(D_METHOD("set_pixels_rect", "rect", "colors"), &Image::set_pixels_rect);
+	ClassDB::bind_method(D_METHOD("get_data_rect", "rect"), &Image::get_data_rect);
+	ClassDB::bind_method(D_METHOD("set_data_rect", "rect", "data"), &Image::set_data_rect);
 
 	ClassDB::bind_method(D_METHOD("adjust_bcs", "brightness", "contrast", "saturation"), &Image::adjust_bcs);
 
@@ -3805,6 +4317,24 @@ bool Image::detect_signed(bool p_include_mips) const {
 	return false;
 }
 
+// Maps the color channels (not alpha) of every pixel through p_table, including mipmaps.
+template <uint32_t channels>
+static void _remap_rgb(uint8_t *p_data, int64_t p_pixels, const uint8_t *p_table) {
+	// Mipmaps are laid out back to back, so split the data into fixed-size runs of pixels instead of rows.
+	constexpr int run = 4096;
+	const int runs = (p_pixels + run - 1) / run;
+
+	_for_each_row_block(run, runs, [&](int p_from, int p_to) {
+		uint8_t *__restrict ptr = p_data + (int64_t)p_from * run * channels;
+		const int64_t count = MIN((int64_t)p_to * run, p_pixels) - (int64_t)p_from * run;
+		for (int64_t i = 0; i < count; i++) {
+			ptr[i * channels + 0] = p_table[ptr[i * channels + 0]];
+			ptr[i * channels + 1] = p_table[ptr[i * channels + 1]];
+			ptr[i * channels + 2] = p_table[ptr[i * channels + 2]];
+		}
+	});
+}
+
 void Image::srgb_to_linear() {
 	if (data.size() == 0) {
 		return;
@@ -3815,24 +4345,9 @@ void Image::srgb_to_linear() {
 	ERR_FAIL_COND(format != FORMAT_RGB8 && format != FORMAT_RGBA8);
 
 	if (format == FORMAT_RGBA8) {
-		int len = data.size() / 4;
-		uint8_t *data_ptr = data.ptrw();
-
-		for (int i = 0; i < len; i++) {
-			data_ptr[(i << 2) + 0] = srgb2lin[data_ptr[(i << 2) + 0]];
-			data_ptr[(i << 2) + 1] = srgb2lin[data_ptr[(i << 2) + 1]];
-			data_ptr[(i << 2) + 2] = srgb2lin[data_ptr[(i << 2) + 2]];
-		}
-
+		_remap_rgb<4>(data.ptrw(), data.size() / 4, srgb2lin);
 	} else if (format == FORMAT_RGB8) {
-		int len = data.size() / 3;
-		uint8_t *data_ptr = data.ptrw();
-
-		for (int i = 0; i < len; i++) {
-			data_ptr[(i * 3) + 0] = srgb2lin[data_ptr[(i * 3) + 0]];
-			data_ptr[(i * 3) + 1] = srgb2lin[data_ptr[(i * 3) + 1]];
-			data_ptr[(i * 3) + 2] = srgb2lin[data_ptr[(i * 3) + 2]];
-		}
+		_remap_rgb<3>(data.ptrw(), data.size() / 3, srgb2lin);
 	}
 }
 
@@ -3846,24 +4361,9 @@ void Image::linear_to_srgb() {
 	ERR_FAIL_COND(format != FORMAT_RGB8 && format != FORMAT_RGBA8);
 
 	if (format == FORMAT_RGBA8) {
-		int len = data.size() / 4;
-		uint8_t *data_ptr = data.ptrw();
-
-		for (int i = 0; i < len; i++) {
-			data_ptr[(i << 2) + 0] = lin2srgb[data_ptr[(i << 2) + 0]];
-			data_ptr[(i << 2) + 1] = lin2srgb[data_ptr[(i << 2) + 1]];
-			data_ptr[(i << 2) + 2] = lin2srgb[data_ptr[(i << 2) + 2]];
-		}
-
+		_remap_rgb<4>(data.ptrw(), data.size() / 4, lin2srgb);
 	} else if (format == FORMAT_RGB8) {
-		int len = data.size() / 3;
-		uint8_t *data_ptr = data.ptrw();
-
-		for (int i = 0; i < len; i++) {
-			data_ptr[(i * 3) + 0] = lin2srgb[data_ptr[(i * 3) + 0]];
-			data_ptr[(i * 3) + 1] = lin2srgb[data_ptr[(i * 3) + 1]];
-			data_ptr[(i * 3) + 2] = lin2srgb[data_ptr[(i * 3) + 2]];
-		}
+		_remap_rgb<3>(data.ptrw(), data.size() / 3, lin2srgb);
 	}
 }
 
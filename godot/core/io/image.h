@@ -332,6 +332,8 @@ public:
 
 	Error load(const String &p_path);
 	static Ref<Image> load_from_file(const String &p_path);
+	static TypedArray<Image> load_from_files(const PackedStringArray &p_paths, Format p_format = FORMAT_MAX, bool p_generate_mipmaps = false);
+	static void load_from_files_async(const PackedStringArray &p_paths, const Callable &p_on_loaded, Format p_format = FORMAT_MAX, bool p_generate_mipmaps = false);
 	Error save_png(const String &p_path) const;
 	Error save_jpg(const String &p_path, float p_quality = 0.75) const;
 	Vector<uint8_t> save_png_to_buffer() const;
@@ -421,6 +423,31 @@ public:
 	void set_pixelv(const Point2i &p_point, const Color &p_color);
 	void set_pixel(int p_x, int p_y, const Color &p_color);
 
+	// Bulk access to the pixels of a region of the base image, without the per-pixel bounds checks and format dispatch.
+	Vector<Color> get_pixels_rect(const Rect2i &p_rect) const;
+	void set_pixels_rect(const Rect2i &p_rect, const Vector<Color> &p_colors);
+	Vector<uint8_t> get_data_rect(const Rect2i &p_rect) const;
+	void set_data_rect(const Rect2i &p_rect, const Vector<uint8_t> &p_data);
+
+	// Direct access to the rows of one mipmap level for native code. Each row holds `width` pixels of
+	// `pixel_size` bytes in the image's format, and rows are `stride` bytes apart. A span is only
+	// valid until the image data is modified through anything other than the span itself.
+	template <typename T>
+	struct PixelSpan {
+		T *data = nullptr;
+		int width = 0;
+		int height = 0;
+		int pixel_size = 0;
+		int64_t stride = 0;
+
+		_FORCE_INLINE_ bool is_valid() const { return data != nullptr; }
+		_FORCE_INLINE_ T *row(int p_y) const { return data + p_y * stride; }
+		_FORCE_INLINE_ T *pixel(int p_x, int p_y) const { return data + p_y * stride + p_x * pixel_size; }
+	};
+
+	PixelSpan<const uint8_t> get_pixel_span(int p_mipmap = 0) const;
+	PixelSpan<uint8_t> get_pixel_span_w(int p_mipmap = 0); // Like ptrw(), this makes the data unique first.
+
 	const uint8_t *ptr() const;
 	uint8_t *ptrw();
 	int64_t get_data_size() const;
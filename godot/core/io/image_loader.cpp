@@ -30,6 +30,9 @@
 
 #include "image_loader.h"
 
+#include "core/object/worker_thread_pool.h"
+#include "core/variant/typed_array.h"
+
 void ImageFormatLoader::_bind_methods() {
 	BIND_BITFIELD_FLAG(FLAG_NONE);
 	BIND_BITFIELD_FLAG(FLAG_FORCE_LINEAR);
@@ -124,6 +127,115 @@ Ref<ImageFormatLoader> ImageLoader::recognize(const String &p_extension) {
 	return nullptr;
 }
 
+struct ImageBatchLoad {
+	uint64_t id = 0;
+	Vector<String> paths;
+	Vector<Ref<Image>> images;
+	Ref<Image> *images_ptr = nullptr; // Each task writes its own element.
+	Image::Format format = Image::FORMAT_MAX;
+	bool generate_mipmaps = false;
+	Callable on_loaded;
+	SafeNumeric<uint32_t> pending;
+	WorkerThreadPool::GroupID group_id = -1;
+};
+
+static Mutex batch_load_mutex;
+static HashMap<uint64_t, ImageBatchLoad *> batch_loads; // Async batches waiting for their results to be delivered.
+static uint64_t last_batch_load_id = 0;
+
+static void _setup_batch_load(ImageBatchLoad *p_batch, const Vector<String> &p_paths, Image::Format p_format, bool p_generate_mipmaps) {
+	p_batch->paths = p_paths;
+	p_batch->images.resize(p_paths.size());
+	p_batch->images_ptr = p_batch->images.ptrw();
+	p_batch->format = p_format;
+	p_batch->generate_mipmaps = p_generate_mipmaps;
+	p_batch->pending.set(p_paths.size());
+}
+
+static void _finish_batch_load(uint64_t p_id) {
+	ImageBatchLoad *batch = nullptr;
+	{
+		MutexLock lock(batch_load_mutex);
+		ImageBatchLoad **batchp = batch_loads.getptr(p_id);
+		ERR_FAIL_NULL(batchp);
+		batch = *batchp;
+		batch_loads.erase(p_id);
+	}
+
+	if (batch->group_id >= 0) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(batch->group_id);
+	}
+
+	TypedArray<Image> images;
+	images.resize(batch->images.size());
+	for (int i = 0; i < batch->images.size(); i++) {
+		images[i] = batch->images[i];
+	}
+	batch->on_loaded.call(images);
+	memdelete(batch);
+}
+
+static void _load_batch_image(void *p_userdata, uint32_t p_index) {
+	ImageBatchLoad *batch = (ImageBatchLoad *)p_userdata;
+
+	Ref<Image> image;
+	image.instantiate();
+	if (ImageLoader::load_image(batch->paths[p_index], image) == OK) {
+		if (batch->format != Image::FORMAT_MAX && batch->format != image->get_format() && !image->is_compressed()) {
+			image->convert(batch->format);
+		}
+		if (batch->generate_mipmaps && !image->has_mipmaps() && !image->is_compressed()) {
+			image->generate_mipmaps();
+		}
+		batch->images_ptr[p_index] = image;
+	}
+
+	if (batch->on_loaded.is_valid() && batch->pending.decrement() == 0) {
+		callable_mp_static(&_finish_batch_load).call_deferred(batch->id);
+	}
+}
+
+Vector<Ref<Image>> ImageLoader::load_images(const Vector<String> &p_paths, Image::Format p_format, bool p_generate_mipmaps) {
+	ERR_FAIL_INDEX_V(p_format, Image::FORMAT_MAX + 1, Vector<Ref<Image>>());
+	ERR_FAIL_COND_V_MSG(p_format != Image::FORMAT_MAX && Image::is_format_compressed(p_format), Vector<Ref<Image>>(), "Cannot convert loaded images to a compressed format.");
+
+	ImageBatchLoad batch;
+	_setup_batch_load(&batch, p_paths, p_format, p_generate_mipmaps);
+
+	// Waiting from a pool thread could stall the pool, so those callers load the files themselves.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (p_paths.size() < 2 || pool->get_thread_index() != -1) {
+		for (int i = 0; i < p_paths.size(); i++) {
+			_load_batch_image(&batch, i);
+		}
+	} else {
+		WorkerThreadPool::GroupID group_id = pool->add_native_group_task(&_load_batch_image, &batch, p_paths.size(), -1, true, SNAME("ImageLoaderBatch"));
+		pool->wait_for_group_task_completion(group_id);
+	}
+
+	return batch.images;
+}
+
+void ImageLoader::load_images_async(const Vector<String> &p_paths, const Callable &p_on_loaded, Image::Format p_format, bool p_generate_mipmaps) {
+	ERR_FAIL_COND(!p_on_loaded.is_valid());
+	ERR_FAIL_INDEX(p_format, Image::FORMAT_MAX + 1);
+	ERR_FAIL_COND_MSG(p_format != Image::FORMAT_MAX && Image::is_format_compressed(p_format), "Cannot convert loaded images to a compressed format.");
+
+	ImageBatchLoad *batch = memnew(ImageBatchLoad);
+	_setup_batch_load(batch, p_paths, p_format, p_generate_mipmaps);
+	batch->on_loaded = p_on_loaded;
+
+	// The lock keeps the results from being delivered before the group ID is stored.
+	MutexLock lock(batch_load_mutex);
+	batch->id = ++last_batch_load_id;
+	batch_loads.insert(batch->id, batch);
+	if (p_paths.is_empty()) {
+		callable_mp_static(&_finish_batch_load).call_deferred(batch->id);
+	} else {
+		batch->group_id = WorkerThreadPool::get_singleton()->add_native_group_task(&_load_batch_image, batch, p_paths.size(), -1, false, SNAME("ImageLoaderBatch"));
+	}
+}
+
 Vector<Ref<ImageFormatLoader>> ImageLoader::loader;
 
 void ImageLoader::add_image_format_loader(Ref<ImageFormatLoader> p_loader) {
@@ -95,6 +95,12 @@ public:
 	static void get_recognized_extensions(List<String> *p_extensions);
 	static Ref<ImageFormatLoader> recognize(const String &p_extension);
 
+	// Batch loading decodes every file on the WorkerThreadPool, optionally converting it to p_format and
+	// generating mipmaps in the same task. Files that fail to load give a null image.
+	static Vector<Ref<Image>> load_images(const Vector<String> &p_paths, Image::Format p_format = Image::FORMAT_MAX, bool p_generate_mipmaps = false);
+	// Returns right away, p_on_loaded is called on the main thread with a TypedArray<Image> once every file is done.
+	static void load_images_async(const Vector<String> &p_paths, const Callable &p_on_loaded, Image::Format p_format = Image::FORMAT_MAX, bool p_generate_mipmaps = false);
+
 	static void add_image_format_loader(Ref<ImageFormatLoader> p_loader);
 	static void remove_image_format_loader(Ref<ImageFormatLoader> p_loader);
 
@@ -34,6 +34,7 @@
 #include "core/os/os.h"
 #include "core/os/safe_binary_mutex.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/parallel_for.h"
 
 WorkerThreadPool::Task *const WorkerThreadPool::ThreadData::YIELDING = (Task *)1;
 
@@ -72,7 +73,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		// about to be run uses scripting, guarantees are held.
 		ScriptServer::thread_enter();
 
-		task_mutex.lock();
+		_lock_task_mutex();
 		p_task->pool_thread_index = pool_thread_index;
 		prev_task = curr_thread.current_task;
 		curr_thread.current_task = p_task;
@@ -120,6 +121,9 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		if (do_post) {
 			p_task->group->done_semaphore.post();
 			p_task->group->completed.set_to(true);
+			if (p_task->group->graph_node) {
+				_task_graph_node_completed(p_task->group->graph_node);
+			}
 		}
 		uint32_t max_users = p_task->group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
 		uint32_t finished_users = p_task->group->finished.increment();
@@ -132,7 +136,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 
 		// For groups, tasks get rid of themselves.
 
-		task_mutex.lock();
+		_lock_task_mutex();
 		task_allocator.free(p_task);
 	} else {
 		if (p_task->native_func) {
@@ -144,7 +148,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			p_task->callable.call();
 		}
 
-		task_mutex.lock();
+		_lock_task_mutex();
 		p_task->completed = true;
 		p_task->pool_thread_index = -1;
 		if (p_task->waiting_user) {
@@ -180,26 +184,109 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 #endif
 }
 
+// Counts the times a worker finds task_mutex taken, which is what the local queues are meant to bring down.
+void WorkerThreadPool::_lock_task_mutex() {
+	if (!task_mutex.try_lock()) {
+		task_mutex.lock();
+		stats.mutex_contended++;
+	}
+}
+
+// Must be called with task_mutex held. Pushes to a local queue happen under the lock too,
+// so a thread that found every queue empty while holding it can't miss a task before waiting.
+void WorkerThreadPool::_enqueue_task(ThreadData *p_caller_pool_thread, Task *p_task) {
+	if (p_caller_pool_thread && p_caller_pool_thread->local_queue.push(p_task)) {
+		ThreadStats::increment(p_caller_pool_thread->stats.posted_local);
+	} else {
+		task_queue.add_last(&p_task->task_elem);
+		stats.posted_global++;
+	}
+}
+
+// Lock-free, owner thread only.
+WorkerThreadPool::Task *WorkerThreadPool::_pop_local_task(ThreadData *p_thread_data) {
+	Task *task = nullptr;
+	if (p_thread_data->local_queue.pop(task)) {
+		ThreadStats::increment(p_thread_data->stats.popped_local);
+		return task;
+	}
+	return nullptr;
+}
+
+// Lock-free. Tries every other thread once, starting from a random one so thieves spread out.
+WorkerThreadPool::Task *WorkerThreadPool::_steal_task(ThreadData *p_thread_data) {
+	uint32_t thread_count = threads.size();
+	if (thread_count < 2) {
+		return nullptr;
+	}
+
+	// Xorshift32.
+	uint32_t seed = p_thread_data->steal_seed;
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	p_thread_data->steal_seed = seed;
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		ThreadData &victim = threads[(seed + i) % thread_count];
+		if (&victim == p_thread_data) {
+			continue;
+		}
+		Task *task = nullptr;
+		while (!victim.local_queue.is_empty()) {
+			if (victim.local_queue.steal(task)) {
+				ThreadStats::increment(p_thread_data->stats.stolen);
+				return task;
+			}
+			ThreadStats::increment(p_thread_data->stats.steal_races_lost);
+		}
+	}
+	return nullptr;
+}
+
+bool WorkerThreadPool::_has_queued_tasks() const {
+	if (task_queue.first()) {
+		return true;
+	}
+	for (uint32_t i = 0; i < threads.size(); i++) {
+		if (!threads[i].local_queue.is_empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void WorkerThreadPool::_thread_function(void *p_user) {
 	ThreadData *thread_data = (ThreadData *)p_user;
+	WorkerThreadPool *pool = thread_data->pool;
 
 	while (true) {
-		Task *task_to_process = nullptr;
-		{
-			MutexLock lock(thread_data->pool->task_mutex);
+		// Fast path: this thread's own tasks, then other workers', without touching task_mutex.
+		Task *task_to_process = pool->_pop_local_task(thread_data);
+		if (!task_to_process) {
+			task_to_process = pool->_steal_task(thread_data);
+		}
+
+		if (!task_to_process) {
+			MutexLock lock(pool->task_mutex);
 
-			bool exit = thread_data->pool->_handle_runlevel(thread_data, lock);
+			bool exit = pool->_handle_runlevel(thread_data, lock);
 			if (unlikely(exit)) {
 				break;
 			}
 
 			thread_data->signaled = false;
 
-			if (thread_data->pool->task_queue.first()) {
-				task_to_process = thread_data->pool->task_queue.first()->self();
-				thread_data->pool->task_queue.remove(thread_data->pool->task_queue.first());
+			if (pool->task_queue.first()) {
+				task_to_process = pool->task_queue.first()->self();
+				pool->task_queue.remove(pool->task_queue.first());
+				pool->stats.popped_global++;
 			} else {
-				thread_data->cond_var.wait(lock);
+				// Tasks may have been pushed to a local queue since the lock-free attempt.
+				task_to_process = pool->_steal_task(thread_data);
+				if (!task_to_process) {
+					thread_data->cond_var.wait(lock);
+				}
 			}
 		}
 
@@ -235,7 +322,9 @@ void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high
 	for (uint32_t i = 0; i < p_count; i++) {
 		p_tasks[i]->low_priority = !p_high_priority;
 		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
-			task_queue.add_last(&p_tasks[i]->task_elem);
+			// Tasks spawned by a worker stay on its local queue, where it will most likely pick them up
+			// itself (e.g. when it waits for them), and where idle threads can steal them.
+			_enqueue_task(caller_pool_thread, p_tasks[i]);
 			if (!p_high_priority) {
 				low_priority_threads_used++;
 			}
@@ -481,7 +570,7 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				if (was_signaled) {
 					// This thread was awaken for some additional reason, but it's about to exit.
 					// Let's find out what may be pending and forward the requests.
-					uint32_t to_process = task_queue.first() ? 1 : 0;
+					uint32_t to_process = _has_queued_tasks() ? 1 : 0;
 					uint32_t to_promote = p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
 					if (to_process || to_promote) {
 						// This thread must be left alone since it won't loop again.
@@ -499,9 +588,15 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				}
 			}
 
-			if (p_caller_pool_thread->pool->task_queue.first()) {
+			// Newest own tasks first (most likely the awaited ones), then the global queue, then other workers'.
+			task_to_process = _pop_local_task(p_caller_pool_thread);
+			if (!task_to_process && task_queue.first()) {
 				task_to_process = task_queue.first()->self();
 				task_queue.remove(task_queue.first());
+				stats.popped_global++;
+			}
+			if (!task_to_process) {
+				task_to_process = _steal_task(p_caller_pool_thread);
 			}
 
 			if (!task_to_process) {
@@ -547,7 +642,7 @@ bool WorkerThreadPool::_handle_runlevel(ThreadData *p_thread_data, MutexLock<Bin
 		} break;
 		case RUNLEVEL_PRE_EXIT_LANGUAGES: {
 			if (!p_thread_data->pre_exited_languages) {
-				if (!task_queue.first() && !low_priority_task_queue.first()) {
+				if (!_has_queued_tasks() && !low_priority_task_queue.first()) {
 					p_thread_data->pre_exited_languages = true;
 					runlevel_data.pre_exit_languages.num_idle_threads++;
 					control_cond_var.notify_all();
@@ -717,6 +812,260 @@ void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 #endif
 }
 
+WorkerThreadPool::TaskGraphID WorkerThreadPool::create_task_graph(bool p_high_priority, const String &p_description) {
+	MutexLock task_lock(task_mutex);
+	TaskGraph *graph = memnew(TaskGraph);
+	TaskGraphID id = last_task++;
+	graph->self = id;
+	graph->high_priority = p_high_priority;
+	graph->description = p_description;
+	task_graphs.insert(id, graph);
+	return id;
+}
+
+int WorkerThreadPool::_add_task_graph_node(TaskGraphID p_graph, const Callable &p_callable, void (*p_func)(void *), void (*p_group_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_is_group, int p_elements, int p_tasks, const Vector<int> &p_dependencies) {
+	MutexLock task_lock(task_mutex);
+
+	TaskGraph **graphp = task_graphs.getptr(p_graph);
+	String error;
+	if (!graphp) {
+		error = "Invalid task graph ID.";
+	} else if ((*graphp)->started) {
+		error = "Nodes can't be added to a task graph that was already started.";
+	} else if (p_elements < 0) {
+		error = "The element count can't be negative.";
+	} else {
+		for (int dependency : p_dependencies) {
+			if (dependency < 0 || dependency >= (int)(*graphp)->nodes.size()) {
+				error = "Dependencies must be nodes added earlier to the same task graph.";
+				break;
+			}
+		}
+	}
+	if (!error.is_empty()) {
+		if (p_template_userdata) {
+			memdelete(p_template_userdata);
+		}
+		ERR_FAIL_V_MSG(-1, error);
+	}
+
+	TaskGraph *graph = *graphp;
+	TaskGraphNode *node = memnew(TaskGraphNode);
+	node->graph = graph;
+	if (p_is_group && p_elements == 0) {
+		// Nothing to run, but it still has to pass completion on to its successors.
+		if (p_template_userdata) {
+			memdelete(p_template_userdata);
+		}
+	} else {
+		node->callable = p_callable;
+		node->native_func = p_func;
+		node->native_group_func = p_group_func;
+		node->native_func_userdata = p_userdata;
+		node->template_userdata = p_template_userdata;
+		node->is_group = p_is_group;
+		node->elements = p_is_group ? p_elements : 1;
+		if (p_is_group) {
+			if (p_tasks < 0) {
+				p_tasks = MAX(1u, threads.size());
+			}
+			node->tasks = CLAMP(p_tasks, 1, p_elements);
+		}
+	}
+
+	int index = graph->nodes.size();
+	node->pending_dependencies.set(p_dependencies.size());
+	for (int dependency : p_dependencies) {
+		graph->nodes[dependency]->successors.push_back(index);
+	}
+	graph->nodes.push_back(node);
+	return index;
+}
+
+int WorkerThreadPool::add_native_graph_task(TaskGraphID p_graph, void (*p_func)(void *), void *p_userdata, const Vector<int> &p_dependencies) {
+	return _add_task_graph_node(p_graph, Callable(), p_func, nullptr, p_userdata, nullptr, false, 1, 1, p_dependencies);
+}
+
+int WorkerThreadPool::add_native_graph_group_task(TaskGraphID p_graph, void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, const Vector<int> &p_dependencies, int p_tasks) {
+	return _add_task_graph_node(p_graph, Callable(), nullptr, p_func, p_userdata, nullptr, true, p_elements, p_tasks, p_dependencies);
+}
+
+int WorkerThreadPool::add_graph_task(TaskGraphID p_graph, const Callable &p_action, const Vector<int> &p_dependencies) {
+	return _add_task_graph_node(p_graph, p_action, nullptr, nullptr, nullptr, nullptr, false, 1, 1, p_dependencies);
+}
+
+int WorkerThreadPool::add_graph_group_task(TaskGraphID p_graph, const Callable &p_action, int p_elements, const Vector<int> &p_dependencies, int p_tasks) {
+	return _add_task_graph_node(p_graph, p_action, nullptr, nullptr, nullptr, nullptr, true, p_elements, p_tasks, p_dependencies);
+}
+
+void WorkerThreadPool::_task_graph_node_function(void *p_node, uint32_t p_index) {
+	TaskGraphNode *node = (TaskGraphNode *)p_node;
+	if (node->is_group) {
+		if (node->native_group_func) {
+			node->native_group_func(node->native_func_userdata, p_index);
+		} else if (node->template_userdata) {
+			node->template_userdata->callback_indexed(p_index);
+		} else {
+			node->callable.call(p_index);
+		}
+	} else {
+		if (node->native_func) {
+			node->native_func(node->native_func_userdata);
+		} else if (node->template_userdata) {
+			node->template_userdata->callback();
+		} else if (node->callable.is_valid()) {
+			node->callable.call();
+		}
+	}
+}
+
+// Every node runs as a group, which frees itself once its last task is done.
+void WorkerThreadPool::_post_task_graph_node(TaskGraphNode *p_node, MutexLock<BinaryMutex> &p_lock) {
+	Group *group = group_allocator.alloc();
+	group->max = p_node->elements;
+	group->tasks_used = p_node->tasks;
+	group->graph_node = p_node;
+	group->finished.increment(); // Nobody waits on the group itself, so account for the waiter up front.
+
+	Task **tasks_posted = (Task **)alloca(sizeof(Task *) * p_node->tasks);
+	for (int i = 0; i < p_node->tasks; i++) {
+		Task *task = task_allocator.alloc();
+		task->native_group_func = &WorkerThreadPool::_task_graph_node_function;
+		task->native_func_userdata = p_node;
+		task->description = p_node->graph->description;
+		task->group = group;
+		tasks_posted[i] = task;
+	}
+
+	_post_tasks(tasks_posted, p_node->tasks, p_node->graph->high_priority, p_lock);
+}
+
+// Called by whichever thread finished the last element of the node.
+void WorkerThreadPool::_task_graph_node_completed(TaskGraphNode *p_node) {
+	TaskGraph *graph = p_node->graph;
+
+	if (!p_node->successors.is_empty()) {
+		MutexLock task_lock(task_mutex);
+		for (uint32_t successor : p_node->successors) {
+			TaskGraphNode *next = graph->nodes[successor];
+			if (next->pending_dependencies.decrement() == 0) {
+				_post_task_graph_node(next, task_lock);
+			}
+		}
+	}
+
+	if (graph->pending_nodes.decrement() == 0) {
+		if (graph->on_completed.is_valid()) {
+			graph->on_completed.call();
+		}
+		// Last access to the graph, a waiter may free it right after.
+		graph->completed.set_to(true);
+		graph->done_semaphore.post();
+	}
+}
+
+void WorkerThreadPool::start_task_graph(TaskGraphID p_graph, const Callable &p_on_completed) {
+	MutexLock task_lock(task_mutex);
+	TaskGraph **graphp = task_graphs.getptr(p_graph);
+	if (!graphp) {
+		ERR_FAIL_MSG("Invalid task graph ID.");
+	}
+	TaskGraph *graph = *graphp;
+	ERR_FAIL_COND_MSG(graph->started, "Task graph was already started.");
+
+	graph->started = true;
+	graph->on_completed = p_on_completed;
+	graph->pending_nodes.set(graph->nodes.size());
+
+	if (graph->nodes.is_empty()) {
+		task_lock.temp_unlock();
+		if (graph->on_completed.is_valid()) {
+			graph->on_completed.call();
+		}
+		graph->completed.set_to(true);
+		graph->done_semaphore.post();
+		return;
+	}
+
+	// Collect the roots before posting any, since finished roots start releasing other nodes right away.
+	LocalVector<TaskGraphNode *> roots;
+	for (TaskGraphNode *node : graph->nodes) {
+		if (node->pending_dependencies.get() == 0) {
+			roots.push_back(node);
+		}
+	}
+	for (TaskGraphNode *root : roots) {
+		_post_task_graph_node(root, task_lock);
+	}
+}
+
+bool WorkerThreadPool::is_task_graph_completed(TaskGraphID p_graph) const {
+	MutexLock task_lock(task_mutex);
+	const TaskGraph *const *graphp = task_graphs.getptr(p_graph);
+	if (!graphp) {
+		ERR_FAIL_V_MSG(false, "Invalid task graph ID.");
+	}
+	return (*graphp)->completed.is_set();
+}
+
+void WorkerThreadPool::wait_for_task_graph_completion(TaskGraphID p_graph) {
+	task_mutex.lock();
+	TaskGraph **graphp = task_graphs.getptr(p_graph);
+	TaskGraph *graph = graphp ? *graphp : nullptr;
+	bool started = graph && graph->started;
+	task_mutex.unlock();
+	if (!graph) {
+		ERR_FAIL_MSG("Invalid task graph ID.");
+	}
+	ERR_FAIL_COND_MSG(!started, "Task graph was never started.");
+
+	if (this == singleton) {
+		_unlock_unlockable_mutexes();
+	}
+	graph->done_semaphore.wait();
+	if (this == singleton) {
+		_lock_unlockable_mutexes();
+	}
+
+	{
+		MutexLock task_lock(task_mutex);
+		task_graphs.erase(p_graph);
+	}
+	_free_task_graph(graph);
+}
+
+void WorkerThreadPool::parallel_for(int64_t p_begin, int64_t p_end, const Callable &p_action, int64_t p_grain) {
+	ERR_FAIL_COND(!p_action.is_valid());
+	::parallel_for(
+			p_begin, p_end, [&p_action](int64_t p_from, int64_t p_to) {
+				p_action.call(p_from, p_to);
+			},
+			p_grain, this);
+}
+
+Variant WorkerThreadPool::parallel_reduce(int64_t p_begin, int64_t p_end, const Variant &p_identity, const Callable &p_map, const Callable &p_reduce, int64_t p_grain) {
+	ERR_FAIL_COND_V(!p_map.is_valid(), p_identity);
+	ERR_FAIL_COND_V(!p_reduce.is_valid(), p_identity);
+	return ::parallel_reduce(
+			p_begin, p_end, p_identity, [&p_map](int64_t p_from, int64_t p_to) {
+				return p_map.call(p_from, p_to);
+			},
+			[&p_reduce](const Variant &p_accumulated, const Variant &p_value) {
+				return p_reduce.call(p_accumulated, p_value);
+			},
+			p_grain, this);
+}
+
+void WorkerThreadPool::_free_task_graph(TaskGraph *p_graph) {
+	for (TaskGraphNode *node : p_graph->nodes) {
+		if (node->template_userdata) {
+			memdelete(node->template_userdata);
+		}
+		memdelete(node);
+	}
+	memdelete(p_graph);
+}
+
 int WorkerThreadPool::get_thread_index() const {
 	Thread::ID tid = Thread::get_caller_id();
 	return thread_ids.has(tid) ? thread_ids[tid] : -1;
@@ -731,6 +1080,43 @@ WorkerThreadPool::TaskID WorkerThreadPool::get_caller_task_id() const {
 	}
 }
 
+Dictionary WorkerThreadPool::get_statistics() const {
+	uint64_t posted_local = 0;
+	uint64_t popped_local = 0;
+	uint64_t stolen = 0;
+	uint64_t steal_races_lost = 0;
+	for (const ThreadData &thread_data : threads) {
+		posted_local += thread_data.stats.posted_local.load(std::memory_order_relaxed);
+		popped_local += thread_data.stats.popped_local.load(std::memory_order_relaxed);
+		stolen += thread_data.stats.stolen.load(std::memory_order_relaxed);
+		steal_races_lost += thread_data.stats.steal_races_lost.load(std::memory_order_relaxed);
+	}
+
+	MutexLock lock(task_mutex);
+	Dictionary statistics;
+	statistics["posted_local"] = posted_local;
+	statistics["posted_global"] = stats.posted_global;
+	statistics["popped_local"] = popped_local;
+	statistics["popped_global"] = stats.popped_global;
+	statistics["stolen"] = stolen;
+	statistics["steal_races_lost"] = steal_races_lost;
+	statistics["mutex_contended"] = stats.mutex_contended;
+	return statistics;
+}
+
+// Counters of threads that are busy may miss the reset by a few increments, since only their owners write them.
+void WorkerThreadPool::reset_statistics() {
+	for (ThreadData &thread_data : threads) {
+		thread_data.stats.posted_local.store(0, std::memory_order_relaxed);
+		thread_data.stats.popped_local.store(0, std::memory_order_relaxed);
+		thread_data.stats.stolen.store(0, std::memory_order_relaxed);
+		thread_data.stats.steal_races_lost.store(0, std::memory_order_relaxed);
+	}
+
+	MutexLock lock(task_mutex);
+	stats = Stats();
+}
+
 #ifdef THREADS_ENABLED
 uint32_t WorkerThreadPool::_thread_enter_unlock_allowance_zone(THREADING_NAMESPACE::unique_lock<THREADING_NAMESPACE::mutex> &p_ulock) {
 	for (uint32_t i = 0; i < MAX_UNLOCKABLE_LOCKS; i++) {
@@ -774,6 +1160,7 @@ void WorkerThreadPool::init(int p_thread_count, float p_low_priority_task_ratio)
 
 	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].index = i;
+		threads[i].steal_seed = 0x9E3779B9u * (i + 1); // Never zero, which xorshift can't leave.
 		threads[i].pool = this;
 		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
 		thread_ids.insert(threads[i].thread.get_id(), i);
@@ -825,6 +1212,10 @@ void WorkerThreadPool::finish() {
 		for (KeyValue<TaskID, Task *> &E : tasks) {
 			task_allocator.free(E.value);
 		}
+		for (KeyValue<TaskGraphID, TaskGraph *> &E : task_graphs) {
+			_free_task_graph(E.value);
+		}
+		task_graphs.clear();
 	}
 
 	threads.clear();
@@ -839,6 +1230,19 @@ void WorkerThreadPool::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_group_task_completed", "group_id"), &WorkerThreadPool::is_group_task_completed);
 	ClassDB::bind_method(D_METHOD("get_group_processed_element_count", "group_id"), &WorkerThreadPool::get_group_processed_element_count);
 	ClassDB::bind_method(D_METHOD("wait_for_group_task_completion", "group_id"), &WorkerThreadPool::wait_for_group_task_completion);
+
+	ClassDB::bind_method(D_METHOD("create_task_graph", "high_priority", "description"), &WorkerThreadPool::create_task_graph, DEFVAL(false), DEFVAL(String()));
+	ClassDB::bind_method(D_METHOD("add_graph_task", "graph_id", "action", "dependencies"), &WorkerThreadPool::add_graph_task, DEFVAL(Vector<int>()));
+	ClassDB::bind_method(D_METHOD("add_graph_group_task", "graph_id", "action", "elements", "dependencies", "tasks_needed"), &WorkerThreadPool::add_graph_group_task, DEFVAL(Vector<int>()), DEFVAL(-1));
+	ClassDB::bind_method(D_METHOD("start_task_graph", "graph_id", "on_completed"), &WorkerThreadPool::start_task_graph, DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("is_task_graph_completed", "graph_id"), &WorkerThreadPool::is_task_graph_completed);
+	ClassDB::bind_method(D_METHOD("wait_for_task_graph_completion", "graph_id"), &WorkerThreadPool::wait_for_task_graph_completion);
+
+	ClassDB::bind_method(D_METHOD("parallel_for", "begin", "end", "action", "grain"), &WorkerThreadPool::parallel_for, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("parallel_reduce", "begin", "end", "identity", "map", "reduce", "grain"), &WorkerThreadPool::parallel_reduce, DEFVAL(0));
+
+	ClassDB::bind_method(D_METHOD("get_statistics"), &WorkerThreadPool::get_statistics);
+	ClassDB::bind_method(D_METHOD("reset_statistics"), &WorkerThreadPool::reset_statistics);
 }
 
 WorkerThreadPool *WorkerThreadPool::get_named_pool(const StringName &p_name) {
@@ -40,6 +40,7 @@
 #include "core/templates/paged_allocator.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
+#include "core/templates/work_stealing_deque.h"
 
 class WorkerThreadPool : public Object {
 	GDCLASS(WorkerThreadPool, Object)
@@ -50,9 +51,11 @@ public:
 
 	typedef int64_t TaskID;
 	typedef int64_t GroupID;
+	typedef int64_t TaskGraphID;
 
 private:
 	struct Task;
+	struct TaskGraph;
 
 	struct BaseTemplateUserdata {
 		virtual void callback() {}
@@ -60,6 +63,33 @@ private:
 		virtual ~BaseTemplateUserdata() {}
 	};
 
+	// A task or group task in a graph, released once all its dependencies have finished.
+	struct TaskGraphNode {
+		TaskGraph *graph = nullptr;
+		Callable callable;
+		void (*native_func)(void *) = nullptr;
+		void (*native_group_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		bool is_group = false;
+		uint32_t elements = 1;
+		int tasks = 1;
+		SafeNumeric<uint32_t> pending_dependencies;
+		LocalVector<uint32_t> successors;
+	};
+
+	struct TaskGraph {
+		TaskGraphID self = -1;
+		String description;
+		bool high_priority = false;
+		bool started = false;
+		LocalVector<TaskGraphNode *> nodes;
+		SafeNumeric<uint32_t> pending_nodes;
+		Callable on_completed;
+		Semaphore done_semaphore;
+		SafeFlag completed;
+	};
+
 	struct Group {
 		GroupID self = -1;
 		SafeNumeric<uint32_t> index;
@@ -69,6 +99,7 @@ private:
 		SafeFlag completed;
 		SafeNumeric<uint32_t> finished;
 		uint32_t tasks_used = 0;
+		TaskGraphNode *graph_node = nullptr; // Set when the group runs a task graph node.
 	};
 
 	struct Task {
@@ -103,15 +134,34 @@ private:
 	PagedAllocator<Group, false, GROUPS_PAGE_SIZE> group_allocator;
 
 	SelfList<Task>::List low_priority_task_queue;
-	SelfList<Task>::List task_queue;
+	SelfList<Task>::List task_queue; // Tasks posted from outside the pool, or from a worker whose local queue is full.
 
 	BinaryMutex task_mutex;
 
+	static const uint32_t LOCAL_QUEUE_SIZE = 1024;
+
+	// Counters of the lock-free paths. Only the owning thread writes them, so a relaxed load and
+	// store is enough and the fast path never does a locked read-modify-write on shared memory.
+	struct ThreadStats {
+		std::atomic<uint64_t> posted_local = 0;
+		std::atomic<uint64_t> popped_local = 0;
+		std::atomic<uint64_t> stolen = 0;
+		std::atomic<uint64_t> steal_races_lost = 0;
+
+		_FORCE_INLINE_ static void increment(std::atomic<uint64_t> &r_counter) {
+			r_counter.store(r_counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+	};
+
 	struct ThreadData {
 		static Task *const YIELDING; // Too bad constexpr doesn't work here.
 
 		uint32_t index = 0;
 		Thread thread;
+		// Tasks posted by this thread. Only this thread pushes and pops, without task_mutex;
+		// the others steal from the other end when the global queue is empty.
+		WorkStealingDeque<Task *, LOCAL_QUEUE_SIZE> local_queue;
+		uint32_t steal_seed = 0;
 		bool signaled : 1;
 		bool yield_is_over : 1;
 		bool pre_exited_languages : 1;
@@ -120,6 +170,7 @@ private:
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable, or special value (YIELDING).
 		ConditionVariable cond_var;
 		WorkerThreadPool *pool = nullptr;
+		ThreadStats stats;
 
 		ThreadData() :
 				signaled(false),
@@ -160,6 +211,7 @@ private:
 			HashMapComparatorDefault<GroupID>,
 			PagedAllocator<HashMapElement<GroupID, Group *>, false, GROUPS_PAGE_SIZE>>
 			groups;
+	HashMap<TaskGraphID, TaskGraph *> task_graphs;
 
 	uint32_t max_low_priority_threads = 0;
 	uint32_t low_priority_threads_used = 0;
@@ -167,17 +219,37 @@ private:
 
 	uint64_t last_task = 1;
 
+	// Counters to see how work flows through the queues and how often task_mutex is contended.
+	// These are only touched with task_mutex held; get_statistics() adds the per-thread ones.
+	struct Stats {
+		uint64_t posted_global = 0;
+		uint64_t popped_global = 0;
+		uint64_t mutex_contended = 0;
+	} stats;
+
 	static HashMap<StringName, WorkerThreadPool *> named_pools;
 
 	static void _thread_function(void *p_user);
 
 	void _process_task(Task *task);
 
+	void _lock_task_mutex();
+	void _enqueue_task(ThreadData *p_caller_pool_thread, Task *p_task);
+	Task *_pop_local_task(ThreadData *p_thread_data);
+	Task *_steal_task(ThreadData *p_thread_data);
+	bool _has_queued_tasks() const;
+
 	void _post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority, MutexLock<BinaryMutex> &p_lock);
 	void _notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count);
 
 	bool _try_promote_low_priority_task();
 
+	int _add_task_graph_node(TaskGraphID p_graph, const Callable &p_callable, void (*p_func)(void *), void (*p_group_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_is_group, int p_elements, int p_tasks, const Vector<int> &p_dependencies);
+	void _post_task_graph_node(TaskGraphNode *p_node, MutexLock<BinaryMutex> &p_lock);
+	void _task_graph_node_completed(TaskGraphNode *p_node);
+	static void _task_graph_node_function(void *p_node, uint32_t p_index);
+	static void _free_task_graph(TaskGraph *p_graph);
+
 	static WorkerThreadPool *singleton;
 
 #ifdef THREADS_ENABLED
@@ -261,6 +333,40 @@ public:
 	bool is_group_task_completed(GroupID p_group) const;
 	void wait_for_group_task_completion(GroupID p_group);
 
+	// Task graphs: nodes start as soon as every node they depend on has finished, without
+	// blocking a thread between stages. Dependencies must be nodes added earlier to the same graph,
+	// so graphs can't have cycles. Like tasks, every started graph must be waited for.
+	TaskGraphID create_task_graph(bool p_high_priority = false, const String &p_description = String());
+	template <typename C, typename M, typename U>
+	int add_template_graph_task(TaskGraphID p_graph, C *p_instance, M p_method, U p_userdata, const Vector<int> &p_dependencies = Vector<int>()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task_graph_node(p_graph, Callable(), nullptr, nullptr, nullptr, ud, false, 1, 1, p_dependencies);
+	}
+	template <typename C, typename M, typename U>
+	int add_template_graph_group_task(TaskGraphID p_graph, C *p_instance, M p_method, U p_userdata, int p_elements, const Vector<int> &p_dependencies = Vector<int>(), int p_tasks = -1) {
+		typedef GroupUserData<C, M, U> GroupUD;
+		GroupUD *ud = memnew(GroupUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task_graph_node(p_graph, Callable(), nullptr, nullptr, nullptr, ud, true, p_elements, p_tasks, p_dependencies);
+	}
+	int add_native_graph_task(TaskGraphID p_graph, void (*p_func)(void *), void *p_userdata, const Vector<int> &p_dependencies = Vector<int>());
+	int add_native_graph_group_task(TaskGraphID p_graph, void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, const Vector<int> &p_dependencies = Vector<int>(), int p_tasks = -1);
+	int add_graph_task(TaskGraphID p_graph, const Callable &p_action, const Vector<int> &p_dependencies = Vector<int>());
+	int add_graph_group_task(TaskGraphID p_graph, const Callable &p_action, int p_elements, const Vector<int> &p_dependencies = Vector<int>(), int p_tasks = -1);
+	void start_task_graph(TaskGraphID p_graph, const Callable &p_on_completed = Callable());
+	bool is_task_graph_completed(TaskGraphID p_graph) const;
+	void wait_for_task_graph_completion(TaskGraphID p_graph);
+
+	// Callable versions of the helpers in core/templates/parallel_for.h, for scripts.
+	void parallel_for(int64_t p_begin, int64_t p_end, const Callable &p_action, int64_t p_grain = 0);
+	Variant parallel_reduce(int64_t p_begin, int64_t p_end, const Variant &p_identity, const Callable &p_map, const Callable &p_reduce, int64_t p_grain = 0);
+
 	_FORCE_INLINE_ int get_thread_count() const {
 #ifdef THREADS_ENABLED
 		return threads.size();
@@ -276,6 +382,9 @@ public:
 	int get_thread_index() const;
 	TaskID get_caller_task_id() const;
 
+	Dictionary get_statistics() const;
+	void reset_statistics();
+
 #ifdef THREADS_ENABLED
 	_ALWAYS_INLINE_ static uint32_t thread_enter_unlock_allowance_zone(const MutexLock<BinaryMutex> &p_lock) { return _thread_enter_unlock_allowance_zone(p_lock._get_lock()); }
 	template <int Tag>
@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*  parallel_for.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+
+// parallel_for() and parallel_reduce() split [p_begin, p_end) into blocks of p_grain elements,
+// run them as a group task on the WorkerThreadPool and return once every block is done.
+// p_func is called as p_func(from, to) with disjoint ranges covering the whole range, from
+// several threads at once.
+// With a grain of 0, the range is split into a few blocks per thread but never into blocks
+// smaller than PARALLEL_FOR_MIN_AUTO_GRAIN elements; pass a grain when single elements are
+// expensive. Ranges that fit in one block, pools without worker threads and calls made from
+// a pool thread (where waiting for the group would stall the pool) run p_func inline on the
+// whole range instead.
+
+static constexpr int64_t PARALLEL_FOR_MIN_AUTO_GRAIN = 64;
+static constexpr int64_t PARALLEL_FOR_BLOCKS_PER_THREAD = 4;
+
+struct ParallelForRange {
+	WorkerThreadPool *pool = nullptr;
+	int64_t begin = 0;
+	int64_t end = 0;
+	int64_t grain = 1;
+	int64_t block_count = 0;
+	bool run_inline = true;
+
+	int64_t get_block_from(int64_t p_block) const { return begin + p_block * grain; }
+	int64_t get_block_to(int64_t p_block) const { return MIN(begin + (p_block + 1) * grain, end); }
+
+	ParallelForRange(int64_t p_begin, int64_t p_end, int64_t p_grain, WorkerThreadPool *p_pool) {
+		pool = p_pool ? p_pool : WorkerThreadPool::get_singleton();
+		const int thread_count = pool ? pool->get_thread_count() : 0;
+		const int64_t count = MAX(p_end - p_begin, (int64_t)0);
+
+		begin = p_begin;
+		end = p_begin + count;
+		run_inline = thread_count < 2 || pool->get_thread_index() != -1 || (p_grain > 0 && count <= p_grain);
+
+		// Pools that were never initialized have no threads at all.
+		grain = p_grain > 0 ? p_grain : MAX(count / (MAX(thread_count, 1) * PARALLEL_FOR_BLOCKS_PER_THREAD), PARALLEL_FOR_MIN_AUTO_GRAIN);
+		// Group tasks index their elements with 32-bit integers.
+		grain = MAX(grain, (count + INT32_MAX - 1) / INT32_MAX);
+		block_count = (count + grain - 1) / grain;
+		run_inline = run_inline || block_count < 2;
+	}
+};
+
+template <typename F>
+struct ParallelForBlocks {
+	const ParallelForRange *range = nullptr;
+	const F *func = nullptr;
+
+	static void process(void *p_userdata, uint32_t p_block) {
+		const ParallelForBlocks *blocks = (const ParallelForBlocks *)p_userdata;
+		(*blocks->func)(p_block, blocks->range->get_block_from(p_block), blocks->range->get_block_to(p_block));
+	}
+};
+
+// Calls p_func(block, from, to) for every block of p_range on its pool.
+template <typename F>
+void _parallel_for_blocks(const ParallelForRange &p_range, const F &p_func) {
+	ParallelForBlocks<F> blocks;
+	blocks.range = &p_range;
+	blocks.func = &p_func;
+
+	WorkerThreadPool::GroupID group_task = p_range.pool->add_native_group_task(&ParallelForBlocks<F>::process, &blocks, p_range.block_count, -1, true, SNAME("ParallelFor"));
+	p_range.pool->wait_for_group_task_completion(group_task);
+}
+
+template <typename F>
+void parallel_for(int64_t p_begin, int64_t p_end, const F &p_func, int64_t p_grain = 0, WorkerThreadPool *p_pool = nullptr) {
+	const ParallelForRange range(p_begin, p_end, p_grain, p_pool);
+	if (range.block_count == 0) {
+		return;
+	}
+	if (range.run_inline) {
+		p_func(range.begin, range.end);
+		return;
+	}
+
+	_parallel_for_blocks(range, [&p_func](int64_t p_block, int64_t p_from, int64_t p_to) {
+		p_func(p_from, p_to);
+	});
+}
+
+// p_func(from, to) returns the value of its block, and the values of all blocks are then folded
+// with p_reduce(accumulated, value) on the calling thread, starting from p_identity and in block
+// order. Blocks only depend on the range and the grain, so with a fixed grain the result is the
+// same on every run even when p_reduce isn't associative (e.g. adding floats).
+template <typename T, typename F, typename R>
+T parallel_reduce(int64_t p_begin, int64_t p_end, const T &p_identity, const F &p_func, const R &p_reduce, int64_t p_grain = 0, WorkerThreadPool *p_pool = nullptr) {
+	const ParallelForRange range(p_begin, p_end, p_grain, p_pool);
+	if (range.block_count == 0) {
+		return p_identity;
+	}
+	if (range.run_inline) {
+		// Same blocks as on the pool, so inline runs fold to the same result.
+		T result = p_identity;
+		for (int64_t i = 0; i < range.block_count; i++) {
+			result = p_reduce(result, p_func(range.get_block_from(i), range.get_block_to(i)));
+		}
+		return result;
+	}
+
+	LocalVector<T> values;
+	values.resize(range.block_count);
+	T *values_ptr = values.ptr();
+	_parallel_for_blocks(range, [values_ptr, &p_func](int64_t p_block, int64_t p_from, int64_t p_to) {
+		values_ptr[p_block] = p_func(p_from, p_to);
+	});
+
+	T result = p_identity;
+	for (const T &value : values) {
+		result = p_reduce(result, value);
+	}
+	return result;
+}
+
+#endif // PARALLEL_FOR_H
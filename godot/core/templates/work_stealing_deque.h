@@ -0,0 +1,129 @@
+/**************************************************************************/
+/*  work_stealing_deque.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include "core/typedefs.h"
+
+#include <atomic>
+
+// Fixed-capacity Chase-Lev deque (Chase & Lev 2005, with the C11 memory orderings from
+// Lê et al. 2013). One owner thread pushes and pops at the bottom, LIFO, without locking;
+// any thread may steal from the top, FIFO, with a single CAS.
+// There's no growth: push() fails when full, so the caller needs a fallback queue.
+// Slots are atomics so that a thief reading a slot the owner is rewriting is not a data
+// race; such a thief always loses the CAS on top and discards what it read.
+template <typename T, uint32_t CAPACITY = 1024>
+class WorkStealingDeque {
+	static_assert(CAPACITY && !(CAPACITY & (CAPACITY - 1)), "Capacity must be a power of two.");
+	static const uint32_t MASK = CAPACITY - 1;
+
+	// Padded apart, since thieves hammer top while the owner moves bottom. Padding rather than
+	// alignas, because the deque lives in containers that don't honor over-alignment.
+	std::atomic<int64_t> top = { 0 };
+	uint8_t top_padding[64 - sizeof(std::atomic<int64_t>)];
+	std::atomic<int64_t> bottom = { 0 };
+	uint8_t bottom_padding[64 - sizeof(std::atomic<int64_t>)];
+	std::atomic<T> buffer[CAPACITY];
+
+public:
+	// Owner only.
+	bool push(T p_value) {
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_acquire);
+		if (b - t >= (int64_t)CAPACITY) {
+			return false;
+		}
+		buffer[b & MASK].store(p_value, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Owner only. Takes the most recently pushed element.
+	bool pop(T &r_value) {
+		int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			// Empty.
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		r_value = buffer[b & MASK].load(std::memory_order_relaxed);
+		if (t == b) {
+			// Last element: race thieves for it.
+			bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	// Any thread. Takes the oldest element. Fails both when empty and when another
+	// thread won the race for the element; use is_empty() to tell them apart.
+	bool steal(T &r_value) {
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t b = bottom.load(std::memory_order_acquire);
+		if (t >= b) {
+			return false;
+		}
+
+		T value = buffer[t & MASK].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return false;
+		}
+		r_value = value;
+		return true;
+	}
+
+	// Exact for the owner; a snapshot that may already be stale for other threads.
+	bool is_empty() const {
+		return bottom.load(std::memory_order_acquire) <= top.load(std::memory_order_acquire);
+	}
+
+	uint32_t size() const {
+		int64_t count = bottom.load(std::memory_order_acquire) - top.load(std::memory_order_acquire);
+		return count > 0 ? (uint32_t)count : 0;
+	}
+
+	WorkStealingDeque() {
+		for (uint32_t i = 0; i < CAPACITY; i++) {
+			buffer[i].store(T(), std::memory_order_relaxed);
+		}
+	}
+};
+
+#endif // WORK_STEALING_DEQUE_H
@@ -1,18 +1,21 @@
 #include "doom_raycaster.h"
 #include "core/os/keyboard.h"
 #include "core/math/math_funcs.h"
+#include "core/config/engine.h"
+#include "core/os/os.h"
+#include "core/templates/hashfuncs.h"
+#include "core/io/dir_access.h"
 
 static const int RENDER_WIDTH = 1152;
 static const int RENDER_HEIGHT = 648;
 static const float SCALE = 0.20f;
 
-// these tables allow us to do lookups for all trig math, instead of computations
-static const float RAY_COS[RENDER_WIDTH] = {
-0.866025404f,0.866401201f,0.866776834f,0.867152300f,0.867527599f,0.867902729f,0.868277688f,0.868652475f,0.869027088f,0.869401527f,0.869775788f,0.870149872f,0.870523775f,0.870897498f,0.871271038f,0.871644393f,0.872017563f,0.872390545f,0.872763338f,0.873135941f,0.873508352f,0.873880569f,0.874252591f,0.874624417f,0.874996044f,0.875367472f,0.875738698f,0.876109721f,0.876480539f,0.876851152f,0.877221557f,0.877591752f,0.877961737f,0.878331510f,0.878701068f,0.879070410f,0.879439536f,0.879808442f,0.880177129f,0.880545593f,0.880913833f,0.881281848f,0.881649636f,0.882017196f,0.882384525f,0.882751623f,0.883118487f,0.883485117f,0.883851509f,0.884217663f,0.884583577f,0.884949250f,0.885314679f,0.885679863f,0.886044801f,0.886409491f,0.886773930f,0.887138118f,0.887502053f,0.887865733f,0.888229156f,0.888592321f,0.888955225f,0.889317869f,0.889680249f,0.890042363f,0.890404212f,0.890765791f,0.891127101f,0.891488139f,0.891848903f,0.892209392f,0.892569604f,0.892929537f,0.893289190f,0.893648561f,0.894007649f,0.894366450f,0.894724964f,0.895083190f,0.895441124f,0.895798766f,0.896156114f,0.896513166f,0.896869921f,0.897226376f,0.897582529f,0.897938380f,0.898293926f,0.898649166f,0.899004097f,0.899358718f,0.899713028f,0.900067024f,0.900420705f,0.900774069f,0.901127114f,0.901479838f,0.901832240f,0.902184318f,0.902536070f,0.902887494f,0.903238589f,0.903589352f,0.903939782f,0.904289877f,0.904639636f,0.904989056f,0.905338136f,0.905686873f,0.906035267f,0.906383315f,0.906731015f,0.907078366f,0.907425366f,0.907772012f,0.908118304f,0.908464239f,0.908809816f,0.909155032f,0.909499886f,0.909844376f,0.910188501f,0.910532257f,0.910875644f,0.911218660f,0.911561303f,0.911903570f,0.912245461f,0.912586973f,0.912928104f,0.913268853f,0.913609217f,0.913949195f,0.914288786f,0.914627986f,0.914966795f,0.915305210f,0.915643229f,0.915980851f,0.916318074f,0.916654896f,0.916991314f,0.917327328f,0.917662935f,0.917998134f,0.918332922f,0.918667298f,0.919001259f,0.919334804f,0.919667931f,0.920000638f,0.920332923f,0.920664785f,0.920996221f,0.921327229f,0.921657808f,0.921987956f,0.922317670f,0.922646949f,0.922975792f,0.923304195f,0.923632157f,0.923959677f,0.924286752f,0.924613380f,0.924939560f,0.925265290f,0.925590567f,0.925915390f,0.926239757f,0.926563666f,0.926887114f,0.927210101f,0.927532624f,0.927854681f,0.928176271f,0.928497391f,0.928818039f,0.929138214f,0.929457914f,0.929777136f,0.930095879f,0.930414141f,0.930731920f,0.931049213f,0.931366020f,0.931682338f,0.931998165f,0.932313499f,0.932628338f,0.932942681f,0.933256525f,0.933569869f,0.933882710f,0.934195047f,0.934506877f,0.934818200f,0.935129011f,0.935439311f,0.935749097f,0.936058367f,0.936367118f,0.936675350f,0.936983060f,0.937290246f,0.937596906f,0.937903038f,0.938208641f,0.938513712f,0.938818250f,0.939122252f,0.939425717f,0.939728642f,0.940031026f,0.940332867f,0.940634162f,0.940934910f,0.941235109f,0.941534758f,0.941833853f,0.942132393f,0.942430376f,0.942727800f,0.943024664f,0.943320965f,0.943616701f,0.943911871f,0.944206472f,0.944500502f,0.944793960f,0.945086844f,0.945379151f,0.945670880f,0.945962029f,0.946252595f,0.946542578f,0.946831974f,0.947120783f,0.947409001f,0.947696628f,0.947983661f,0.948270098f,0.948555937f,0.948841177f,0.949125815f,0.949409850f,0.949693279f,0.949976101f,0.950258314f,0.950539916f,0.950820904f,0.951101277f,0.951381034f,0.951660171f,0.951938688f,0.952216581f,0.952493851f,0.952770493f,0.953046507f,0.953321891f,0.953596642f,0.953870759f,0.954144239f,0.954417082f,0.954689284f,0.954960845f,0.955231762f,0.955502033f,0.955771656f,0.956040630f,0.956308952f,0.956576621f,0.956843635f,0.957109992f,0.957375689f,0.957640726f,0.957905099f,0.958168808f,0.958431851f,0.958694225f,0.958955928f,0.959216959f,0.959477316f,0.959736997f,0.959996000f,0.960254323f,0.960511965f,0.960768923f,0.961025195f,0.961280781f,0.961535677f,0.961789882f,0.962043395f,0.962296212f,0.962548333f,0.962799756f,0.963050478f,0.963300499f,0.963549815f,0.963798425f,0.964046328f,0.964293522f,0.964540004f,0.964785773f,0.965030827f,0.965275164f,0.965518782f,0.965761680f,0.966003856f,0.966245308f,0.966486034f,0.966726032f,0.966965301f,0.967203838f,0.967441642f,0.967678712f,0.967915045f,0.968150639f,0.968385493f,0.968619605f,0.968852973f,0.969085595f,0.969317470f,0.969548596f,0.969778971f,0.970008593f,0.970237461f,0.970465573f,0.970692926f,0.970919520f,0.971145353f,0.971370422f,0.971594726f,0.971818264f,0.972041034f,0.972263033f,0.972484260f,0.972704714f,0.972924392f,0.973143294f,0.973361417f,0.973578759f,0.973795319f,0.974011096f,0.974226087f,0.974440291f,0.974653706f,0.974866330f,0.975078162f,0.975289200f,0.975499443f,0.975708889f,0.975917535f,0.976125381f,0.976332425f,0.976538665f,0.976744100f,0.976948728f,0.977152546f,0.977355555f,0.977557751f,0.977759134f,0.977959702f,0.978159453f,0.978358385f,0.978556498f,0.978753788f,0.978950256f,0.979145899f,0.979340715f,0.979534704f,0.979727863f,0.979920191f,0.980111686f,0.980302347f,0.980492173f,0.980681161f,0.980869310f,0.981056619f,0.981243086f,0.981428710f,0.981613489f,0.981797422f,0.981980506f,0.982162741f,0.982344125f,0.982524657f,0.982704335f,0.982883158f,0.983061123f,0.983238231f,0.983414478f,0.983589864f,0.983764388f,0.983938048f,0.984110842f,0.984282769f,0.984453827f,0.984624016f,0.984793333f,0.984961778f,0.985129349f,0.985296044f,0.985461863f,0.985626803f,0.985790863f,0.985954043f,0.986116340f,0.986277753f,0.986438282f,0.986597924f,0.986756678f,0.986914543f,0.987071518f,0.987227600f,0.987382790f,0.987537086f,0.987690485f,0.987842988f,0.987994592f,0.988145297f,0.988295101f,0.988444003f,0.988592002f,0.988739096f,0.988885283f,0.989030564f,0.989174937f,0.989318400f,0.989460952f,0.989602592f,0.989743319f,0.989883131f,0.990022028f,0.990160007f,0.990297069f,0.990433212f,0.990568434f,0.990702735f,0.990836113f,0.990968567f,0.991100096f,0.991230699f,0.991360375f,0.991489123f,0.991616941f,0.991743828f,0.991869784f,0.991994807f,0.992118896f,0.992242050f,0.992364269f,0.992485550f,0.992605893f,0.992725297f,0.992843761f,0.992961284f,0.993077864f,0.993193501f,0.993308194f,0.993421942f,0.993534743f,0.993646597f,0.993757503f,0.993867460f,0.993976467f,0.994084522f,0.994191626f,0.994297776f,0.994402973f,0.994507214f,0.994610501f,0.994712830f,0.994814202f,0.994914615f,0.995014069f,0.995112563f,0.995210096f,0.995306666f,0.995402274f,0.995496919f,0.995590599f,0.995683314f,0.995775062f,0.995865844f,0.995955658f,0.996044503f,0.996132379f,0.996219285f,0.996305220f,0.996390184f,0.996474175f,0.996557193f,0.996639237f,0.996720307f,0.996800401f,0.996879520f,0.996957661f,0.997034826f,0.997111012f,0.997186219f,0.997260447f,0.997333695f,0.997405962f,0.997477248f,0.997547551f,0.997616872f,0.997685210f,0.997752564f,0.997818933f,0.997884317f,0.997948716f,0.998012128f,0.998074554f,0.998135992f,0.998196442f,0.998255904f,0.998314376f,0.998371860f,0.998428353f,0.998483855f,0.998538367f,0.998591887f,0.998644415f,0.998695951f,0.998746493f,0.998796043f,0.998844598f,0.998892159f,0.998938726f,0.998984297f,0.999028873f,0.999072453f,0.999115036f,0.999156623f,0.999197213f,0.999236805f,0.999275399f,0.999312996f,0.999349593f,0.999385192f,0.999419792f,0.999453393f,0.999485993f,0.999517594f,0.999548194f,0.999577794f,0.999606392f,0.999633990f,0.999660586f,0.999686181f,0.999710774f,0.999734364f,0.999756953f,0.999778539f,0.999799122f,0.999818702f,0.999837279f,0.999854853f,0.999871424f,0.999886991f,0.999901555f,0.999915114f,0.999927670f,0.999939222f,0.999949769f,0.999959312f,0.999967851f,0.999975386f,0.999981916f,0.999987442f,0.999991963f,0.999995479f,0.999997991f,0.999999498f,1.000000000f,0.999999498f,0.999997991f,0.999995479f,0.999991963f,0.999987442f,0.999981916f,0.999975386f,0.999967851f,0.999959312f,0.999949769f,0.999939222f,0.999927670f,0.999915114f,0.999901555f,0.999886991f,0.999871424f,0.999854853f,0.999837279f,0.999818702f,0.999799122f,0.999778539f,0.999756953f,0.999734364f,0.999710774f,0.999686181f,0.999660586f,0.999633990f,0.999606392f,0.999577794f,0.999548194f,0.999517594f,0.999485993f,0.999453393f,0.999419792f,0.999385192f,0.999349593f,0.999312996f,0.999275399f,0.999236805f,0.999197213f,0.999156623f,0.999115036f,0.999072453f,0.999028873f,0.998984297f,0.998938726f,0.998892159f,0.998844598f,0.998796043f,0.998746493f,0.998695951f,0.998644415f,0.998591887f,0.998538367f,0.998483855f,0.998428353f,0.998371860f,0.998314376f,0.998255904f,0.998196442f,0.998135992f,0.998074554f,0.998012128f,0.997948716f,0.997884317f,0.997818933f,0.997752564f,0.997685210f,0.997616872f,0.997547551f,0.997477248f,0.997405962f,0.997333695f,0.997260447f,0.997186219f,0.997111012f,0.997034826f,0.996957661f,0.996879520f,0.996800401f,0.996720307f,0.996639237f,0.996557193f,0.996474175f,0.996390184f,0.996305220f,0.996219285f,0.996132379f,0.996044503f,0.995955658f,0.995865844f,0.995775062f,0.995683314f,0.995590599f,0.995496919f,0.995402274f,0.995306666f,0.995210096f,0.995112563f,0.995014069f,0.994914615f,0.994814202f,0.994712830f,0.994610501f,0.994507214f,0.994402973f,0.994297776f,0.994191626f,0.994084522f,0.993976467f,0.993867460f,0.993757503f,0.993646597f,0.993534743f,0.993421942f,0.993308194f,0.993193501f,0.993077864f,0.992961284f,0.992843761f,0.992725297f,0.992605893f,0.992485550f,0.992364269f,0.992242050f,0.992118896f,0.991994807f,0.991869784f,0.991743828f,0.991616941f,0.991489123f,0.991360375f,0.991230699f,0.991100096f,0.990968567f,0.990836113f,0.990702735f,0.990568434f,0.990433212f,0.990297069f,0.990160007f,0.990022028f,0.989883131f,0.989743319f,0.989602592f,0.989460952f,0.989318400f,0.989174937f,0.989030564f,0.988885283f,0.988739096f,0.988592002f,0.988444003f,0.988295101f,0.988145297f,0.987994592f,0.987842988f,0.987690485f,0.987537086f,0.987382790f,0.987227600f,0.987071518f,0.986914543f,0.986756678f,0.986597924f,0.986438282f,0.986277753f,0.986116340f,0.985954043f,0.985790863f,0.985626803f,0.985461863f,0.985296044f,0.985129349f,0.984961778f,0.984793333f,0.984624016f,0.984453827f,0.984282769f,0.984110842f,0.983938048f,0.983764388f,0.983589864f,0.983414478f,0.983238231f,0.983061123f,0.982883158f,0.982704335f,0.982524657f,0.982344125f,0.982162741f,0.981980506f,0.981797422f,0.981613489f,0.981428710f,0.981243086f,0.981056619f,0.980869310f,0.980681161f,0.980492173f,0.980302347f,0.980111686f,0.979920191f,0.979727863f,0.979534704f,0.979340715f,0.979145899f,0.978950256f,0.978753788f,0.978556498f,0.978358385f,0.978159453f,0.977959702f,0.977759134f,0.977557751f,0.977355555f,0.977152546f,0.976948728f,0.976744100f,0.976538665f,0.976332425f,0.976125381f,0.975917535f,0.975708889f,0.975499443f,0.975289200f,0.975078162f,0.974866330f,0.974653706f,0.974440291f,0.974226087f,0.974011096f,0.973795319f,0.973578759f,0.973361417f,0.973143294f,0.972924392f,0.972704714f,0.972484260f,0.972263033f,0.972041034f,0.971818264f,0.971594726f,0.971370422f,0.971145353f,0.970919520f,0.970692926f,0.970465573f,0.970237461f,0.970008593f,0.969778971f,0.969548596f,0.969317470f,0.969085595f,0.968852973f,0.968619605f,0.968385493f,0.968150639f,0.967915045f,0.967678712f,0.967441642f,0.967203838f,0.966965301f,0.966726032f,0.966486034f,0.966245308f,0.966003856f,0.965761680f,0.965518782f,0.965275164f,0.965030827f,0.964785773f,0.964540004f,0.964293522f,0.964046328f,0.963798425f,0.963549815f,0.963300499f,0.963050478f,0.962799756f,0.962548333f,0.962296212f,0.962043395f,0.961789882f,0.961535677f,0.961280781f,0.961025195f,0.960768923f,0.960511965f,0.960254323f,0.959996000f,0.959736997f,0.959477316f,0.959216959f,0.958955928f,0.958694225f,0.958431851f,0.958168808f,0.957905099f,0.957640726f,0.957375689f,0.957109992f,0.956843635f,0.956576621f,0.956308952f,0.956040630f,0.955771656f,0.955502033f,0.955231762f,0.954960845f,0.954689284f,0.954417082f,0.954144239f,0.953870759f,0.953596642f,0.953321891f,0.953046507f,0.952770493f,0.952493851f,0.952216581f,0.951938688f,0.951660171f,0.951381034f,0.951101277f,0.950820904f,0.950539916f,0.950258314f,0.949976101f,0.949693279f,0.949409850f,0.949125815f,0.948841177f,0.948555937f,0.948270098f,0.947983661f,0.947696628f,0.947409001f,0.947120783f,0.946831974f,0.946542578f,0.946252595f,0.945962029f,0.945670880f,0.945379151f,0.945086844f,0.944793960f,0.944500502f,0.944206472f,0.943911871f,0.943616701f,0.943320965f,0.943024664f,0.942727800f,0.942430376f,0.942132393f,0.941833853f,0.941534758f,0.941235109f,0.940934910f,0.940634162f,0.940332867f,0.940031026f,0.939728642f,0.939425717f,0.939122252f,0.938818250f,0.938513712f,0.938208641f,0.937903038f,0.937596906f,0.937290246f,0.936983060f,0.936675350f,0.936367118f,0.936058367f,0.935749097f,0.935439311f,0.935129011f,0.934818200f,0.934506877f,0.934195047f,0.933882710f,0.933569869f,0.933256525f,0.932942681f,0.932628338f,0.932313499f,0.931998165f,0.931682338f,0.931366020f,0.931049213f,0.930731920f,0.930414141f,0.930095879f,0.929777136f,0.929457914f,0.929138214f,0.928818039f,0.928497391f,0.928176271f,0.927854681f,0.927532624f,0.927210101f,0.926887114f,0.926563666f,0.926239757f,0.925915390f,0.925590567f,0.925265290f,0.924939560f,0.924613380f,0.924286752f,0.923959677f,0.923632157f,0.923304195f,0.922975792f,0.922646949f,0.922317670f,0.921987956f,0.921657808f,0.921327229f,0.920996221f,0.920664785f,0.920332923f,0.920000638f,0.919667931f,0.919334804f,0.919001259f,0.918667298f,0.918332922f,0.917998134f,0.917662935f,0.917327328f,0.916991314f,0.916654896f,0.916318074f,0.915980851f,0.915643229f,0.915305210f,0.914966795f,0.914627986f,0.914288786f,0.913949195f,0.913609217f,0.913268853f,0.912928104f,0.912586973f,0.912245461f,0.911903570f,0.911561303f,0.911218660f,0.910875644f,0.910532257f,0.910188501f,0.909844376f,0.909499886f,0.909155032f,0.908809816f,0.908464239f,0.908118304f,0.907772012f,0.907425366f,0.907078366f,0.906731015f,0.906383315f,0.906035267f,0.905686873f,0.905338136f,0.904989056f,0.904639636f,0.904289877f,0.903939782f,0.903589352f,0.903238589f,0.902887494f,0.902536070f,0.902184318f,0.901832240f,0.901479838f,0.901127114f,0.900774069f,0.900420705f,0.900067024f,0.899713028f,0.899358718f,0.899004097f,0.898649166f,0.898293926f,0.897938380f,0.897582529f,0.897226376f,0.896869921f,0.896513166f,0.896156114f,0.895798766f,0.895441124f,0.895083190f,0.894724964f,0.894366450f,0.894007649f,0.893648561f,0.893289190f,0.892929537f,0.892569604f,0.892209392f,0.891848903f,0.891488139f,0.891127101f,0.890765791f,0.890404212f,0.890042363f,0.889680249f,0.889317869f,0.888955225f,0.888592321f,0.888229156f,0.887865733f,0.887502053f,0.887138118f,0.886773930f,0.886409491f,0.886044801f,0.885679863f,0.885314679f,0.884949250f,0.884583577f,0.884217663f,0.883851509f,0.883485117f,0.883118487f,0.882751623f,0.882384525f,0.882017196f,0.881649636f,0.881281848f,0.880913833f,0.880545593f,0.880177129f,0.879808442f,0.879439536f,0.879070410f,0.878701068f,0.878331510f,0.877961737f,0.877591752f,0.877221557f,0.876851152f,0.876480539f,0.876109721f,0.875738698f,0.875367472f,0.874996044f,0.874624417f,0.874252591f,0.873880569f,0.873508352f,0.873135941f,0.872763338f,0.872390545f,0.872017563f,0.871644393f,0.871271038f,0.870897498f,0.870523775f,0.870149872f,0.869775788f,0.869401527f,0.869027088f,0.868652475f,0.868277688f,0.867902729f,0.867527599f,0.867152300f,0.866776834f,0.866401201f,};
-
-static const float RAY_SIN[RENDER_WIDTH] = {
--0.500000000f,-0.499348534f,-0.498696221f,-0.498043059f,-0.497389048f,-0.496734188f,-0.496078478f,-0.495421919f,-0.494764509f,-0.494106249f,-0.493447138f,-0.492787176f,-0.492126362f,-0.491464697f,-0.490802179f,-0.490138809f,-0.489474586f,-0.488809510f,-0.488143581f,-0.487476798f,-0.486809161f,-0.486140670f,-0.485471324f,-0.484801124f,-0.484130068f,-0.483458157f,-0.482785391f,-0.482111768f,-0.481437290f,-0.480761955f,-0.480085763f,-0.479408715f,-0.478730809f,-0.478052047f,-0.477372426f,-0.476691948f,-0.476010612f,-0.475328418f,-0.474645365f,-0.473961453f,-0.473276683f,-0.472591054f,-0.471904565f,-0.471217218f,-0.470529010f,-0.469839943f,-0.469150016f,-0.468459229f,-0.467767581f,-0.467075073f,-0.466381705f,-0.465687476f,-0.464992386f,-0.464296435f,-0.463599623f,-0.462901950f,-0.462203415f,-0.461504019f,-0.460803761f,-0.460102642f,-0.459400661f,-0.458697818f,-0.457994113f,-0.457289546f,-0.456584116f,-0.455877825f,-0.455170671f,-0.454462655f,-0.453753777f,-0.453044036f,-0.452333433f,-0.451621967f,-0.450909638f,-0.450196447f,-0.449482394f,-0.448767477f,-0.448051698f,-0.447335057f,-0.446617552f,-0.445899185f,-0.445179956f,-0.444459863f,-0.443738908f,-0.443017091f,-0.442294410f,-0.441570868f,-0.440846462f,-0.440121195f,-0.439395064f,-0.438668072f,-0.437940217f,-0.437211500f,-0.436481921f,-0.435751480f,-0.435020177f,-0.434288012f,-0.433554985f,-0.432821096f,-0.432086346f,-0.431350735f,-0.430614262f,-0.429876928f,-0.429138733f,-0.428399677f,-0.427659760f,-0.426918983f,-0.426177345f,-0.425434847f,-0.424691488f,-0.423947270f,-0.423202192f,-0.422456254f,-0.421709458f,-0.420961801f,-0.420213286f,-0.419463912f,-0.418713680f,-0.417962589f,-0.417210641f,-0.416457834f,-0.415704170f,-0.414949648f,-0.414194270f,-0.413438035f,-0.412680943f,-0.411922994f,-0.411164190f,-0.410404530f,-0.409644015f,-0.408882645f,-0.408120420f,-0.407357340f,-0.406593407f,-0.405828619f,-0.405062978f,-0.404296484f,-0.403529137f,-0.402760938f,-0.401991887f,-0.401221984f,-0.400451230f,-0.399679624f,-0.398907169f,-0.398133863f,-0.397359707f,-0.396584702f,-0.395808848f,-0.395032146f,-0.394254596f,-0.393476198f,-0.392696953f,-0.391916861f,-0.391135923f,-0.390354139f,-0.389571510f,-0.388788036f,-0.388003717f,-0.387218555f,-0.386432549f,-0.385645701f,-0.384858010f,-0.384069478f,-0.383280104f,-0.382489889f,-0.381698834f,-0.380906940f,-0.380114206f,-0.379320634f,-0.378526224f,-0.377730976f,-0.376934892f,-0.376137972f,-0.375340215f,-0.374541624f,-0.373742199f,-0.372941940f,-0.372140847f,-0.371338922f,-0.370536165f,-0.369732578f,-0.368928159f,-0.368122911f,-0.367316833f,-0.366509927f,-0.365702193f,-0.364893632f,-0.364084244f,-0.363274031f,-0.362462993f,-0.361651130f,-0.360838444f,-0.360024935f,-0.359210604f,-0.358395452f,-0.357579479f,-0.356762686f,-0.355945075f,-0.355126645f,-0.354307397f,-0.353487333f,-0.352666454f,-0.351844759f,-0.351022250f,-0.350198928f,-0.349374793f,-0.348549847f,-0.347724090f,-0.346897522f,-0.346070146f,-0.345241962f,-0.344412970f,-0.343583172f,-0.342752568f,-0.341921160f,-0.341088948f,-0.340255933f,-0.339422117f,-0.338587499f,-0.337752082f,-0.336915865f,-0.336078851f,-0.335241039f,-0.334402432f,-0.333563029f,-0.332722832f,-0.331881842f,-0.331040060f,-0.330197487f,-0.329354124f,-0.328509972f,-0.327665032f,-0.326819305f,-0.325972792f,-0.325125494f,-0.324277413f,-0.323428549f,-0.322578903f,-0.321728477f,-0.320877271f,-0.320025288f,-0.319172527f,-0.318318990f,-0.317464678f,-0.316609593f,-0.315753735f,-0.314897106f,-0.314039706f,-0.313181537f,-0.312322601f,-0.311462898f,-0.310602429f,-0.309741196f,-0.308879200f,-0.308016443f,-0.307152924f,-0.306288647f,-0.305423611f,-0.304557818f,-0.303691270f,-0.302823968f,-0.301955912f,-0.301087105f,-0.300217547f,-0.299347241f,-0.298476186f,-0.297604385f,-0.296731839f,-0.295858549f,-0.294984517f,-0.294109743f,-0.293234230f,-0.292357978f,-0.291480990f,-0.290603265f,-0.289724807f,-0.288845616f,-0.287965693f,-0.287085041f,-0.286203659f,-0.285321551f,-0.284438717f,-0.283555159f,-0.282670878f,-0.281785876f,-0.280900154f,-0.280013714f,-0.279126557f,-0.278238684f,-0.277350098f,-0.276460800f,-0.275570790f,-0.274680072f,-0.273788646f,-0.272896513f,-0.272003676f,-0.271110136f,-0.270215895f,-0.269320954f,-0.268425314f,-0.267528978f,-0.266631947f,-0.265734222f,-0.264835806f,-0.263936699f,-0.263036904f,-0.262136422f,-0.261235254f,-0.260333403f,-0.259430870f,-0.258527657f,-0.257623766f,-0.256719197f,-0.255813953f,-0.254908036f,-0.254001448f,-0.253094189f,-0.252186262f,-0.251277668f,-0.250368410f,-0.249458489f,-0.248547906f,-0.247636664f,-0.246724765f,-0.245812209f,-0.244899000f,-0.243985138f,-0.243070626f,-0.242155465f,-0.241239658f,-0.240323205f,-0.239406109f,-0.238488372f,-0.237569996f,-0.236650982f,-0.235731333f,-0.234811050f,-0.233890135f,-0.232968590f,-0.232046417f,-0.231123618f,-0.230200195f,-0.229276149f,-0.228351483f,-0.227426199f,-0.226500298f,-0.225573783f,-0.224646656f,-0.223718918f,-0.222790571f,-0.221861618f,-0.220932061f,-0.220001901f,-0.219071140f,-0.218139781f,-0.217207826f,-0.216275277f,-0.215342135f,-0.214408402f,-0.213474082f,-0.212539175f,-0.211603685f,-0.210667612f,-0.209730960f,-0.208793730f,-0.207855924f,-0.206917545f,-0.205978594f,-0.205039074f,-0.204098987f,-0.203158335f,-0.202217120f,-0.201275344f,-0.200333010f,-0.199390119f,-0.198446675f,-0.197502678f,-0.196558132f,-0.195613038f,-0.194667399f,-0.193721217f,-0.192774493f,-0.191827232f,-0.190879433f,-0.189931101f,-0.188982237f,-0.188032843f,-0.187082921f,-0.186132475f,-0.185181505f,-0.184230016f,-0.183278008f,-0.182325484f,-0.181372446f,-0.180418897f,-0.179464839f,-0.178510275f,-0.177555206f,-0.176599635f,-0.175643565f,-0.174686997f,-0.173729935f,-0.172772380f,-0.171814335f,-0.170855802f,-0.169896784f,-0.168937283f,-0.167977301f,-0.167016841f,-0.166055906f,-0.165094497f,-0.164132617f,-0.163170269f,-0.162207455f,-0.161244178f,-0.160280439f,-0.159316242f,-0.158351589f,-0.157386482f,-0.156420924f,-0.155454917f,-0.154488464f,-0.153521567f,-0.152554229f,-0.151586453f,-0.150618240f,-0.149649594f,-0.148680517f,-0.147711011f,-0.146741079f,-0.145770724f,-0.144799948f,-0.143828753f,-0.142857143f,-0.141885119f,-0.140912685f,-0.139939843f,-0.138966596f,-0.137992945f,-0.137018895f,-0.136044447f,-0.135069603f,-0.134094368f,-0.133118742f,-0.132142730f,-0.131166333f,-0.130189554f,-0.129212396f,-0.128234861f,-0.127256953f,-0.126278673f,-0.125300024f,-0.124321010f,-0.123341633f,-0.122361895f,-0.121381799f,-0.120401348f,-0.119420544f,-0.118439391f,-0.117457891f,-0.116476046f,-0.115493860f,-0.114511335f,-0.113528474f,-0.112545279f,-0.111561754f,-0.110577900f,-0.109593722f,-0.108609221f,-0.107624401f,-0.106639263f,-0.105653811f,-0.104668048f,-0.103681977f,-0.102695599f,-0.101708919f,-0.100721938f,-0.099734660f,-0.098747087f,-0.097759222f,-0.096771069f,-0.095782629f,-0.094793905f,-0.093804901f,-0.092815619f,-0.091826063f,-0.090836234f,-0.089846135f,-0.088855771f,-0.087865143f,-0.086874254f,-0.085883107f,-0.084891705f,-0.083900051f,-0.082908147f,-0.081915997f,-0.080923604f,-0.079930969f,-0.078938097f,-0.077944990f,-0.076951651f,-0.075958083f,-0.074964288f,-0.073970270f,-0.072976031f,-0.071981575f,-0.070986904f,-0.069992021f,-0.068996930f,-0.068001632f,-0.067006131f,-0.066010430f,-0.065014532f,-0.064018440f,-0.063022156f,-0.062025684f,-0.061029026f,-0.060032186f,-0.059035166f,-0.058037969f,-0.057040599f,-0.056043058f,-0.055045349f,-0.054047475f,-0.053049439f,-0.052051244f,-0.051052893f,-0.050054389f,-0.049055734f,-0.048056933f,-0.047057988f,-0.046058901f,-0.045059676f,-0.044060316f,-0.043060823f,-0.042061202f,-0.041061453f,-0.040061582f,-0.039061590f,-0.038061481f,-0.037061257f,-0.036060922f,-0.035060479f,-0.034059930f,-0.033059279f,-0.032058528f,-0.031057681f,-0.030056741f,-0.029055710f,-0.028054591f,-0.027053388f,-0.026052104f,-0.025050742f,-0.024049304f,-0.023047793f,-0.022046213f,-0.021044567f,-0.020042857f,-0.019041087f,-0.018039260f,-0.017037378f,-0.016035445f,-0.015033464f,-0.014031438f,-0.013029369f,-0.012027261f,-0.011025116f,-0.010022939f,-0.009020731f,-0.008018496f,-0.007016237f,-0.006013957f,-0.005011658f,-0.004009345f,-0.003007019f,-0.002004684f,-0.001002344f,0.000000000f,0.001002344f,0.002004684f,0.003007019f,0.004009345f,0.005011658f,0.006013957f,0.007016237f,0.008018496f,0.009020731f,0.010022939f,0.011025116f,0.012027261f,0.013029369f,0.014031438f,0.015033464f,0.016035445f,0.017037378f,0.018039260f,0.019041087f,0.020042857f,0.021044567f,0.022046213f,0.023047793f,0.024049304f,0.025050742f,0.026052104f,0.027053388f,0.028054591f,0.029055710f,0.030056741f,0.031057681f,0.032058528f,0.033059279f,0.034059930f,0.035060479f,0.036060922f,0.037061257f,0.038061481f,0.039061590f,0.040061582f,0.041061453f,0.042061202f,0.043060823f,0.044060316f,0.045059676f,0.046058901f,0.047057988f,0.048056933f,0.049055734f,0.050054389f,0.051052893f,0.052051244f,0.053049439f,0.054047475f,0.055045349f,0.056043058f,0.057040599f,0.058037969f,0.059035166f,0.060032186f,0.061029026f,0.062025684f,0.063022156f,0.064018440f,0.065014532f,0.066010430f,0.067006131f,0.068001632f,0.068996930f,0.069992021f,0.070986904f,0.071981575f,0.072976031f,0.073970270f,0.074964288f,0.075958083f,0.076951651f,0.077944990f,0.078938097f,0.079930969f,0.080923604f,0.081915997f,0.082908147f,0.083900051f,0.084891705f,0.085883107f,0.086874254f,0.087865143f,0.088855771f,0.089846135f,0.090836234f,0.091826063f,0.092815619f,0.093804901f,0.094793905f,0.095782629f,0.096771069f,0.097759222f,0.098747087f,0.099734660f,0.100721938f,0.101708919f,0.102695599f,0.103681977f,0.104668048f,0.105653811f,0.106639263f,0.107624401f,0.108609221f,0.109593722f,0.110577900f,0.111561754f,0.112545279f,0.113528474f,0.114511335f,0.115493860f,0.116476046f,0.117457891f,0.118439391f,0.119420544f,0.120401348f,0.121381799f,0.122361895f,0.123341633f,0.124321010f,0.125300024f,0.126278673f,0.127256953f,0.128234861f,0.129212396f,0.130189554f,0.131166333f,0.132142730f,0.133118742f,0.134094368f,0.135069603f,0.136044447f,0.137018895f,0.137992945f,0.138966596f,0.139939843f,0.140912685f,0.141885119f,0.142857143f,0.143828753f,0.144799948f,0.145770724f,0.146741079f,0.147711011f,0.148680517f,0.149649594f,0.150618240f,0.151586453f,0.152554229f,0.153521567f,0.154488464f,0.155454917f,0.156420924f,0.157386482f,0.158351589f,0.159316242f,0.160280439f,0.161244178f,0.162207455f,0.163170269f,0.164132617f,0.165094497f,0.166055906f,0.167016841f,0.167977301f,0.168937283f,0.169896784f,0.170855802f,0.171814335f,0.172772380f,0.173729935f,0.174686997f,0.175643565f,0.176599635f,0.177555206f,0.178510275f,0.179464839f,0.180418897f,0.181372446f,0.182325484f,0.183278008f,0.184230016f,0.185181505f,0.186132475f,0.187082921f,0.188032843f,0.188982237f,0.189931101f,0.190879433f,0.191827232f,0.192774493f,0.193721217f,0.194667399f,0.195613038f,0.196558132f,0.197502678f,0.198446675f,0.199390119f,0.200333010f,0.201275344f,0.202217120f,0.203158335f,0.204098987f,0.205039074f,0.205978594f,0.206917545f,0.207855924f,0.208793730f,0.209730960f,0.210667612f,0.211603685f,0.212539175f,0.213474082f,0.214408402f,0.215342135f,0.216275277f,0.217207826f,0.218139781f,0.219071140f,0.220001901f,0.220932061f,0.221861618f,0.222790571f,0.223718918f,0.224646656f,0.225573783f,0.226500298f,0.227426199f,0.228351483f,0.229276149f,0.230200195f,0.231123618f,0.232046417f,0.232968590f,0.233890135f,0.234811050f,0.235731333f,0.236650982f,0.237569996f,0.238488372f,0.239406109f,0.240323205f,0.241239658f,0.242155465f,0.243070626f,0.243985138f,0.244899000f,0.245812209f,0.246724765f,0.247636664f,0.248547906f,0.249458489f,0.250368410f,0.251277668f,0.252186262f,0.253094189f,0.254001448f,0.254908036f,0.255813953f,0.256719197f,0.257623766f,0.258527657f,0.259430870f,0.260333403f,0.261235254f,0.262136422f,0.263036904f,0.263936699f,0.264835806f,0.265734222f,0.266631947f,0.267528978f,0.268425314f,0.269320954f,0.270215895f,0.271110136f,0.272003676f,0.272896513f,0.273788646f,0.274680072f,0.275570790f,0.276460800f,0.277350098f,0.278238684f,0.279126557f,0.280013714f,0.280900154f,0.281785876f,0.282670878f,0.283555159f,0.284438717f,0.285321551f,0.286203659f,0.287085041f,0.287965693f,0.288845616f,0.289724807f,0.290603265f,0.291480990f,0.292357978f,0.293234230f,0.294109743f,0.294984517f,0.295858549f,0.296731839f,0.297604385f,0.298476186f,0.299347241f,0.300217547f,0.301087105f,0.301955912f,0.302823968f,0.303691270f,0.304557818f,0.305423611f,0.306288647f,0.307152924f,0.308016443f,0.308879200f,0.309741196f,0.310602429f,0.311462898f,0.312322601f,0.313181537f,0.314039706f,0.314897106f,0.315753735f,0.316609593f,0.317464678f,0.318318990f,0.319172527f,0.320025288f,0.320877271f,0.321728477f,0.322578903f,0.323428549f,0.324277413f,0.325125494f,0.325972792f,0.326819305f,0.327665032f,0.328509972f,0.329354124f,0.330197487f,0.331040060f,0.331881842f,0.332722832f,0.333563029f,0.334402432f,0.335241039f,0.336078851f,0.336915865f,0.337752082f,0.338587499f,0.339422117f,0.340255933f,0.341088948f,0.341921160f,0.342752568f,0.343583172f,0.344412970f,0.345241962f,0.346070146f,0.346897522f,0.347724090f,0.348549847f,0.349374793f,0.350198928f,0.351022250f,0.351844759f,0.352666454f,0.353487333f,0.354307397f,0.355126645f,0.355945075f,0.356762686f,0.357579479f,0.358395452f,0.359210604f,0.360024935f,0.360838444f,0.361651130f,0.362462993f,0.363274031f,0.364084244f,0.364893632f,0.365702193f,0.366509927f,0.367316833f,0.368122911f,0.368928159f,0.369732578f,0.370536165f,0.371338922f,0.372140847f,0.372941940f,0.373742199f,0.374541624f,0.375340215f,0.376137972f,0.376934892f,0.377730976f,0.378526224f,0.379320634f,0.380114206f,0.380906940f,0.381698834f,0.382489889f,0.383280104f,0.384069478f,0.384858010f,0.385645701f,0.386432549f,0.387218555f,0.388003717f,0.388788036f,0.389571510f,0.390354139f,0.391135923f,0.391916861f,0.392696953f,0.393476198f,0.394254596f,0.395032146f,0.395808848f,0.396584702f,0.397359707f,0.398133863f,0.398907169f,0.399679624f,0.400451230f,0.401221984f,0.401991887f,0.402760938f,0.403529137f,0.404296484f,0.405062978f,0.405828619f,0.406593407f,0.407357340f,0.408120420f,0.408882645f,0.409644015f,0.410404530f,0.411164190f,0.411922994f,0.412680943f,0.413438035f,0.414194270f,0.414949648f,0.415704170f,0.416457834f,0.417210641f,0.417962589f,0.418713680f,0.419463912f,0.420213286f,0.420961801f,0.421709458f,0.422456254f,0.423202192f,0.423947270f,0.424691488f,0.425434847f,0.426177345f,0.426918983f,0.427659760f,0.428399677f,0.429138733f,0.429876928f,0.430614262f,0.431350735f,0.432086346f,0.432821096f,0.433554985f,0.434288012f,0.435020177f,0.435751480f,0.436481921f,0.437211500f,0.437940217f,0.438668072f,0.439395064f,0.440121195f,0.440846462f,0.441570868f,0.442294410f,0.443017091f,0.443738908f,0.444459863f,0.445179956f,0.445899185f,0.446617552f,0.447335057f,0.448051698f,0.448767477f,0.449482394f,0.450196447f,0.450909638f,0.451621967f,0.452333433f,0.453044036f,0.453753777f,0.454462655f,0.455170671f,0.455877825f,0.456584116f,0.457289546f,0.457994113f,0.458697818f,0.459400661f,0.460102642f,0.460803761f,0.461504019f,0.462203415f,0.462901950f,0.463599623f,0.464296435f,0.464992386f,0.465687476f,0.466381705f,0.467075073f,0.467767581f,0.468459229f,0.469150016f,0.469839943f,0.470529010f,0.471217218f,0.471904565f,0.472591054f,0.473276683f,0.473961453f,0.474645365f,0.475328418f,0.476010612f,0.476691948f,0.477372426f,0.478052047f,0.478730809f,0.479408715f,0.480085763f,0.480761955f,0.481437290f,0.482111768f,0.482785391f,0.483458157f,0.484130068f,0.484801124f,0.485471324f,0.486140670f,0.486809161f,0.487476798f,0.488143581f,0.488809510f,0.489474586f,0.490138809f,0.490802179f,0.491464697f,0.492126362f,0.492787176f,0.493447138f,0.494106249f,0.494764509f,0.495421919f,0.496078478f,0.496734188f,0.497389048f,0.498043059f,0.498696221f,0.499348534f,};
+// Replay files: header (magic, version, tick length, start pose), then one record per physics tick
+static const char REPLAY_MAGIC[4] = { 'R', 'C', 'R', 'P' };
+static const uint32_t REPLAY_VERSION = 2;
+static const int REPLAY_TICK_SIZE = 13; // u8 buttons, float x, float y, float angle
 
+// these tables allow us to do lookups for all trig math, instead of computations
 static const float RAY_ANGLE[RENDER_WIDTH] = {
 -0.523598776f,-0.522846691f,-0.522093954f,-0.521340565f,-0.520586522f,-0.519831828f,-0.519076481f,-0.518320481f,-0.517563829f,-0.516806524f,-0.516048567f,-0.515289957f,-0.514530695f,-0.513770781f,-0.513010214f,-0.512248996f,-0.511487124f,-0.510724601f,-0.509961426f,-0.509197598f,-0.508433119f,-0.507667987f,-0.506902204f,-0.506135769f,-0.505368682f,-0.504600943f,-0.503832553f,-0.503063511f,-0.502293817f,-0.501523473f,-0.500752477f,-0.499980830f,-0.499208531f,-0.498435582f,-0.497661982f,-0.496887731f,-0.496112829f,-0.495337277f,-0.494561075f,-0.493784221f,-0.493006718f,-0.492228565f,-0.491449762f,-0.490670308f,-0.489890206f,-0.489109453f,-0.488328051f,-0.487546000f,-0.486763300f,-0.485979951f,-0.485195953f,-0.484411306f,-0.483626011f,-0.482840067f,-0.482053475f,-0.481266236f,-0.480478348f,-0.479689813f,-0.478900630f,-0.478110800f,-0.477320323f,-0.476529199f,-0.475737429f,-0.474945011f,-0.474151948f,-0.473358239f,-0.472563883f,-0.471768882f,-0.470973236f,-0.470176944f,-0.469380008f,-0.468582426f,-0.467784200f,-0.466985330f,-0.466185816f,-0.465385658f,-0.464584856f,-0.463783411f,-0.462981323f,-0.462178593f,-0.461375219f,-0.460571204f,-0.459766546f,-0.458961247f,-0.458155306f,-0.457348725f,-0.456541502f,-0.455733639f,-0.454925135f,-0.454115992f,-0.453306208f,-0.452495786f,-0.451684724f,-0.450873024f,-0.450060685f,-0.449247708f,-0.448434093f,-0.447619840f,-0.446804951f,-0.445989425f,-0.445173262f,-0.444356463f,-0.443539028f,-0.442720958f,-0.441902253f,-0.441082913f,-0.440262939f,-0.439442331f,-0.438621089f,-0.437799214f,-0.436976706f,-0.436153565f,-0.435329793f,-0.434505388f,-0.433680353f,-0.432854686f,-0.432028389f,-0.431201462f,-0.430373906f,-0.429545720f,-0.428716905f,-0.427887461f,-0.427057390f,-0.426226691f,-0.425395365f,-0.424563413f,-0.423730834f,-0.422897629f,-0.422063799f,-0.421229344f,-0.420394264f,-0.419558561f,-0.418722234f,-0.417885284f,-0.417047712f,-0.416209517f,-0.415370701f,-0.414531264f,-0.413691206f,-0.412850528f,-0.412009231f,-0.411167314f,-0.410324779f,-0.409481626f,-0.408637855f,-0.407793467f,-0.406948463f,-0.406102843f,-0.405256607f,-0.404409757f,-0.403562292f,-0.402714213f,-0.401865521f,-0.401016217f,-0.400166300f,-0.399315772f,-0.398464633f,-0.397612884f,-0.396760524f,-0.395907556f,-0.395053978f,-0.394199793f,-0.393345001f,-0.392489601f,-0.391633595f,-0.390776984f,-0.389919767f,-0.389061947f,-0.388203522f,-0.387344494f,-0.386484864f,-0.385624632f,-0.384763799f,-0.383902365f,-0.383040331f,-0.382177698f,-0.381314466f,-0.380450637f,-0.379586210f,-0.378721186f,-0.377855567f,-0.376989352f,-0.376122543f,-0.375255140f,-0.374387144f,-0.373518555f,-0.372649375f,-0.371779603f,-0.370909241f,-0.370038290f,-0.369166749f,-0.368294621f,-0.367421905f,-0.366548602f,-0.365674713f,-0.364800239f,-0.363925181f,-0.363049539f,-0.362173314f,-0.361296507f,-0.360419118f,-0.359541149f,-0.358662600f,-0.357783472f,-0.356903765f,-0.356023481f,-0.355142621f,-0.354261184f,-0.353379173f,-0.352496587f,-0.351613427f,-0.350729695f,-0.349845391f,-0.348960516f,-0.348075071f,-0.347189057f,-0.346302474f,-0.345415324f,-0.344527607f,-0.343639324f,-0.342750475f,-0.341861063f,-0.340971087f,-0.340080549f,-0.339189449f,-0.338297789f,-0.337405569f,-0.336512790f,-0.335619452f,-0.334725558f,-0.333831108f,-0.332936102f,-0.332040542f,-0.331144429f,-0.330247763f,-0.329350545f,-0.328452777f,-0.327554459f,-0.326655593f,-0.325756179f,-0.324856217f,-0.323955710f,-0.323054658f,-0.322153062f,-0.321250923f,-0.320348242f,-0.319445021f,-0.318541259f,-0.317636958f,-0.316732119f,-0.315826743f,-0.314920831f,-0.314014384f,-0.313107403f,-0.312199889f,-0.311291843f,-0.310383266f,-0.309474159f,-0.308564523f,-0.307654360f,-0.306743670f,-0.305832454f,-0.304920714f,-0.304008450f,-0.303095663f,-0.302182356f,-0.301268527f,-0.300354180f,-0.299439314f,-0.298523932f,-0.297608033f,-0.296691619f,-0.295774692f,-0.294857252f,-0.293939300f,-0.293020838f,-0.292101867f,-0.291182387f,-0.290262401f,-0.289341909f,-0.288420911f,-0.287499411f,-0.286577407f,-0.285654903f,-0.284731898f,-0.283808394f,-0.282884393f,-0.281959895f,-0.281034902f,-0.280109414f,-0.279183433f,-0.278256960f,-0.277329997f,-0.276402544f,-0.275474603f,-0.274546175f,-0.273617261f,-0.272687863f,-0.271757981f,-0.270827617f,-0.269896772f,-0.268965447f,-0.268033644f,-0.267101364f,-0.266168608f,-0.265235377f,-0.264301673f,-0.263367497f,-0.262432850f,-0.261497733f,-0.260562148f,-0.259626096f,-0.258689579f,-0.257752597f,-0.256815152f,-0.255877245f,-0.254938877f,-0.254000051f,-0.253060766f,-0.252121025f,-0.251180829f,-0.250240179f,-0.249299076f,-0.248357523f,-0.247415519f,-0.246473067f,-0.245530168f,-0.244586823f,-0.243643033f,-0.242698801f,-0.241754126f,-0.240809012f,-0.239863458f,-0.238917468f,-0.237971040f,-0.237024179f,-0.236076883f,-0.235129156f,-0.234180999f,-0.233232412f,-0.232283397f,-0.231333957f,-0.230384091f,-0.229433802f,-0.228483091f,-0.227531959f,-0.226580409f,-0.225628440f,-0.224676056f,-0.223723256f,-0.222770044f,-0.221816419f,-0.220862384f,-0.219907940f,-0.218953089f,-0.217997832f,-0.217042171f,-0.216086106f,-0.215129640f,-0.214172774f,-0.213215510f,-0.212257848f,-0.211299792f,-0.210341341f,-0.209382498f,-0.208423264f,-0.207463640f,-0.206503629f,-0.205543232f,-0.204582449f,-0.203621284f,-0.202659737f,-0.201697809f,-0.200735503f,-0.199772821f,-0.198809762f,-0.197846330f,-0.196882526f,-0.195918351f,-0.194953806f,-0.193988894f,-0.193023617f,-0.192057974f,-0.191091969f,-0.190125603f,-0.189158878f,-0.188191794f,-0.187224354f,-0.186256559f,-0.185288411f,-0.184319912f,-0.183351062f,-0.182381865f,-0.181412321f,-0.180442431f,-0.179472199f,-0.178501625f,-0.177530711f,-0.176559458f,-0.175587869f,-0.174615944f,-0.173643687f,-0.172671097f,-0.171698177f,-0.170724929f,-0.169751355f,-0.168777455f,-0.167803232f,-0.166828687f,-0.165853822f,-0.164878639f,-0.163903140f,-0.162927325f,-0.161951198f,-0.160974759f,-0.159998010f,-0.159020953f,-0.158043590f,-0.157065923f,-0.156087952f,-0.155109680f,-0.154131110f,-0.153152241f,-0.152173076f,-0.151193618f,-0.150213867f,-0.149233825f,-0.148253494f,-0.147272876f,-0.146291973f,-0.145310786f,-0.144329318f,-0.143347569f,-0.142365542f,-0.141383238f,-0.140400660f,-0.139417809f,-0.138434686f,-0.137451294f,-0.136467635f,-0.135483709f,-0.134499520f,-0.133515068f,-0.132530356f,-0.131545386f,-0.130560158f,-0.129574676f,-0.128588940f,-0.127602954f,-0.126616717f,-0.125630233f,-0.124643503f,-0.123656529f,-0.122669313f,-0.121681856f,-0.120694161f,-0.119706230f,-0.118718063f,-0.117729663f,-0.116741033f,-0.115752172f,-0.114763085f,-0.113773772f,-0.112784235f,-0.111794476f,-0.110804498f,-0.109814301f,-0.108823888f,-0.107833260f,-0.106842420f,-0.105851369f,-0.104860110f,-0.103868644f,-0.102876973f,-0.101885098f,-0.100893023f,-0.099900748f,-0.098908276f,-0.097915608f,-0.096922746f,-0.095929693f,-0.094936450f,-0.093943019f,-0.092949402f,-0.091955601f,-0.090961618f,-0.089967455f,-0.088973113f,-0.087978595f,-0.086983902f,-0.085989036f,-0.084994000f,-0.083998796f,-0.083003424f,-0.082007888f,-0.081012188f,-0.080016328f,-0.079020308f,-0.078024132f,-0.077027800f,-0.076031315f,-0.075034678f,-0.074037893f,-0.073040959f,-0.072043881f,-0.071046659f,-0.070049295f,-0.069051792f,-0.068054151f,-0.067056374f,-0.066058463f,-0.065060421f,-0.064062249f,-0.063063949f,-0.062065524f,-0.061066974f,-0.060068302f,-0.059069511f,-0.058070601f,-0.057071576f,-0.056072436f,-0.055073184f,-0.054073822f,-0.053074352f,-0.052074776f,-0.051075096f,-0.050075314f,-0.049075431f,-0.048075450f,-0.047075373f,-0.046075202f,-0.045074938f,-0.044074584f,-0.043074142f,-0.042073613f,-0.041073001f,-0.040072306f,-0.039071530f,-0.038070677f,-0.037069747f,-0.036068742f,-0.035067666f,-0.034066519f,-0.033065304f,-0.032064022f,-0.031062676f,-0.030061268f,-0.029059799f,-0.028058273f,-0.027056690f,-0.026055052f,-0.025053362f,-0.024051622f,-0.023049834f,-0.022047999f,-0.021046121f,-0.020044200f,-0.019042238f,-0.018040239f,-0.017038203f,-0.016036133f,-0.015034030f,-0.014031898f,-0.013029737f,-0.012027551f,-0.011025340f,-0.010023107f,-0.009020853f,-0.008018582f,-0.007016294f,-0.006013993f,-0.005011679f,-0.004009355f,-0.003007024f,-0.002004686f,-0.001002344f,0.000000000f,0.001002344f,0.002004686f,0.003007024f,0.004009355f,0.005011679f,0.006013993f,0.007016294f,0.008018582f,0.009020853f,0.010023107f,0.011025340f,0.012027551f,0.013029737f,0.014031898f,0.015034030f,0.016036133f,0.017038203f,0.018040239f,0.019042238f,0.020044200f,0.021046121f,0.022047999f,0.023049834f,0.024051622f,0.025053362f,0.026055052f,0.027056690f,0.028058273f,0.029059799f,0.030061268f,0.031062676f,0.032064022f,0.033065304f,0.034066519f,0.035067666f,0.036068742f,0.037069747f,0.038070677f,0.039071530f,0.040072306f,0.041073001f,0.042073613f,0.043074142f,0.044074584f,0.045074938f,0.046075202f,0.047075373f,0.048075450f,0.049075431f,0.050075314f,0.051075096f,0.052074776f,0.053074352f,0.054073822f,0.055073184f,0.056072436f,0.057071576f,0.058070601f,0.059069511f,0.060068302f,0.061066974f,0.062065524f,0.063063949f,0.064062249f,0.065060421f,0.066058463f,0.067056374f,0.068054151f,0.069051792f,0.070049295f,0.071046659f,0.072043881f,0.073040959f,0.074037893f,0.075034678f,0.076031315f,0.077027800f,0.078024132f,0.079020308f,0.080016328f,0.081012188f,0.082007888f,0.083003424f,0.083998796f,0.084994000f,0.085989036f,0.086983902f,0.087978595f,0.088973113f,0.089967455f,0.090961618f,0.091955601f,0.092949402f,0.093943019f,0.094936450f,0.095929693f,0.096922746f,0.097915608f,0.098908276f,0.099900748f,0.100893023f,0.101885098f,0.102876973f,0.103868644f,0.104860110f,0.105851369f,0.106842420f,0.107833260f,0.108823888f,0.109814301f,0.110804498f,0.111794476f,0.112784235f,0.113773772f,0.114763085f,0.115752172f,0.116741033f,0.117729663f,0.118718063f,0.119706230f,0.120694161f,0.121681856f,0.122669313f,0.123656529f,0.124643503f,0.125630233f,0.126616717f,0.127602954f,0.128588940f,0.129574676f,0.130560158f,0.131545386f,0.132530356f,0.133515068f,0.134499520f,0.135483709f,0.136467635f,0.137451294f,0.138434686f,0.139417809f,0.140400660f,0.141383238f,0.142365542f,0.143347569f,0.144329318f,0.145310786f,0.146291973f,0.147272876f,0.148253494f,0.149233825f,0.150213867f,0.151193618f,0.152173076f,0.153152241f,0.154131110f,0.155109680f,0.156087952f,0.157065923f,0.158043590f,0.159020953f,0.159998010f,0.160974759f,0.161951198f,0.162927325f,0.163903140f,0.164878639f,0.165853822f,0.166828687f,0.167803232f,0.168777455f,0.169751355f,0.170724929f,0.171698177f,0.172671097f,0.173643687f,0.174615944f,0.175587869f,0.176559458f,0.177530711f,0.178501625f,0.179472199f,0.180442431f,0.181412321f,0.182381865f,0.183351062f,0.184319912f,0.185288411f,0.186256559f,0.187224354f,0.188191794f,0.189158878f,0.190125603f,0.191091969f,0.192057974f,0.193023617f,0.193988894f,0.194953806f,0.195918351f,0.196882526f,0.197846330f,0.198809762f,0.199772821f,0.200735503f,0.201697809f,0.202659737f,0.203621284f,0.204582449f,0.205543232f,0.206503629f,0.207463640f,0.208423264f,0.209382498f,0.210341341f,0.211299792f,0.212257848f,0.213215510f,0.214172774f,0.215129640f,0.216086106f,0.217042171f,0.217997832f,0.218953089f,0.219907940f,0.220862384f,0.221816419f,0.222770044f,0.223723256f,0.224676056f,0.225628440f,0.226580409f,0.227531959f,0.228483091f,0.229433802f,0.230384091f,0.231333957f,0.232283397f,0.233232412f,0.234180999f,0.235129156f,0.236076883f,0.237024179f,0.237971040f,0.238917468f,0.239863458f,0.240809012f,0.241754126f,0.242698801f,0.243643033f,0.244586823f,0.245530168f,0.246473067f,0.247415519f,0.248357523f,0.249299076f,0.250240179f,0.251180829f,0.252121025f,0.253060766f,0.254000051f,0.254938877f,0.255877245f,0.256815152f,0.257752597f,0.258689579f,0.259626096f,0.260562148f,0.261497733f,0.262432850f,0.263367497f,0.264301673f,0.265235377f,0.266168608f,0.267101364f,0.268033644f,0.268965447f,0.269896772f,0.270827617f,0.271757981f,0.272687863f,0.273617261f,0.274546175f,0.275474603f,0.276402544f,0.277329997f,0.278256960f,0.279183433f,0.280109414f,0.281034902f,0.281959895f,0.282884393f,0.283808394f,0.284731898f,0.285654903f,0.286577407f,0.287499411f,0.288420911f,0.289341909f,0.290262401f,0.291182387f,0.292101867f,0.293020838f,0.293939300f,0.294857252f,0.295774692f,0.296691619f,0.297608033f,0.298523932f,0.299439314f,0.300354180f,0.301268527f,0.302182356f,0.303095663f,0.304008450f,0.304920714f,0.305832454f,0.306743670f,0.307654360f,0.308564523f,0.309474159f,0.310383266f,0.311291843f,0.312199889f,0.313107403f,0.314014384f,0.314920831f,0.315826743f,0.316732119f,0.317636958f,0.318541259f,0.319445021f,0.320348242f,0.321250923f,0.322153062f,0.323054658f,0.323955710f,0.324856217f,0.325756179f,0.326655593f,0.327554459f,0.328452777f,0.329350545f,0.330247763f,0.331144429f,0.332040542f,0.332936102f,0.333831108f,0.334725558f,0.335619452f,0.336512790f,0.337405569f,0.338297789f,0.339189449f,0.340080549f,0.340971087f,0.341861063f,0.342750475f,0.343639324f,0.344527607f,0.345415324f,0.346302474f,0.347189057f,0.348075071f,0.348960516f,0.349845391f,0.350729695f,0.351613427f,0.352496587f,0.353379173f,0.354261184f,0.355142621f,0.356023481f,0.356903765f,0.357783472f,0.358662600f,0.359541149f,0.360419118f,0.361296507f,0.362173314f,0.363049539f,0.363925181f,0.364800239f,0.365674713f,0.366548602f,0.367421905f,0.368294621f,0.369166749f,0.370038290f,0.370909241f,0.371779603f,0.372649375f,0.373518555f,0.374387144f,0.375255140f,0.376122543f,0.376989352f,0.377855567f,0.378721186f,0.379586210f,0.380450637f,0.381314466f,0.382177698f,0.383040331f,0.383902365f,0.384763799f,0.385624632f,0.386484864f,0.387344494f,0.388203522f,0.389061947f,0.389919767f,0.390776984f,0.391633595f,0.392489601f,0.393345001f,0.394199793f,0.395053978f,0.395907556f,0.396760524f,0.397612884f,0.398464633f,0.399315772f,0.400166300f,0.401016217f,0.401865521f,0.402714213f,0.403562292f,0.404409757f,0.405256607f,0.406102843f,0.406948463f,0.407793467f,0.408637855f,0.409481626f,0.410324779f,0.411167314f,0.412009231f,0.412850528f,0.413691206f,0.414531264f,0.415370701f,0.416209517f,0.417047712f,0.417885284f,0.418722234f,0.419558561f,0.420394264f,0.421229344f,0.422063799f,0.422897629f,0.423730834f,0.424563413f,0.425395365f,0.426226691f,0.427057390f,0.427887461f,0.428716905f,0.429545720f,0.430373906f,0.431201462f,0.432028389f,0.432854686f,0.433680353f,0.434505388f,0.435329793f,0.436153565f,0.436976706f,0.437799214f,0.438621089f,0.439442331f,0.440262939f,0.441082913f,0.441902253f,0.442720958f,0.443539028f,0.444356463f,0.445173262f,0.445989425f,0.446804951f,0.447619840f,0.448434093f,0.449247708f,0.450060685f,0.450873024f,0.451684724f,0.452495786f,0.453306208f,0.454115992f,0.454925135f,0.455733639f,0.456541502f,0.457348725f,0.458155306f,0.458961247f,0.459766546f,0.460571204f,0.461375219f,0.462178593f,0.462981323f,0.463783411f,0.464584856f,0.465385658f,0.466185816f,0.466985330f,0.467784200f,0.468582426f,0.469380008f,0.470176944f,0.470973236f,0.471768882f,0.472563883f,0.473358239f,0.474151948f,0.474945011f,0.475737429f,0.476529199f,0.477320323f,0.478110800f,0.478900630f,0.479689813f,0.480478348f,0.481266236f,0.482053475f,0.482840067f,0.483626011f,0.484411306f,0.485195953f,0.485979951f,0.486763300f,0.487546000f,0.488328051f,0.489109453f,0.489890206f,0.490670308f,0.491449762f,0.492228565f,0.493006718f,0.493784221f,0.494561075f,0.495337277f,0.496112829f,0.496887731f,0.497661982f,0.498435582f,0.499208531f,0.499980830f,0.500752477f,0.501523473f,0.502293817f,0.503063511f,0.503832553f,0.504600943f,0.505368682f,0.506135769f,0.506902204f,0.507667987f,0.508433119f,0.509197598f,0.509961426f,0.510724601f,0.511487124f,0.512248996f,0.513010214f,0.513770781f,0.514530695f,0.515289957f,0.516048567f,0.516806524f,0.517563829f,0.518320481f,0.519076481f,0.519831828f,0.520586522f,0.521340565f,0.522093954f,0.522846691f,};
 
@@ -28,13 +31,20 @@ static const float FLOOR_RAY_Y[RENDER_WIDTH] = {
 DoomRaycaster::DoomRaycaster(){
     render_image.instantiate();
     render_texture.instantiate();
+    set_render_backend(RENDER_BACKEND_AUTO);
+    entity_grid.resize(0, 0);
 }
 
-DoomRaycaster::~DoomRaycaster(){}
+DoomRaycaster::~DoomRaycaster(){
+    finish_render_task();
+    cancel_pvs_build();
+    stop_recording();
+}
 
 // methods
 void DoomRaycaster::_bind_methods(){
     ClassDB::bind_method(D_METHOD("set_map", "map", "width", "height"), &DoomRaycaster::set_map);
+    ClassDB::bind_method(D_METHOD("set_map_resource", "map"), &DoomRaycaster::set_map_resource);
     ClassDB::bind_method(D_METHOD("set_player_position", "position"), &DoomRaycaster::set_player_position);
     ClassDB::bind_method(D_METHOD("get_player_position"), &DoomRaycaster::get_player_position);
     ClassDB::bind_method(D_METHOD("set_player_angle", "angle"), &DoomRaycaster::set_player_angle);
@@ -56,82 +66,129 @@ void DoomRaycaster::_bind_methods(){
     ClassDB::bind_method(D_METHOD("set_move_speed", "speed"), &DoomRaycaster::set_move_speed);
     ClassDB::bind_method(D_METHOD("set_rotation_speed", "speed"), &DoomRaycaster::set_rotation_speed);
     ClassDB::bind_method(D_METHOD("set_skybox_radius", "radius"), &DoomRaycaster::set_skybox_radius);
+    ClassDB::bind_method(D_METHOD("set_threaded_render", "enabled"), &DoomRaycaster::set_threaded_render);
+    ClassDB::bind_method(D_METHOD("is_threaded_render"), &DoomRaycaster::is_threaded_render);
+    ClassDB::bind_method(D_METHOD("set_player_radius", "radius"), &DoomRaycaster::set_player_radius);
+    ClassDB::bind_method(D_METHOD("get_player_radius"), &DoomRaycaster::get_player_radius);
+    ClassDB::bind_method(D_METHOD("move_circle", "position", "motion", "radius"), &DoomRaycaster::move_circle);
+    ClassDB::bind_method(D_METHOD("move_circles", "positions", "motions", "radius"), &DoomRaycaster::move_circles);
+    ClassDB::bind_method(D_METHOD("add_sprite", "texture"), &DoomRaycaster::add_sprite);
+    ClassDB::bind_method(D_METHOD("add_entity", "position", "radius", "sprite", "flags"), &DoomRaycaster::add_entity, DEFVAL(-1), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("remove_entity", "entity"), &DoomRaycaster::remove_entity);
+    ClassDB::bind_method(D_METHOD("clear_entities"), &DoomRaycaster::clear_entities);
+    ClassDB::bind_method(D_METHOD("has_entity", "entity"), &DoomRaycaster::has_entity);
+    ClassDB::bind_method(D_METHOD("get_entity_count"), &DoomRaycaster::get_entity_count);
+    ClassDB::bind_method(D_METHOD("set_entity_position", "entity", "position"), &DoomRaycaster::set_entity_position);
+    ClassDB::bind_method(D_METHOD("get_entity_position", "entity"), &DoomRaycaster::get_entity_position);
+    ClassDB::bind_method(D_METHOD("set_entity_positions", "entities", "positions"), &DoomRaycaster::set_entity_positions);
+    ClassDB::bind_method(D_METHOD("move_entities", "entities", "motions"), &DoomRaycaster::move_entities);
+    ClassDB::bind_method(D_METHOD("set_entity_sprite", "entity", "sprite"), &DoomRaycaster::set_entity_sprite);
+    ClassDB::bind_method(D_METHOD("set_entity_flags", "entity", "flags"), &DoomRaycaster::set_entity_flags);
+    ClassDB::bind_method(D_METHOD("get_entity_flags", "entity"), &DoomRaycaster::get_entity_flags);
+    ClassDB::bind_method(D_METHOD("query_entities", "center", "radius", "flags"), &DoomRaycaster::query_entities, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("find_nearest_entity", "center", "max_distance", "flags"), &DoomRaycaster::find_nearest_entity, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("cast_rays", "origins", "directions", "max_dist"), &DoomRaycaster::cast_rays);
+    ClassDB::bind_method(D_METHOD("set_pvs_enabled", "enabled"), &DoomRaycaster::set_pvs_enabled);
+    ClassDB::bind_method(D_METHOD("is_pvs_enabled"), &DoomRaycaster::is_pvs_enabled);
+    ClassDB::bind_method(D_METHOD("build_pvs"), &DoomRaycaster::build_pvs);
+    ClassDB::bind_method(D_METHOD("is_cell_visible", "from", "to"), &DoomRaycaster::is_cell_visible);
+    ClassDB::bind_method(D_METHOD("get_visible_cells", "from"), &DoomRaycaster::get_visible_cells);
+    ClassDB::bind_method(D_METHOD("set_wall_mode", "mode"), &DoomRaycaster::set_wall_mode);
+    ClassDB::bind_method(D_METHOD("get_wall_mode"), &DoomRaycaster::get_wall_mode);
+    ClassDB::bind_method(D_METHOD("get_wall_segment_count"), &DoomRaycaster::get_wall_segment_count);
+    ClassDB::bind_method(D_METHOD("set_map_cell", "cell", "value"), &DoomRaycaster::set_map_cell);
+    ClassDB::bind_method(D_METHOD("set_lighting_enabled", "enabled"), &DoomRaycaster::set_lighting_enabled);
+    ClassDB::bind_method(D_METHOD("is_lighting_enabled"), &DoomRaycaster::is_lighting_enabled);
+    ClassDB::bind_method(D_METHOD("set_ambient_light", "level"), &DoomRaycaster::set_ambient_light);
+    ClassDB::bind_method(D_METHOD("get_ambient_light"), &DoomRaycaster::get_ambient_light);
+    ClassDB::bind_method(D_METHOD("add_light", "cell", "intensity", "radius"), &DoomRaycaster::add_light);
+    ClassDB::bind_method(D_METHOD("set_light", "light", "cell", "intensity", "radius"), &DoomRaycaster::set_light);
+    ClassDB::bind_method(D_METHOD("remove_light", "light"), &DoomRaycaster::remove_light);
+    ClassDB::bind_method(D_METHOD("bake_lights"), &DoomRaycaster::bake_lights);
+    ClassDB::bind_method(D_METHOD("get_light_level", "cell"), &DoomRaycaster::get_light_level);
+    ClassDB::bind_method(D_METHOD("add_view", "position", "angle", "fov", "size"), &DoomRaycaster::add_view);
+    ClassDB::bind_method(D_METHOD("remove_view", "view"), &DoomRaycaster::remove_view);
+    ClassDB::bind_method(D_METHOD("set_view_pose", "view", "position", "angle"), &DoomRaycaster::set_view_pose);
+    ClassDB::bind_method(D_METHOD("get_view_texture", "view"), &DoomRaycaster::get_view_texture);
+    ClassDB::bind_method(D_METHOD("get_view_image", "view"), &DoomRaycaster::get_view_image);
+    ClassDB::bind_method(D_METHOD("get_view_count"), &DoomRaycaster::get_view_count);
+    ClassDB::bind_method(D_METHOD("start_recording", "path"), &DoomRaycaster::start_recording);
+    ClassDB::bind_method(D_METHOD("stop_recording"), &DoomRaycaster::stop_recording);
+    ClassDB::bind_method(D_METHOD("is_recording"), &DoomRaycaster::is_recording);
+    ClassDB::bind_method(D_METHOD("start_replay", "path"), &DoomRaycaster::start_replay);
+    ClassDB::bind_method(D_METHOD("stop_replay"), &DoomRaycaster::stop_replay);
+    ClassDB::bind_method(D_METHOD("is_replaying"), &DoomRaycaster::is_replaying);
+    ClassDB::bind_method(D_METHOD("get_replay_desync_count"), &DoomRaycaster::get_replay_desync_count);
+    ClassDB::bind_method(D_METHOD("run_replay_benchmark", "path", "render"), &DoomRaycaster::run_replay_benchmark, DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("run_golden_test", "poses", "golden_dir", "tolerance", "max_mismatches", "update"), &DoomRaycaster::run_golden_test, DEFVAL(2), DEFVAL(0), DEFVAL(false));
+    ClassDB::bind_method(D_METHOD("start_golden_run", "poses", "golden_dir", "tolerance", "max_mismatches", "update"), &DoomRaycaster::start_golden_run, DEFVAL(2), DEFVAL(0), DEFVAL(false));
+    ClassDB::bind_method(D_METHOD("set_render_backend", "backend"), &DoomRaycaster::set_render_backend);
+    ClassDB::bind_method(D_METHOD("get_render_backend"), &DoomRaycaster::get_render_backend);
+    ClassDB::bind_method(D_METHOD("get_render_backend_name"), &DoomRaycaster::get_render_backend_name);
+    ClassDB::bind_method(D_METHOD("render_with_backend", "backend"), &DoomRaycaster::render_with_backend);
+    ClassDB::bind_method(D_METHOD("compare_with_reference", "backend"), &DoomRaycaster::compare_with_reference);
+    
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "render_backend", PROPERTY_HINT_ENUM, "Auto,Scalar,SSE2,AVX2,NEON,Threaded"), "set_render_backend", "get_render_backend");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "wall_mode", PROPERTY_HINT_ENUM, "DDA,Segments"), "set_wall_mode", "get_wall_mode");
+    
+    BIND_ENUM_CONSTANT(RENDER_BACKEND_AUTO);
+    BIND_ENUM_CONSTANT(RENDER_BACKEND_SCALAR);
+    BIND_ENUM_CONSTANT(RENDER_BACKEND_SSE2);
+    BIND_ENUM_CONSTANT(RENDER_BACKEND_AVX2);
+    BIND_ENUM_CONSTANT(RENDER_BACKEND_NEON);
+    BIND_ENUM_CONSTANT(RENDER_BACKEND_THREADED);
+    
+    BIND_ENUM_CONSTANT(WALL_MODE_DDA);
+    BIND_ENUM_CONSTANT(WALL_MODE_SEGMENTS);
+    
+    BIND_ENUM_CONSTANT(ENTITY_FLAG_SOLID);
+    BIND_ENUM_CONSTANT(ENTITY_FLAG_PICKUP);
+    BIND_ENUM_CONSTANT(ENTITY_FLAG_HIDDEN);
     
     ADD_SIGNAL(MethodInfo("key_collected"));
+    ADD_SIGNAL(MethodInfo("entity_picked_up", PropertyInfo(Variant::INT, "entity")));
+    ADD_SIGNAL(MethodInfo("replay_finished"));
+    ADD_SIGNAL(MethodInfo("golden_run_finished", PropertyInfo(Variant::DICTIONARY, "result")));
 }
 
 void DoomRaycaster::_notification(int p_what) {
     switch (p_what) {
         case NOTIFICATION_READY: {
-            render_image->initialize_data(screen_width, screen_height, false, Image::FORMAT_RGB8);
+            render_image->initialize_data(screen_width, screen_height, false, Image::FORMAT_RGBA8);
             render_texture->set_image(render_image);
             set_process(true);
+            set_physics_process(true);
             print_line("DoomRaycaster: Ready - Image size: " + itos(screen_width) + "x" + itos(screen_height));
         } break;
         
+        case NOTIFICATION_PHYSICS_PROCESS: {
+            simulate_tick(get_physics_process_delta_time());
+        } break;
+        
         case NOTIFICATION_PROCESS: {
-            double delta = get_process_delta_time();
-            Input *input = Input::get_singleton();
-            
-            // Rotation
-            if (input->is_key_pressed(Key::LEFT) || input->is_key_pressed(Key::A)){
-                player_angle -= rotation_speed * delta;
-            }
-            if (input->is_key_pressed(Key::RIGHT) || input->is_key_pressed(Key::D)){
-                player_angle += rotation_speed * delta;
-            }
-            
-            // Movement
-            Vector2 move_dir(Math::cos(player_angle), Math::sin(player_angle));
-            Vector2 strafe_dir(-Math::sin(player_angle), Math::cos(player_angle));
-            
-            Vector2 new_pos = player_pos;
-            
-            if (input->is_key_pressed(Key::UP) || input->is_key_pressed(Key::W)){
-                new_pos += move_dir * move_speed * delta;
-            }
-            if (input->is_key_pressed(Key::DOWN) || input->is_key_pressed(Key::S)){
-                new_pos -= move_dir * move_speed * delta;
-            }
-            if (input->is_key_pressed(Key::Q)){
-                new_pos -= strafe_dir * move_speed * delta;
-            }
-            if (input->is_key_pressed(Key::E)){
-                new_pos += strafe_dir * move_speed * delta;
-            }
-            
-            // Collision detection
-            int map_x = (int)new_pos.x;
-            int map_y = (int)new_pos.y;
-            if (get_map_value(map_x, map_y) == 0 || get_map_value(map_x, map_y) == 2){
-                player_pos = new_pos;
-            }
-            
-            // Key collection
-            map_x = (int)player_pos.x;
-            map_y = (int)player_pos.y;
-            if (get_map_value(map_x, map_y) == 2){
-                Vector2 key_pos(map_x, map_y);
-                bool already_collected = false;
-                
-                for(int i = 0; i < collected_keys.size(); i++){
-                    if(collected_keys[i].distance_to(key_pos) < 0.1f){
-                        already_collected = true;
-                        break;
-                    }
-                }
-                
-                if(!already_collected){
-                    collected_keys.push_back(key_pos);
-                    emit_signal("key_collected");
-                    print_line("DoomRaycaster: Key collected at (" + itos(map_x) + ", " + itos(map_y) + ")");
-                }
+            poll_pvs_build();
+            if (golden_run_active) {
+                // One scripted frame per process frame, so --write-movie captures each of them
+                step_golden_run();
+            } else if (threaded_render) {
+                // Present the frame the worker finished while the last ticks simulated,
+                // then start rendering the current pose in the background.
+                finish_render_task();
+                update_view_pose();
+                render_task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &DoomRaycaster::_render_task, nullptr, true, "DoomRaycaster render");
+            } else {
+                update_view_pose();
+                raycast_and_render();
+                update_textures();
             }
-            
-            raycast_and_render();
             queue_redraw();
         } break;
         
+        case NOTIFICATION_EXIT_TREE: {
+            finish_render_task();
+            finish_pvs_build();
+        } break;
+        
         case NOTIFICATION_DRAW: {
             if (render_texture.is_valid()){
                 draw_texture(render_texture, Vector2(0, 0));
@@ -140,57 +197,296 @@ void DoomRaycaster::_notification(int p_what) {
     }
 }
 
-inline Color fast_sample_texture(const Ref<Image>& texture, float u, float v, int tex_width, int tex_height){
-    // Wrap UV coordinates using fast bitwise operations for power-of-2 textures
-    u = u - Math::floor(u);
-    v = v - Math::floor(v);
+uint32_t DoomRaycaster::poll_input() const {
+    Input *input = Input::get_singleton();
+    uint32_t buttons = 0;
+    if (input->is_key_pressed(Key::LEFT) || input->is_key_pressed(Key::A)){
+        buttons |= INPUT_TURN_LEFT;
+    }
+    if (input->is_key_pressed(Key::RIGHT) || input->is_key_pressed(Key::D)){
+        buttons |= INPUT_TURN_RIGHT;
+    }
+    if (input->is_key_pressed(Key::UP) || input->is_key_pressed(Key::W)){
+        buttons |= INPUT_FORWARD;
+    }
+    if (input->is_key_pressed(Key::DOWN) || input->is_key_pressed(Key::S)){
+        buttons |= INPUT_BACK;
+    }
+    if (input->is_key_pressed(Key::Q)){
+        buttons |= INPUT_STRAFE_LEFT;
+    }
+    if (input->is_key_pressed(Key::E)){
+        buttons |= INPUT_STRAFE_RIGHT;
+    }
+    return buttons;
+}
+
+void DoomRaycaster::simulate_tick(double delta) {
+    uint32_t buttons = 0;
+    if (replaying) {
+        if (replay_tick >= replay_ticks.size()) {
+            stop_replay();
+            emit_signal("replay_finished");
+            return;
+        }
+        // The recorded tick length, so playback matches even if the physics rate changed
+        buttons = replay_ticks[replay_tick].buttons;
+        delta = replay_delta;
+    } else {
+        buttons = poll_input();
+    }
+    
+    apply_input(buttons, delta, true);
+    
+    if (replaying) {
+        check_replay_tick();
+    }
+    if (record_file.is_valid()) {
+        record_file->store_8(buttons);
+        record_file->store_float(player_pos.x);
+        record_file->store_float(player_pos.y);
+        record_file->store_float(player_angle);
+    }
+}
+
+// Ticks run in float, the precision the replay header stores the tick length in, so live and
+// replayed ticks give bit-identical poses. Without p_notify no signals are emitted.
+void DoomRaycaster::apply_input(uint32_t p_buttons, float delta, bool p_notify) {
+    // Keep the pose from the previous tick so frames can interpolate between the two
+    prev_player_pos = player_pos;
+    prev_player_angle = player_angle;
+    
+    // Rotation
+    if (p_buttons & INPUT_TURN_LEFT){
+        player_angle -= rotation_speed * delta;
+    }
+    if (p_buttons & INPUT_TURN_RIGHT){
+        player_angle += rotation_speed * delta;
+    }
+    
+    // Movement
+    Vector2 move_dir(Math::cos(player_angle), Math::sin(player_angle));
+    Vector2 strafe_dir(-Math::sin(player_angle), Math::cos(player_angle));
+    
+    Vector2 new_pos = player_pos;
+    
+    if (p_buttons & INPUT_FORWARD){
+        new_pos += move_dir * move_speed * delta;
+    }
+    if (p_buttons & INPUT_BACK){
+        new_pos -= move_dir * move_speed * delta;
+    }
+    if (p_buttons & INPUT_STRAFE_LEFT){
+        new_pos -= strafe_dir * move_speed * delta;
+    }
+    if (p_buttons & INPUT_STRAFE_RIGHT){
+        new_pos += strafe_dir * move_speed * delta;
+    }
+    
+    // Collision detection (slides along walls instead of rejecting the whole move)
+    player_pos = move_circle(player_pos, new_pos - player_pos, player_radius);
+    
+    // Key collection
+    int map_x = (int)player_pos.x;
+    int map_y = (int)player_pos.y;
+    if (get_map_value(map_x, map_y) == 2){
+        Vector2 key_pos(map_x, map_y);
+        bool already_collected = false;
+        
+        for(int i = 0; i < collected_keys.size(); i++){
+            if(collected_keys[i].distance_to(key_pos) < 0.1f){
+                already_collected = true;
+                break;
+            }
+        }
+        
+        if(!already_collected){
+            collected_keys.push_back(key_pos);
+            if (p_notify) {
+                emit_signal("key_collected");
+                print_line("DoomRaycaster: Key collected at (" + itos(map_x) + ", " + itos(map_y) + ")");
+            }
+        }
+    }
+    
+    touch_entities(p_notify);
+}
+
+// Contacts between the player and the entities around it, resolved once per tick
+void DoomRaycaster::touch_entities(bool p_notify) {
+    if (entity_grid.get_count() == 0) {
+        return;
+    }
+    
+    entity_query.clear();
+    entity_grid.query_circle(player_pos, player_radius, 0, entity_query);
+    bool pushed = false;
+    for (uint32_t i = 0; i < entity_query.size(); i++) {
+        int id = entity_query[i];
+        if (!entity_grid.has(id)) {
+            continue; // Removed by a signal handler earlier in the loop
+        }
+        const RaycasterEntityGrid::Entity &entity = entity_grid.get(id);
+        
+        if (entity.flags & ENTITY_FLAG_SOLID) {
+            Vector2 away = player_pos - entity.position;
+            float dist = away.length();
+            float min_dist = player_radius + entity.radius;
+            if (dist > 1e-6f && dist < min_dist) {
+                player_pos += away * ((min_dist - dist) / dist);
+                pushed = true;
+            }
+        }
+        if (entity.flags & ENTITY_FLAG_PICKUP) {
+            entity_grid.remove(id);
+            if (p_notify) {
+                emit_signal("entity_picked_up", id);
+            }
+        }
+    }
     
-    int tex_x = (int)(u * tex_width);
-    int tex_y = (int)(v * tex_height);
+    // Being pushed by an entity must not put the player inside a wall
+    if (pushed && map_data.size() > 0) {
+        push_circle_out(player_pos, CLAMP(player_radius, 0.01f, 0.49f));
+    }
+}
+
+void DoomRaycaster::update_view_pose() {
+    // Blend between the last two physics ticks so motion stays smooth at any refresh rate
+    float alpha = (float)Engine::get_singleton()->get_physics_interpolation_fraction();
+    view_pos = prev_player_pos.lerp(player_pos, alpha);
+    view_angle = Math::lerp(prev_player_angle, player_angle, alpha);
     
-    // Fast modulo for positive numbers
-    if (tex_x >= tex_width) tex_x -= tex_width;
-    if (tex_y >= tex_height) tex_y -= tex_height;
-    if (tex_x < 0) tex_x += tex_width;
-    if (tex_y < 0) tex_y += tex_height;
+    // Copy-on-write snapshot, so the next tick can collect keys while a worker renders
+    view_collected_keys = collected_keys;
+    snapshot_sprites();
     
-    return texture->get_pixel(tex_x, tex_y);
+    for (uint32_t i = 0; i < views.size(); i++) {
+        views[i].render_pos = views[i].pos;
+        views[i].render_angle = views[i].angle;
+    }
+}
+
+// The renderer only reads this copy, so ticks can move entities while a worker renders
+void DoomRaycaster::snapshot_sprites() {
+    view_sprites.clear();
+    for (int id = 0; id < entity_grid.get_capacity(); id++) {
+        if (!entity_grid.has(id)) {
+            continue;
+        }
+        const RaycasterEntityGrid::Entity &entity = entity_grid.get(id);
+        if ((entity.flags & ENTITY_FLAG_HIDDEN) || entity.sprite < 0 || entity.sprite >= (int)sprite_caches.size()) {
+            continue;
+        }
+        SpriteInstance sprite;
+        sprite.pos = entity.position;
+        sprite.size = MAX(entity.radius * 2.0f, 0.05f);
+        sprite.sprite = entity.sprite;
+        view_sprites.push_back(sprite);
+    }
+}
+
+void DoomRaycaster::_render_task(void *p_userdata) {
+    raycast_and_render();
 }
 
-Color DoomRaycaster::sample_texture(Ref<Image> texture, float u, float v){
-    if(!texture.is_valid() || texture->is_empty()){
-        return Color(1, 1, 1);
+void DoomRaycaster::finish_render_task() {
+    if (render_task_id == WorkerThreadPool::INVALID_TASK_ID) {
+        return;
     }
     
-    return fast_sample_texture(texture, u, v, texture->get_width(), texture->get_height());
+    WorkerThreadPool::get_singleton()->wait_for_task_completion(render_task_id);
+    render_task_id = WorkerThreadPool::INVALID_TASK_ID;
+    update_textures();
+}
+
+// Ray directions of the angle cache bins. Main view columns always trace along the bin
+// their angle rounds to, warm cache or not, so a cached hit is identical to a fresh trace
+// from the same position. Extra views with columns at least a bin apart snap the same way. The walls are quantized to the bins on every frame: a column
+// ray is up to half a bin (~0.0002 rad, under a quarter of the column spacing) off its
+// exact angle, and while turning each column snaps from bin to bin.
+static const int ANGLE_CACHE_BINS = 16384; // Finer than the narrowest column spacing, so no two columns share a bin
+static const float ANGLE_CACHE_SCALE = ANGLE_CACHE_BINS / Math_TAU;
+
+static struct AngleCacheDirections {
+    float cos_table[ANGLE_CACHE_BINS];
+    float sin_table[ANGLE_CACHE_BINS];
+    AngleCacheDirections() {
+        for (int i = 0; i < ANGLE_CACHE_BINS; i++) {
+            double angle = i * Math_TAU / ANGLE_CACHE_BINS;
+            cos_table[i] = (float)Math::cos(angle);
+            sin_table[i] = (float)Math::sin(angle);
+        }
+    }
+} ANGLE_CACHE_DIRS;
+
+static _FORCE_INLINE_ int angle_cache_bin(float p_angle) {
+    int bin = (int)Math::floor(p_angle * ANGLE_CACHE_SCALE + 0.5f) % ANGLE_CACHE_BINS;
+    return bin < 0 ? bin + ANGLE_CACHE_BINS : bin;
+}
+
+void DoomRaycaster::invalidate_angle_cache() {
+    angle_cache_epoch++;
+    if (angle_cache_epoch == 0) {
+        // Stamps wrapped around; clear them so no stale entry matches
+        for (uint32_t i = 0; i < angle_cache.size(); i++) {
+            angle_cache[i].stamp = 0;
+        }
+        angle_cache_epoch = 1;
+    }
+}
+
+// Packs a color into the frame buffer's RGBA8 layout (truncating, like Image::set_pixel)
+static _FORCE_INLINE_ uint32_t pack_color(const Color &p_color) {
+    uint32_t r = (uint32_t)CLAMP(p_color.r * 255.0f, 0.0f, 255.0f);
+    uint32_t g = (uint32_t)CLAMP(p_color.g * 255.0f, 0.0f, 255.0f);
+    uint32_t b = (uint32_t)CLAMP(p_color.b * 255.0f, 0.0f, 255.0f);
+    return r | (g << 8) | (b << 16) | RAYCASTER_ALPHA_MASK;
 }
 
-void DoomRaycaster::render_billboard(int screen_x, float distance, Vector2 billboard_pos, Ref<Image> texture){
-    if(!texture.is_valid() || texture->is_empty()){
+void DoomRaycaster::cache_texture(const Ref<Image> &p_image, TextureCache &r_cache) {
+    r_cache.texels.clear();
+    r_cache.width = 0;
+    r_cache.height = 0;
+    if (!p_image.is_valid() || p_image->is_empty()) {
         return;
     }
     
+    // Convert once so the inner loops read packed RGBA8 directly instead of going through get_pixel
+    Ref<Image> image = p_image->duplicate();
+    if (image->is_compressed()) {
+        image->decompress();
+    }
+    image->convert(Image::FORMAT_RGBA8);
+    
+    r_cache.width = image->get_width();
+    r_cache.height = image->get_height();
+    r_cache.texels.resize(r_cache.width * r_cache.height);
+    memcpy(r_cache.texels.ptr(), image->ptr(), r_cache.texels.size() * sizeof(uint32_t));
+}
+
+void DoomRaycaster::render_billboard(const FrameState &p_frame, float distance, Vector2 billboard_pos, const RaycasterTexture &texture){
     if(distance < 0.1f) return;
     
     // Calculate billboard height
-    float billboard_height = (screen_height / distance) * SCALE;
-    int draw_start_y = MAX(0, (screen_height - billboard_height) / 2);
-    int draw_end_y = MIN(screen_height - 1, (screen_height + billboard_height) / 2);
+    float billboard_height = (p_frame.height / distance) * SCALE;
+    int draw_start_y = MAX(0, (p_frame.height - billboard_height) / 2);
+    int draw_end_y = MIN(p_frame.height - 1, (p_frame.height + billboard_height) / 2);
     
     // Billboard width (same as height for square billboards)
     float billboard_width = billboard_height;
     
     // Calculate screen space position
-    Vector2 to_billboard = billboard_pos - player_pos;
+    Vector2 to_billboard = billboard_pos - p_frame.pos;
     float angle_to_billboard = Math::atan2(to_billboard.y, to_billboard.x);
-    float angle_diff = angle_to_billboard - player_angle;
+    float angle_diff = angle_to_billboard - p_frame.angle;
     
     // Normalize angle
     while(angle_diff > Math_PI) angle_diff -= Math_TAU;
     while(angle_diff < -Math_PI) angle_diff += Math_TAU;
     
-    float fov_rad = Math::deg_to_rad(fov);
-    float screen_x_f = (angle_diff / fov_rad + 0.5f) * screen_width;
+    float fov_rad = Math::deg_to_rad(p_frame.fov);
+    float screen_x_f = (angle_diff / fov_rad + 0.5f) * p_frame.width;
     int billboard_screen_x = (int)screen_x_f;
     
     // Calculate billboard width in screen space
@@ -198,455 +494,1108 @@ void DoomRaycaster::render_billboard(int screen_x, float distance, Vector2 billb
     int start_x = billboard_screen_x - half_width;
     int end_x = billboard_screen_x + half_width;
     
+    // Apply distance fog
+    float fog = 1.0f - MIN(distance / p_frame.render_distance, 1.0f) * 0.6f;
+    if (p_frame.light_grid && billboard_pos.x >= 0.0f && billboard_pos.y >= 0.0f && (int)billboard_pos.x < p_frame.map_width && (int)billboard_pos.y < p_frame.map_height) {
+        fog *= p_frame.light_grid[(int)billboard_pos.y * p_frame.map_width + (int)billboard_pos.x];
+    }
+    
     // Draw the billboard
     for(int x = start_x; x <= end_x; x++){
-        if(x < 0 || x >= screen_width) continue;
+        if(x < 0 || x >= p_frame.width) continue;
         
         // Calculate texture U coordinate
         float u = (float)(x - start_x) / (float)(end_x - start_x);
+        int tex_x = (int)((u - Math::floor(u)) * texture.width);
+        if (tex_x >= texture.width) tex_x -= texture.width;
         
+        uint32_t *column = p_frame.columns + x * p_frame.height;
         for(int y = draw_start_y; y <= draw_end_y; y++){
             // Calculate texture V coordinate
             float v = (float)(y - draw_start_y) / (float)(draw_end_y - draw_start_y);
+            int tex_y = (int)((v - Math::floor(v)) * texture.height);
+            if (tex_y >= texture.height) tex_y -= texture.height;
             
-            Color pixel = sample_texture(texture, u, v);
+            uint32_t texel = texture.texels[tex_y * texture.width + tex_x];
             
-            // Simple alpha test (assuming black is transparent, or check alpha channel)
-            if(pixel.a > 0.5f){
-                // Apply distance fog
-                float fog = 1.0f - MIN(distance / render_distance, 1.0f) * 0.6f;
-                pixel = pixel * fog;
-                render_image->set_pixel(x, y, pixel);
+            // Simple alpha test (alpha above 0.5)
+            if((texel >> 24) >= 128){
+                column[y] = raycaster_shade_texel(texel, fog);
             }
         }
     }
 }
 
-void DoomRaycaster::render_skybox_cylinder(float ray_angle, int x, int ceiling_end, int sky_tex_width, int sky_tex_height) {
-    // Calculate U coordinate based on angle (wraps around the cylinder)
-    float u = (ray_angle + Math_PI) / Math_TAU; // Normalize angle to 0-1 range
-    u = u - Math::floor(u); // Wrap
-    
-    int tex_x = (int)(u * sky_tex_width);
-    if (tex_x >= sky_tex_width) tex_x -= sky_tex_width;
-    if (tex_x < 0) tex_x += sky_tex_width;
+void DoomRaycaster::build_sky_strip(int ceiling_end, SkyStrip &r_strip) {
+    const RaycasterTexture sky = sky_cache.get();
+    r_strip.rows = ceiling_end;
+    r_strip.texels.resize(sky.width * ceiling_end);
     
     // Precompute reciprocal for faster division
     float inv_ceiling_end = 1.0f / (float)ceiling_end;
     
-    // Draw vertical strip of skybox
-    for(int y = 0; y < ceiling_end; y++){
-        // Calculate V coordinate (top to middle of screen)
-        float v = (float)y * inv_ceiling_end;
-        
-        int tex_y = (int)(v * sky_tex_height);
-        if (tex_y >= sky_tex_height) tex_y -= sky_tex_height;
-        
-        Color pixel = ceiling_texture->get_pixel(tex_x, tex_y);
-        render_image->set_pixel(x, y, pixel);
+    // Resample every panorama column to exactly ceiling_end rows (top to middle of screen)
+    for(int tex_x = 0; tex_x < sky.width; tex_x++){
+        uint32_t *strip = r_strip.texels.ptr() + tex_x * ceiling_end;
+        for(int y = 0; y < ceiling_end; y++){
+            float v = (float)y * inv_ceiling_end;
+            
+            int tex_y = (int)(v * sky.height);
+            if (tex_y >= sky.height) tex_y -= sky.height;
+            
+            strip[y] = sky.texels[tex_y * sky.width + tex_x] | RAYCASTER_ALPHA_MASK;
+        }
     }
 }
 
-void DoomRaycaster::raycast_and_render() {
-    if (map_data.size() == 0 || !render_image.is_valid()) {
-        return;
-    }
+void DoomRaycaster::render_skybox_cylinder(const FrameState &p_frame, float ray_angle, uint32_t *r_column, int ceiling_end) {
+    const int sky_width = p_frame.sky.width;
+    
+    // Calculate U coordinate based on angle (wraps around the cylinder)
+    float u = (ray_angle + Math_PI) / Math_TAU; // Normalize angle to 0-1 range
+    u = u - Math::floor(u); // Wrap
+    
+    int tex_x = (int)(u * sky_width);
+    if (tex_x >= sky_width) tex_x -= sky_width;
+    if (tex_x < 0) tex_x += sky_width;
+    
+    // The strip is already resampled to this height, so the column is one contiguous copy
+    memcpy(r_column, p_frame.sky_strip->texels.ptr() + tex_x * ceiling_end, ceiling_end * sizeof(uint32_t));
+}
 
-    // Precompute FOV in radians
-    float fov_rad = Math::deg_to_rad(fov);
-    float tan_half_fov = Math::tan(fov_rad / 2.0f);
+// Grid DDA shared by the renderer, the ray query API and the PVS builder. Returns the
+// euclidean distance along (dir_x, dir_y) when the direction is normalized.
+_FORCE_INLINE_ DoomRaycaster::RayHit DoomRaycaster::trace_grid(const int *p_cells, int p_cell_count, int p_width, int p_height, float ray_pos_x, float ray_pos_y, float dir_x, float dir_y, float max_dist) {
+    RayHit result;
+    result.dist = max_dist; // default if we never hit
+
+    int map_x = (int)ray_pos_x;
+    int map_y = (int)ray_pos_y;
+
+    // Length of ray to go from one x-side to next, and one y-side to next
+    float delta_dist_x = (dir_x == 0) ? 1e30f : Math::abs(1.0f / dir_x);
+    float delta_dist_y = (dir_y == 0) ? 1e30f : Math::abs(1.0f / dir_y);
+
+    int step_x;
+    int step_y;
+    float side_dist_x;
+    float side_dist_y;
+    int side = 0; // 0 = hit in x, 1 = hit in y
+
+    if (dir_x < 0) {
+        step_x = -1;
+        side_dist_x = (ray_pos_x - map_x) * delta_dist_x;
+    } else {
+        step_x = 1;
+        side_dist_x = (map_x + 1.0f - ray_pos_x) * delta_dist_x;
+    }
 
-    // Skybox presence flag
-    bool has_skybox = ceiling_texture.is_valid() && !ceiling_texture->is_empty();
-    int sky_tex_width = 0;
-    int sky_tex_height = 0;
-    if (has_skybox) {
-        sky_tex_width = ceiling_texture->get_width();
-        sky_tex_height = ceiling_texture->get_height();
+    if (dir_y < 0) {
+        step_y = -1;
+        side_dist_y = (ray_pos_y - map_y) * delta_dist_y;
+    } else {
+        step_y = 1;
+        side_dist_y = (map_y + 1.0f - ray_pos_y) * delta_dist_y;
     }
 
-    // Precompute player angle trig values (moved out of loop)
-    float ca = Math::cos(player_angle);
-    float sa = Math::sin(player_angle);
+    // Safety limit; the distance cutoff below always ends the loop first. No ray crosses more
+    // than width + height cells, so clamping to that keeps huge, inf and NaN distances out of
+    // the int conversion.
+    const float map_span = (float)(p_width + p_height);
+    const float step_dist = max_dist > 0.0f ? MIN(max_dist, map_span) : 0.0f;
+    const int max_steps = (int)(step_dist * 2.0f) + 4;
+    int steps = 0;
+
+    while (steps++ < max_steps) {
+        if (side_dist_x < side_dist_y) {
+            side_dist_x += delta_dist_x;
+            map_x += step_x;
+            side = 0;
+            
+            // Quick bounds check
+            if (map_x < 0 || map_x >= p_width) {
+                return result;
+            }
+        } else {
+            side_dist_y += delta_dist_y;
+            map_y += step_y;
+            side = 1;
+            
+            // Quick bounds check
+            if (map_y < 0 || map_y >= p_height) {
+                return result;
+            }
+        }
 
-    // Precompute wall texture dimensions (moved out of loop)
-    bool use_wall_texture = wall_texture.is_valid() && !wall_texture->is_empty();
-    int wall_tex_width = 0;
-    int wall_tex_height = 0;
-    if (use_wall_texture) {
-        wall_tex_width = wall_texture->get_width();
-        wall_tex_height = wall_texture->get_height();
-    }
+        // Inline map value check for speed (avoids function call)
+        int map_index = map_y * p_width + map_x;
+        if (map_index >= 0 && map_index < p_cell_count && p_cells[map_index] == 1) {
+            result.hit = true;
+            break;
+        }
 
-    // Precompute floor texture dimensions
-    bool use_floor_texture = floor_texture.is_valid() && !floor_texture->is_empty();
-    int floor_tex_width = 0;
-    int floor_tex_height = 0;
-    if (use_floor_texture) {
-        floor_tex_width = floor_texture->get_width();
-        floor_tex_height = floor_texture->get_height();
+        // Early cutoff if both distances exceed the max distance
+        if (side_dist_x > max_dist && side_dist_y > max_dist) {
+            return result;
+        }
     }
 
-    // Precompute screen midpoint (moved out of loop)
-    int screen_mid_height = screen_height / 2;
-    
-    // Precompute reciprocals for faster division
-    float inv_render_distance = 1.0f / render_distance;
+    if (!result.hit) {
+        return result;
+    }
 
-    // For each vertical screen column (ray)
-    for (int x = 0; x < screen_width; x++) {
-        // ---- 1) Compute ray direction for this column (perspective correct) ----
-        // Use precomputed directions — rotated by player_angle
+    // Distance to the face that was crossed
+    if (side == 0) {
+        result.dist = (map_x - ray_pos_x + (1 - step_x) / 2.0f) / dir_x;
+    } else {
+        result.dist = (map_y - ray_pos_y + (1 - step_y) / 2.0f) / dir_y;
+    }
 
-        // Raw lookup direction from tables
-        float base_x = RAY_COS[x];
-        float base_y = RAY_SIN[x];
+    // Exact wall hit position along the face (for texture U)
+    float wall_x = (side == 0) ? (ray_pos_y + result.dist * dir_y) : (ray_pos_x + result.dist * dir_x);
+    result.wall_x = wall_x - Math::floor(wall_x);
+    result.side = side;
+    result.map_x = map_x;
+    result.map_y = map_y;
+    return result;
+}
 
-        // Rotate lookup direction by player angle
-        Vector2 ray_dir(
-            base_x * ca - base_y * sa,
-            base_x * sa + base_y * ca
-        );
+_FORCE_INLINE_ DoomRaycaster::RayHit DoomRaycaster::trace_ray(float ray_pos_x, float ray_pos_y, float dir_x, float dir_y, float max_dist) const {
+    return trace_grid(map_data.ptr(), map_data.size(), map_width, map_height, ray_pos_x, ray_pos_y, dir_x, dir_y, max_dist);
+}
 
-        // ---- 2) Draw skybox strip for this column (if any) ----
-        if (has_skybox) {
-            float ray_angle = player_angle + RAY_ANGLE[x];
-            render_skybox_cylinder(ray_angle, x, screen_mid_height, sky_tex_width, sky_tex_height);
+// Merges the wall faces that border open cells into maximal runs per grid line.
+// Faces between a wall and the map edge can never be seen and are left out.
+void DoomRaycaster::build_wall_segments() {
+    wall_segments.clear();
+    
+    for (int side = 0; side < 2; side++) {
+        int lines = side == 0 ? map_width : map_height;
+        int length = side == 0 ? map_height : map_width;
+        for (int line = 1; line < lines; line++) {
+            WallSegment run;
+            bool in_run = false;
+            for (int i = 0; i <= length; i++) {
+                // +1 when the wall is on the low side of the line, -1 when on the high side, 0 for no face
+                int normal = 0;
+                if (i < length) {
+                    bool low = side == 0 ? get_map_value(line - 1, i) == 1 : get_map_value(i, line - 1) == 1;
+                    bool high = side == 0 ? get_map_value(line, i) == 1 : get_map_value(i, line) == 1;
+                    if (low != high) {
+                        normal = low ? 1 : -1;
+                    }
+                }
+                
+                if (in_run && normal != run.normal) {
+                    wall_segments.push_back(run);
+                    in_run = false;
+                }
+                if (normal != 0 && !in_run) {
+                    run.side = side;
+                    run.line = line;
+                    run.normal = normal;
+                    run.from = i;
+                    in_run = true;
+                }
+                if (in_run) {
+                    run.to = i + 1;
+                }
+            }
         }
+    }
+}
+
+// Coverage buffer lookup: first column at or after p_x that is not final yet (path halving)
+static _FORCE_INLINE_ int find_open_column(int *r_next, int p_x) {
+    while (r_next[p_x] != p_x) {
+        r_next[p_x] = r_next[r_next[p_x]];
+        p_x = r_next[p_x];
+    }
+    return p_x;
+}
 
-        // ---- 3) Set up DDA for this ray ----
-        float ray_pos_x = player_pos.x;
-        float ray_pos_y = player_pos.y;
+// Resolves the wall hit of every column from the projected wall segments instead of
+// marching the grid. Segments are drawn front to back by their closest distance; a
+// column becomes final once its hit is nearer than the next segment can possibly be,
+// so occluded walls stop costing anything after the first few segments.
+void DoomRaycaster::rasterize_wall_segments(const FrameState &p_frame, LocalVector<RayHit> &r_hits) {
+    static const float NEAR_PLANE = 0.01f;
+    const int width = p_frame.width;
+    const Vector2 pos = p_frame.pos;
+    const float ca = Math::cos(p_frame.angle);
+    const float sa = Math::sin(p_frame.angle);
+    
+    // Columns follow a pinhole projection: tan(column_angles[x]) is linear in x
+    const float center = p_frame.column_center;
+    const float columns_per_tan = p_frame.columns_per_tan;
+    
+    r_hits.resize(width);
+    open_columns.resize(width + 1);
+    for (int x = 0; x <= width; x++) {
+        open_columns[x] = x;
+    }
+    for (int x = 0; x < width; x++) {
+        r_hits[x] = RayHit();
+        r_hits[x].dist = p_frame.render_distance;
+    }
+    
+    // ---- Cull, clip and project ----
+    projected_segments.clear();
+    for (uint32_t i = 0; i < wall_segments.size(); i++) {
+        const WallSegment &segment = wall_segments[i];
+        float across = segment.side == 0 ? pos.x : pos.y;
+        float along = segment.side == 0 ? pos.y : pos.x;
+        
+        // Back faces
+        if ((across - segment.line) * segment.normal <= 0.0f) {
+            continue;
+        }
+        
+        float closest = CLAMP(along, (float)segment.from, (float)segment.to);
+        float min_dist = Vector2(across - segment.line, along - closest).length();
+        if (min_dist > p_frame.render_distance) {
+            continue;
+        }
+        
+        // Endpoints in camera space (z forward, lateral towards increasing columns), u = position along the line
+        Vector2 a = (segment.side == 0 ? Vector2(segment.line, segment.from) : Vector2(segment.from, segment.line)) - pos;
+        Vector2 b = (segment.side == 0 ? Vector2(segment.line, segment.to) : Vector2(segment.to, segment.line)) - pos;
+        float za = a.x * ca + a.y * sa;
+        float zb = b.x * ca + b.y * sa;
+        float la = a.y * ca - a.x * sa;
+        float lb = b.y * ca - b.x * sa;
+        float ua = segment.from;
+        float ub = segment.to;
+        
+        if (za < NEAR_PLANE && zb < NEAR_PLANE) {
+            continue;
+        }
+        if (za < NEAR_PLANE) {
+            float t = (NEAR_PLANE - za) / (zb - za);
+            la += (lb - la) * t;
+            ua += (ub - ua) * t;
+            za = NEAR_PLANE;
+        } else if (zb < NEAR_PLANE) {
+            float t = (NEAR_PLANE - zb) / (za - zb);
+            lb += (la - lb) * t;
+            ub += (ua - ub) * t;
+            zb = NEAR_PLANE;
+        }
+        
+        float sxa = center + la / za * columns_per_tan;
+        float sxb = center + lb / zb * columns_per_tan;
+        if (sxa > sxb) {
+            SWAP(sxa, sxb);
+            SWAP(za, zb);
+            SWAP(ua, ub);
+        }
+        
+        // Column x is covered when sxa <= x < sxb
+        int from_x = MAX(0, (int)Math::ceil(sxa));
+        int to_x = MIN(width, (int)Math::ceil(sxb));
+        if (from_x >= to_x) {
+            continue;
+        }
+        
+        ProjectedSegment projected;
+        projected.segment = i;
+        projected.min_dist = min_dist;
+        projected.from_x = from_x;
+        projected.to_x = to_x;
+        projected.screen_x = sxa;
+        projected.inv_z = 1.0f / za;
+        projected.u_over_z = ua / za;
+        projected.inv_z_step = (1.0f / zb - projected.inv_z) / (sxb - sxa);
+        projected.u_over_z_step = (ub / zb - projected.u_over_z) / (sxb - sxa);
+        projected_segments.push_back(projected);
+    }
+    projected_segments.sort();
+    
+    // ---- Fill the open column spans, nearest segments first ----
+    int *next = open_columns.ptr();
+    for (uint32_t i = 0; i < projected_segments.size(); i++) {
+        if (find_open_column(next, 0) >= width) {
+            break; // Every column is final
+        }
+        
+        const ProjectedSegment &projected = projected_segments[i];
+        const WallSegment &segment = wall_segments[projected.segment];
+        int wall_cell = segment.normal > 0 ? segment.line - 1 : segment.line;
+        
+        for (int x = find_open_column(next, projected.from_x); x < projected.to_x; x = find_open_column(next, x + 1)) {
+            RayHit &hit = r_hits[x];
+            if (hit.hit && hit.dist <= projected.min_dist) {
+                // Nothing from here on in the sort can be closer
+                next[x] = x + 1;
+                continue;
+            }
+            
+            // Perspective-correct: 1/z and u/z are affine in screen x
+            float offset = x - projected.screen_x;
+            float z = 1.0f / (projected.inv_z + projected.inv_z_step * offset);
+            float u = (projected.u_over_z + projected.u_over_z_step * offset) * z;
+            float tan_x = (x - center) / columns_per_tan;
+            float dist = z * Math::sqrt(1.0f + tan_x * tan_x); // Euclidean, like the DDA
+            if (dist > p_frame.render_distance || (hit.hit && dist >= hit.dist)) {
+                continue;
+            }
+            
+            int along_cell = CLAMP((int)Math::floor(u), segment.from, segment.to - 1);
+            hit.hit = true;
+            hit.dist = dist;
+            hit.side = segment.side;
+            hit.wall_x = u - Math::floor(u);
+            hit.map_x = segment.side == 0 ? wall_cell : along_cell;
+            hit.map_y = segment.side == 0 ? along_cell : wall_cell;
+        }
+    }
+}
 
-        int map_x = (int)ray_pos_x;
-        int map_y = (int)ray_pos_y;
+// Scales a drawn floor run by the baked level of the cell under each pixel. Consecutive
+// pixels mostly share a cell, so the level is only looked up again when the cell changes.
+static void light_floor_span(uint32_t *r_dst, const float *p_row_dist, int p_count, float p_pos_x, float p_pos_y, float p_dir_x, float p_dir_y, const float *p_light_grid, int p_map_width, int p_map_height) {
+    int last_cell = -1;
+    float level = 1.0f;
+    for (int i = 0; i < p_count; i++) {
+        float row_dist = p_row_dist[i];
+        if (row_dist <= 0.0f) {
+            continue; // Fallback pixels at the horizon
+        }
+        
+        // Same world position the floor kernels sample
+        int cell_x = (int)floorf(p_pos_x + p_dir_x * row_dist);
+        int cell_y = (int)floorf(p_pos_y + p_dir_y * row_dist);
+        if (cell_x < 0 || cell_y < 0 || cell_x >= p_map_width || cell_y >= p_map_height) {
+            continue;
+        }
+        
+        int cell = cell_y * p_map_width + cell_x;
+        if (cell != last_cell) {
+            last_cell = cell;
+            level = p_light_grid[cell];
+        }
+        if (level != 1.0f) {
+            r_dst[i] = raycaster_shade_texel(r_dst[i], level);
+        }
+    }
+}
 
-        // Length of ray to go from one x-side to next, and one y-side to next
-        float delta_dist_x = (ray_dir.x == 0) ? 1e30f : Math::abs(1.0f / ray_dir.x);
-        float delta_dist_y = (ray_dir.y == 0) ? 1e30f : Math::abs(1.0f / ray_dir.y);
+void DoomRaycaster::render_columns(const FrameState &p_frame, int p_from, int p_to) {
+    const RaycasterKernels *kernels = p_frame.kernels;
+    const int height = p_frame.height;
+    const int mid = p_frame.mid;
+    const bool has_skybox = p_frame.sky.texels != nullptr;
+    const bool use_wall_texture = p_frame.wall.texels != nullptr;
+    const bool use_floor_texture = p_frame.floor.texels != nullptr;
 
-        int step_x;
-        int step_y;
-        float side_dist_x;
-        float side_dist_y;
-        int side = 0; // 0 = hit in x, 1 = hit in y
+    // For each vertical screen column (ray)
+    for (int x = p_from; x < p_to; x++) {
+        // Columns are contiguous in the column-major buffer
+        uint32_t *column = p_frame.columns + x * height;
 
-        if (ray_dir.x < 0) {
-            step_x = -1;
-            side_dist_x = (ray_pos_x - map_x) * delta_dist_x;
+        // ---- 1) Compute ray direction for this column (perspective correct) ----
+        // Snapped to the bins, the absolute angle is rounded to its bin and the direction comes from the bin table
+        float ray_angle = p_frame.angle + p_frame.column_angles[x];
+        int bin = 0;
+        Vector2 ray_dir;
+        if (p_frame.angle_bins) {
+            bin = angle_cache_bin(ray_angle);
+            ray_dir = Vector2(ANGLE_CACHE_DIRS.cos_table[bin], ANGLE_CACHE_DIRS.sin_table[bin]);
         } else {
-            step_x = 1;
-            side_dist_x = (map_x + 1.0f - ray_pos_x) * delta_dist_x;
+            ray_dir = Vector2(Math::cos(ray_angle), Math::sin(ray_angle));
         }
 
-        if (ray_dir.y < 0) {
-            step_y = -1;
-            side_dist_y = (ray_pos_y - map_y) * delta_dist_y;
-        } else {
-            step_y = 1;
-            side_dist_y = (map_y + 1.0f - ray_pos_y) * delta_dist_y;
+        // ---- 2) Draw skybox strip for this column (if any) ----
+        if (has_skybox) {
+            render_skybox_cylinder(p_frame, ray_angle, column, mid);
         }
 
-        // ---- 4) DDA loop: march until we hit a wall or exceed render distance ----
-        bool hit = false;
-        float dist = render_distance; // default if we never hit
-        
-        // Precompute map bounds for faster checking
-        const int max_steps = 100; // Safety limit
-        int steps = 0;
-
-        while (steps++ < max_steps) {
-            if (side_dist_x < side_dist_y) {
-                side_dist_x += delta_dist_x;
-                map_x += step_x;
-                side = 0;
-                
-                // Quick bounds check
-                if (map_x < 0 || map_x >= map_width) {
-                    break;
-                }
-            } else {
-                side_dist_y += delta_dist_y;
-                map_y += step_y;
-                side = 1;
-                
-                // Quick bounds check
-                if (map_y < 0 || map_y >= map_height) {
-                    break;
-                }
-            }
-
-            // Inline map value check for speed (avoids function call)
-            int map_index = map_y * map_width + map_x;
-            if (map_index >= 0 && map_index < map_data.size() && map_data[map_index] == 1) {
-                hit = true;
-                break;
-            }
-
-            // Early cutoff if both distances exceed render distance
-            if (side_dist_x > render_distance && side_dist_y > render_distance) {
-                break;
+        // ---- 3) DDA: march until we hit a wall or exceed render distance ----
+        // (skipped when the wall segments already resolved every column)
+        const RayHit *traced = p_frame.column_hits ? &p_frame.column_hits[x] : nullptr;
+        RayHit fresh;
+        if (!traced && p_frame.angle_cache) {
+            // Rotation-only frames reuse the hit traced for this bin since the last move
+            AngleHit &cached = p_frame.angle_cache[bin];
+            if (cached.stamp != p_frame.angle_cache_epoch) {
+                cached.ray = trace_ray(p_frame.pos.x, p_frame.pos.y, ray_dir.x, ray_dir.y, p_frame.render_distance);
+                cached.stamp = p_frame.angle_cache_epoch;
             }
+            traced = &cached.ray;
+        } else if (!traced) {
+            fresh = trace_ray(p_frame.pos.x, p_frame.pos.y, ray_dir.x, ray_dir.y, p_frame.render_distance);
+            traced = &fresh;
         }
-
-        if (hit) {
-            // ---- 5) Compute perpendicular distance to avoid fisheye ----
-            if (side == 0) {
-                dist = (map_x - ray_pos_x + (1 - step_x) / 2.0f) / ray_dir.x;
-            } else {
-                dist = (map_y - ray_pos_y + (1 - step_y) / 2.0f) / ray_dir.y;
-            }
-
+        const RayHit &ray = *traced;
+        int floor_start = mid;
+        p_frame.column_depth[x] = ray.hit ? MAX(ray.dist, 0.1f) : p_frame.render_distance;
+
+        if (ray.hit) {
+            // ---- 4) Clamp the hit distance to the near plane ----
+            float dist = ray.dist;
+            int side = ray.side;
             if (dist < 0.1f) {
                 dist = 0.1f;
             }
 
-            // ---- 6) Projected wall slice height on screen ----
+            // ---- 5) Projected wall slice height on screen ----
             // Use reciprocal multiplication instead of division
             float inv_dist = 1.0f / dist;
-            int wall_height = (int)(screen_height * inv_dist);
-            int draw_start = (screen_height - wall_height) >> 1;  // Bit shift for /2
-            int draw_end   = (screen_height + wall_height) >> 1;
+            int wall_height = MAX(1, (int)(height * inv_dist));
+            int draw_start = (height - wall_height) >> 1;  // Bit shift for /2
+            int draw_end   = (height + wall_height) >> 1;
 
             draw_start = MAX(0, draw_start);
-            draw_end   = MIN(screen_height - 1, draw_end);
+            draw_end   = MIN(height - 1, draw_end);
 
-            // ---- 7) Exact wall hit position (for texture U) ----
-            float wall_x;
-            if (side == 0) {
-                wall_x = ray_pos_y + dist * ray_dir.y;
-            } else {
-                wall_x = ray_pos_x + dist * ray_dir.x;
+            // ---- 6) Exact wall hit position (for texture U) ----
+            float wall_x = ray.wall_x;
+            if (dist != ray.dist) {
+                wall_x = (side == 0) ? (p_frame.pos.y + dist * ray_dir.y) : (p_frame.pos.x + dist * ray_dir.x);
+                wall_x -= Math::floor(wall_x); // fractional part only (0..1)
             }
-            wall_x -= Math::floor(wall_x); // fractional part only (0..1)
 
-            // ---- 8) Precompute wall texture stepping to avoid wobbling ----
-            float tex_step = 0.0f;
-            float tex_pos = 0.0f;
-            int tex_x = 0;
-
-            if (use_wall_texture) {
-                tex_step = (float)wall_tex_height / (float)wall_height;
+            // Fog and side shading, once per column
+            float fog = 1.0f - MIN(dist * p_frame.inv_render_distance, 1.0f) * 0.6f;
+            float side_shade = (side == 1) ? 0.7f : 1.0f;
 
-                // Start texture coordinate so that the center of the texture
-                // aligns with the center of the projected wall column
-                tex_pos = (draw_start - screen_mid_height + wall_height / 2) * tex_step;
-                
-                // Precompute tex_x (constant for the entire column)
-                tex_x = (int)(wall_x * (float)wall_tex_width);
-                if (tex_x < 0) {
-                    tex_x += wall_tex_width;
+            // Baked light: a face takes the level of the open cell in front of it
+            if (p_frame.light_grid) {
+                int front_x = ray.map_x;
+                int front_y = ray.map_y;
+                if (side == 0) {
+                    front_x -= ray_dir.x > 0.0f ? 1 : -1;
+                } else {
+                    front_y -= ray_dir.y > 0.0f ? 1 : -1;
+                }
+                if (front_x >= 0 && front_y >= 0 && front_x < p_frame.map_width && front_y < p_frame.map_height) {
+                    side_shade *= p_frame.light_grid[front_y * p_frame.map_width + front_x];
                 }
-                tex_x %= wall_tex_width;
             }
 
-            // ---- 9) Draw column: ceiling, wall, floor ----
-            // Split into 3 separate loops for better cache coherency and branch prediction
-            
-            // Ceiling section (only if no skybox)
+            // ---- 7) Ceiling section (only if no skybox) ----
             if (!has_skybox) {
-                for (int y = 0; y < draw_start; y++) {
-                    render_image->set_pixel(x, y, ceiling_color);
-                }
+                kernels->fill_span(column, draw_start, p_frame.ceiling_color);
             }
-            
-            // Wall section
+
+            // ---- 8) Wall section ----
             if (use_wall_texture) {
-                // Precompute fog and side shading (optimized with reciprocal)
-                float fog = 1.0f - MIN(dist * inv_render_distance, 1.0f) * 0.6f;
-                float side_shade = (side == 1) ? 0.7f : 1.0f;
-                float combined_shade = fog * side_shade;
-                
-                // Unroll loop for small wall heights (common case)
-                int wall_draw_height = draw_end - draw_start + 1;
-                if (wall_draw_height <= 4) {
-                    // Unrolled version for tiny walls
-                    for (int y = draw_start; y <= draw_end; y++) {
-                        int tex_y = (int)tex_pos;
-                        tex_y = (tex_y < 0) ? (tex_y + wall_tex_height) : (tex_y % wall_tex_height);
-                        Color pixel_color = wall_texture->get_pixel(tex_x, tex_y);
-                        pixel_color = pixel_color * combined_shade;
-                        tex_pos += tex_step;
-                        render_image->set_pixel(x, y, pixel_color);
-                    }
-                } else {
-                    // Standard loop for larger walls
-                    for (int y = draw_start; y <= draw_end; y++) {
-                        int tex_y = (int)tex_pos;
-                        if (tex_y >= wall_tex_height) tex_y %= wall_tex_height;
-                        else if (tex_y < 0) tex_y += wall_tex_height;
-                        
-                        Color pixel_color = wall_texture->get_pixel(tex_x, tex_y);
-                        pixel_color = pixel_color * combined_shade;
-                        tex_pos += tex_step;
-                        render_image->set_pixel(x, y, pixel_color);
-                    }
+                const RaycasterTexture &wall = p_frame.wall;
+                float tex_step = (float)wall.height / (float)wall_height;
+
+                // Start texture coordinate so that the center of the texture
+                // aligns with the center of the projected wall column
+                float tex_pos = (draw_start - mid + wall_height / 2) * tex_step;
+
+                // tex_x is constant for the entire column
+                int tex_x = (int)(wall_x * (float)wall.width);
+                if (tex_x < 0) {
+                    tex_x += wall.width;
                 }
+                tex_x %= wall.width;
+
+                kernels->draw_wall_span(column + draw_start, draw_end - draw_start + 1, wall, tex_x, tex_pos, tex_step, fog * side_shade);
             } else {
-                // Solid color wall (optimized)
-                float fog = 1.0f - MIN(dist * inv_render_distance, 1.0f) * 0.6f;
-                Color shaded_wall = wall_color;
-                if (side == 1) {
-                    shaded_wall = shaded_wall * 0.7f;
-                }
-                shaded_wall = shaded_wall * fog;
-                
-                for (int y = draw_start; y <= draw_end; y++) {
-                    render_image->set_pixel(x, y, shaded_wall);
-                }
+                kernels->fill_span(column + draw_start, draw_end - draw_start + 1, pack_color(p_frame.wall_color * side_shade * fog));
             }
-            
-            // Floor section (optimized with inlined texture sampling)
-            if (use_floor_texture) {
-                // Preload direction vectors for this column
-                float dir_x = FLOOR_RAY_X[x];
-                float dir_y = FLOOR_RAY_Y[x];
-                
-                for (int y = draw_end + 1; y < screen_height; y++) {
-                    float row_dist = ROW_DIST[y];
-                    Color pixel_color;
-                    
-                    if (row_dist > 0.0f) {
-                        float world_x = player_pos.x + dir_x * row_dist;
-                        float world_y = player_pos.y + dir_y * row_dist;
-
-                        // Inline texture sampling for floor (avoids function call)
-                        pixel_color = fast_sample_texture(
-                            floor_texture,
-                            world_x,
-                            world_y,
-                            floor_tex_width,
-                            floor_tex_height
-                        );
-                    } else {
-                        pixel_color = floor_color;
-                    }
 
-                    render_image->set_pixel(x, y, pixel_color);
-                }
-            } else {
-                for (int y = draw_end + 1; y < screen_height; y++) {
-                    render_image->set_pixel(x, y, floor_color);
-                }
-            }
+            floor_start = draw_end + 1;
+        } else if (!has_skybox) {
+            // ---- Ray did not hit a wall: plain ceiling down to the horizon ----
+            kernels->fill_span(column, mid, p_frame.ceiling_color);
+        }
+
+        // ---- 9) Floor section ----
+        if (use_floor_texture) {
+            kernels->draw_floor_span(column + floor_start, p_frame.row_dist + floor_start, height - floor_start, p_frame.pos.x, p_frame.pos.y, p_frame.floor_ray_x[x], p_frame.floor_ray_y[x], p_frame.floor, p_frame.floor_color);
         } else {
-            // ---- 10) Ray did not hit a wall: draw simple ceiling/floor ----
-            int start_y = has_skybox ? screen_mid_height : 0;
-            
-            // Ceiling section (if no skybox)
-            if (!has_skybox) {
-                for (int y = 0; y < screen_mid_height; y++) {
-                    render_image->set_pixel(x, y, ceiling_color);
-                }
-            }
-            
-            // Floor section (optimized with inlined texture sampling)
-            if (use_floor_texture) {
-                float dir_x = FLOOR_RAY_X[x];
-                float dir_y = FLOOR_RAY_Y[x];
-                
-                for (int y = start_y; y < screen_height; y++) {
-                    float row_dist = ROW_DIST[y];
-                    Color pixel_color;
-                    
-                    if (row_dist > 0.0f) {
-                        float world_x = player_pos.x + dir_x * row_dist;
-                        float world_y = player_pos.y + dir_y * row_dist;
-
-                        // Inline texture sampling for floor (avoids function call)
-                        pixel_color = fast_sample_texture(
-                            floor_texture,
-                            world_x,
-                            world_y,
-                            floor_tex_width,
-                            floor_tex_height
-                        );
-                    } else {
-                        pixel_color = floor_color;
+            kernels->fill_span(column + floor_start, height - floor_start, p_frame.floor_color);
+        }
+        if (p_frame.light_grid) {
+            light_floor_span(column + floor_start, p_frame.row_dist + floor_start, height - floor_start, p_frame.pos.x, p_frame.pos.y, p_frame.floor_ray_x[x], p_frame.floor_ray_y[x], p_frame.light_grid, p_frame.map_width, p_frame.map_height);
+        }
+    }
+}
+
+// Finds the frame a batch-wide chunk index belongs to; batches hold a handful of frames
+int DoomRaycaster::FrameBatch::find_frame(uint32_t p_index, bool p_rows) const {
+    int frame = count - 1;
+    while (frame > 0 && (int)p_index < (p_rows ? frames[frame].first_row_chunk : frames[frame].first_column_chunk)) {
+        frame--;
+    }
+    return frame;
+}
+
+void DoomRaycaster::_render_columns_group(uint32_t p_index, const FrameBatch *p_batch) {
+    const FrameState &frame = p_batch->frames[p_batch->find_frame(p_index, false)];
+    int from = (p_index - frame.first_column_chunk) * FrameState::COLUMN_CHUNK;
+    render_columns(frame, from, MIN(from + FrameState::COLUMN_CHUNK, frame.width));
+}
+
+void DoomRaycaster::_transpose_group(uint32_t p_index, const FrameBatch *p_batch) {
+    const FrameState &frame = p_batch->frames[p_batch->find_frame(p_index, true)];
+    int from = (p_index - frame.first_row_chunk) * FrameState::ROW_CHUNK;
+    frame.kernels->transpose(frame.columns, frame.width, frame.height, frame.rows, from, MIN(from + FrameState::ROW_CHUNK, frame.height));
+}
+
+// Fills in everything shared by all cameras. The caller sets the pose and projection tables first.
+void DoomRaycaster::prepare_frame(FrameState &r_frame, const RaycasterKernels *p_kernels, int p_width, int p_height, LocalVector<uint32_t> &r_columns, const Ref<Image> &r_target, SkyStrip &r_sky_strip, LocalVector<RayHit> &r_segment_hits, LocalVector<float> &r_depth) {
+    if (r_target->get_width() != p_width || r_target->get_height() != p_height || r_target->get_format() != Image::FORMAT_RGBA8) {
+        r_target->initialize_data(p_width, p_height, false, Image::FORMAT_RGBA8);
+    }
+    r_columns.resize(p_width * p_height);
+    r_depth.resize(p_width);
+
+    r_frame.kernels = p_kernels;
+    r_frame.columns = r_columns.ptr();
+    r_frame.column_depth = r_depth.ptr();
+    r_frame.rows = (uint32_t *)r_target->ptrw();
+    r_frame.width = p_width;
+    r_frame.height = p_height;
+    r_frame.mid = p_height / 2;
+    r_frame.render_distance = render_distance;
+    r_frame.inv_render_distance = 1.0f / render_distance;
+    r_frame.wall = wall_cache.get();
+    r_frame.floor = floor_cache.get();
+    r_frame.sky = sky_cache.get();
+    if (r_frame.sky.texels) {
+        // Only depends on the resolution, so this rebuilds on resize or a new sky texture
+        if (r_sky_strip.rows != r_frame.mid) {
+            build_sky_strip(r_frame.mid, r_sky_strip);
+        }
+        r_frame.sky_strip = &r_sky_strip;
+    }
+    r_frame.ceiling_color = pack_color(ceiling_color);
+    r_frame.floor_color = pack_color(floor_color);
+    r_frame.wall_color = wall_color;
+    r_frame.map_width = map_width;
+    r_frame.map_height = map_height;
+    if (lighting_enabled && light_grid.size() == (uint32_t)(map_width * map_height)) {
+        r_frame.light_grid = light_grid.ptr();
+    }
+
+    if (wall_mode == WALL_MODE_SEGMENTS) {
+        rasterize_wall_segments(r_frame, r_segment_hits);
+        r_frame.column_hits = r_segment_hits.ptr();
+    }
+}
+
+bool DoomRaycaster::prepare_main_frame(FrameState &r_frame, const RaycasterKernels *p_kernels, LocalVector<uint32_t> &r_columns, const Ref<Image> &r_target, LocalVector<float> &r_depth) {
+    // The column tables are built for the default resolution
+    ERR_FAIL_COND_V_MSG(screen_width > RENDER_WIDTH || screen_height > RENDER_HEIGHT, false, "DoomRaycaster: Screen size exceeds the precomputed ray tables.");
+
+    // Pending light changes are applied here so every view of the frame sees the same levels
+    if (lighting_enabled) {
+        bake_lights();
+    }
+
+    r_frame.pos = view_pos;
+    r_frame.angle = view_angle;
+    r_frame.fov = fov;
+    r_frame.column_angles = RAY_ANGLE;
+    r_frame.row_dist = ROW_DIST;
+    r_frame.floor_ray_x = FLOOR_RAY_X;
+    r_frame.floor_ray_y = FLOOR_RAY_Y;
+    r_frame.column_center = RENDER_WIDTH / 2;
+    r_frame.columns_per_tan = r_frame.column_center / Math::tan(-RAY_ANGLE[0]);
+
+    // Cached hits only depend on the absolute angle while the position and trace length stay put
+    if (angle_cache.size() != (uint32_t)ANGLE_CACHE_BINS) {
+        angle_cache.resize(ANGLE_CACHE_BINS);
+        for (uint32_t i = 0; i < angle_cache.size(); i++) {
+            angle_cache[i].stamp = 0;
+        }
+    }
+    if (r_frame.pos != angle_cache_pos || render_distance != angle_cache_distance) {
+        invalidate_angle_cache();
+        angle_cache_pos = r_frame.pos;
+        angle_cache_distance = render_distance;
+    }
+    r_frame.angle_bins = true;
+    r_frame.angle_cache = angle_cache.ptr();
+    r_frame.angle_cache_epoch = angle_cache_epoch;
+
+    prepare_frame(r_frame, p_kernels, screen_width, screen_height, r_columns, r_target, sky_strip, segment_hits, r_depth);
+    return true;
+}
+
+// The angle cache belongs to the main camera; views only share its bin directions
+void DoomRaycaster::prepare_view_frame(FrameState &r_frame, const RaycasterKernels *p_kernels, RenderView &r_view) {
+    r_frame.pos = r_view.render_pos;
+    r_frame.angle = r_view.render_angle;
+    r_frame.fov = r_view.fov;
+    r_frame.column_angles = r_view.column_angles.ptr();
+    r_frame.row_dist = r_view.row_dist.ptr();
+    r_frame.floor_ray_x = r_view.floor_ray_x.ptr();
+    r_frame.floor_ray_y = r_view.floor_ray_y.ptr();
+    r_frame.column_center = r_view.width * 0.5f;
+    r_frame.columns_per_tan = r_view.columns_per_tan;
+    r_frame.angle_bins = r_view.angle_bins;
+
+    prepare_frame(r_frame, p_kernels, r_view.width, r_view.height, r_view.columns, r_view.image, r_view.sky_strip, r_view.segment_hits, r_view.depth);
+}
+
+void DoomRaycaster::render_keys(const FrameState &p_frame) {
+    if (key_cache.texels.size() == 0) {
+        return;
+    }
+
+    RaycasterTexture key = key_cache.get();
+    float half_fov = Math::deg_to_rad(p_frame.fov) * 0.5f;
+    for (int y = 0; y < map_height; y++) {
+        for (int x = 0; x < map_width; x++) {
+            if (get_map_value(x, y) == 2) {
+                Vector2 key_pos(x + 0.5f, y + 0.5f);
+
+                // Check if already collected
+                bool collected = false;
+                for (int i = 0; i < view_collected_keys.size(); i++) {
+                    if (view_collected_keys[i].distance_to(Vector2(x, y)) < 0.1f) {
+                        collected = true;
+                        break;
                     }
+                }
 
-                    render_image->set_pixel(x, y, pixel_color);
+                // Precomputed visibility: O(1) reject for keys the current cell can never see
+                if (collected || !is_cell_visible(Vector2i((int)p_frame.pos.x, (int)p_frame.pos.y), Vector2i(x, y))) {
+                    continue;
                 }
-            } else {
-                for (int y = start_y; y < screen_height; y++) {
-                    render_image->set_pixel(x, y, floor_color);
+
+                Vector2 to_key = key_pos - p_frame.pos;
+                float distance = to_key.length();
+
+                // 1. Check if key is in front of player
+                float angle_to_key = Math::atan2(to_key.y, to_key.x);
+                float angle_diff = Math::fmod(angle_to_key - p_frame.angle + Math_PI * 3, Math_PI * 2) - Math_PI;
+
+                // 2. Key must be inside FOV
+                if (Math::abs(angle_diff) > half_fov)
+                    continue;  // SKIP — not inside FOV
+
+                // 3. LOS: trace the grid towards the key and make sure no wall is closer
+                Vector2 dir = to_key / distance;
+                RayHit los = trace_ray(p_frame.pos.x, p_frame.pos.y, dir.x, dir.y, distance);
+                if (los.hit && los.dist < distance)
+                    continue;  // Key is behind a wall
+
+                // Now render normally
+                render_billboard(p_frame, distance, key_pos, key);
+            }
+        }
+    }
+}
+
+// Draws the entity sprites back to front, standing on the floor and clipped per column
+// against the wall distances render_columns left in column_depth.
+void DoomRaycaster::render_entities(const FrameState &p_frame) {
+    if (view_sprites.size() == 0) {
+        return;
+    }
+    
+    struct VisibleSprite {
+        float distance = 0.0f;
+        float screen_x = 0.0f;
+        uint32_t index = 0;
+        bool operator<(const VisibleSprite &p_other) const { return distance > p_other.distance; }
+    };
+    LocalVector<VisibleSprite> visible;
+    
+    Vector2 forward(Math::cos(p_frame.angle), Math::sin(p_frame.angle));
+    Vector2 right(-forward.y, forward.x);
+    Vector2i view_cell((int)p_frame.pos.x, (int)p_frame.pos.y);
+    for (uint32_t i = 0; i < view_sprites.size(); i++) {
+        const SpriteInstance &sprite = view_sprites[i];
+        Vector2 to_sprite = sprite.pos - p_frame.pos;
+        float depth = to_sprite.dot(forward);
+        float distance = to_sprite.length();
+        if (depth < 0.1f || distance > p_frame.render_distance) {
+            continue;
+        }
+        if (!is_cell_visible(view_cell, Vector2i((int)sprite.pos.x, (int)sprite.pos.y))) {
+            continue;
+        }
+        
+        // Same pinhole projection the column angles follow
+        VisibleSprite entry;
+        entry.distance = distance;
+        entry.screen_x = p_frame.column_center + to_sprite.dot(right) / depth * p_frame.columns_per_tan;
+        entry.index = i;
+        visible.push_back(entry);
+    }
+    visible.sort();
+    
+    for (uint32_t i = 0; i < visible.size(); i++) {
+        const VisibleSprite &entry = visible[i];
+        const SpriteInstance &sprite = view_sprites[entry.index];
+        const TextureCache &cache = sprite_caches[sprite.sprite];
+        if (cache.texels.size() == 0) {
+            continue;
+        }
+        
+        // Scaled like a wall at the same distance, with the bottom on the floor
+        float unit_height = p_frame.height / entry.distance;
+        float size = unit_height * sprite.size;
+        int bottom = p_frame.mid + (int)(unit_height * 0.5f);
+        int top = bottom - (int)size;
+        int start_x = (int)(entry.screen_x - size * 0.5f);
+        int end_x = (int)(entry.screen_x + size * 0.5f);
+        if (end_x < 0 || start_x >= p_frame.width || end_x <= start_x || bottom <= top) {
+            continue;
+        }
+        
+        float shade = 1.0f - MIN(entry.distance * p_frame.inv_render_distance, 1.0f) * 0.6f;
+        if (p_frame.light_grid && sprite.pos.x >= 0.0f && sprite.pos.y >= 0.0f && (int)sprite.pos.x < p_frame.map_width && (int)sprite.pos.y < p_frame.map_height) {
+            shade *= p_frame.light_grid[(int)sprite.pos.y * p_frame.map_width + (int)sprite.pos.x];
+        }
+        
+        float u_step = (float)cache.width / (float)(end_x - start_x + 1);
+        float v_step = (float)cache.height / (float)(bottom - top + 1);
+        int from_y = MAX(0, top);
+        int to_y = MIN(p_frame.height - 1, bottom);
+        for (int x = MAX(0, start_x); x <= MIN(p_frame.width - 1, end_x); x++) {
+            if (p_frame.column_depth[x] < entry.distance) {
+                continue; // Behind the wall drawn in this column
+            }
+            int tex_x = MIN((int)((x - start_x) * u_step), cache.width - 1);
+            uint32_t *column = p_frame.columns + x * p_frame.height;
+            for (int y = from_y; y <= to_y; y++) {
+                int tex_y = MIN((int)((y - top) * v_step), cache.height - 1);
+                uint32_t texel = cache.texels[tex_y * cache.width + tex_x];
+                if ((texel >> 24) >= 128) {
+                    column[y] = raycaster_shade_texel(texel, shade);
                 }
             }
         }
     }
+}
 
-    // ---- 11) Render keys as billboards (unchanged) ----
-    if (key_texture.is_valid() && !key_texture->is_empty()) {
-        for (int y = 0; y < map_height; y++) {
-            for (int x = 0; x < map_width; x++) {
-                if (get_map_value(x, y) == 2) {
-                    Vector2 key_pos(x + 0.5f, y + 0.5f);
+// Renders prepared frames as one batch: the columns of every frame go out in a
+// single group task, then the billboards, then one group task for all transposes.
+void DoomRaycaster::render_frames(FrameState *p_frames, int p_count, bool p_threaded) {
+    FrameBatch batch;
+    batch.frames = p_frames;
+    batch.count = p_count;
+
+    int column_chunks = 0;
+    int row_chunks = 0;
+    for (int i = 0; i < p_count; i++) {
+        p_frames[i].first_column_chunk = column_chunks;
+        p_frames[i].first_row_chunk = row_chunks;
+        column_chunks += (p_frames[i].width + FrameState::COLUMN_CHUNK - 1) / FrameState::COLUMN_CHUNK;
+        row_chunks += (p_frames[i].height + FrameState::ROW_CHUNK - 1) / FrameState::ROW_CHUNK;
+    }
 
-                    // Check if already collected
-                    bool collected = false;
-                    for (int i = 0; i < collected_keys.size(); i++) {
-                        if (collected_keys[i].distance_to(Vector2(x, y)) < 0.1f) {
-                            collected = true;
-                            break;
-                        }
-                    }
+    // ---- Walls, floor and sky, column by column ----
+    if (p_threaded) {
+        WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &DoomRaycaster::_render_columns_group, (const FrameBatch *)&batch, column_chunks, -1, true, "DoomRaycaster columns");
+        WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+    } else {
+        for (int i = 0; i < p_count; i++) {
+            render_columns(p_frames[i], 0, p_frames[i].width);
+        }
+    }
 
-                    if (!collected) {
-                        Vector2 to_key = key_pos - player_pos;
-                        float distance = to_key.length();
-
-                        // 1. Check if key is in front of player
-                        float angle_to_key = Math::atan2(to_key.y, to_key.x);
-                        float angle_diff = Math::fmod(angle_to_key - player_angle + Math_PI * 3, Math_PI * 2) - Math_PI;
-
-                        // 2. Key must be inside FOV
-                        float half_fov = Math::deg_to_rad(fov) * 0.5f;
-                        if (Math::abs(angle_diff) > half_fov)
-                            continue;  // SKIP — not inside FOV
-
-                        // 3. Basic LOS: cast a tiny ray to the key and ensure no wall is directly between
-                        // 3. Basic LOS check — raymarch from player to key
-                        Vector2 dir = to_key.normalized();
-                        float step = 0.1f;
-                        float check_distance = 0.0f;
-
-                        bool blocked = false;
-                        while (check_distance < distance)
-                        {
-                            Vector2 p = player_pos + dir * check_distance;
-                            int cx = (int)p.x;
-                            int cy = (int)p.y;
-
-                            if (get_map_value(cx, cy) == 1) {
-                                blocked = true;
-                                break;
-                            }
-                            check_distance += step;
-                        }
-
-                        if (blocked)
-                            continue;  // Key is behind a wall
-
-                        // Now render normally
-                        render_billboard(0, distance, key_pos, key_texture);
-                    }
-                }
-            }
+    // ---- Render keys and entities as billboards ----
+    for (int i = 0; i < p_count; i++) {
+        render_keys(p_frames[i]);
+        render_entities(p_frames[i]);
+    }
+
+    // ---- Transpose the column-major buffers into the images ----
+    if (p_threaded) {
+        WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &DoomRaycaster::_transpose_group, (const FrameBatch *)&batch, row_chunks, -1, true, "DoomRaycaster transpose");
+        WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+    } else {
+        for (int i = 0; i < p_count; i++) {
+            p_frames[i].kernels->transpose(p_frames[i].columns, p_frames[i].width, p_frames[i].height, p_frames[i].rows, 0, p_frames[i].height);
+        }
+    }
+}
+
+void DoomRaycaster::raycast_and_render() {
+    if (map_data.size() == 0 || !render_image.is_valid()) {
+        return;
+    }
+
+    // Main camera first, then every extra view, all in one batch
+    LocalVector<FrameState> frames;
+    frames.resize(1 + views.size());
+    if (!prepare_main_frame(frames[0], render_kernels, column_buffer, render_image, column_depth)) {
+        return;
+    }
+    int count = 1;
+    for (uint32_t i = 0; i < views.size(); i++) {
+        if (views[i].active) {
+            prepare_view_frame(frames[count++], render_kernels, views[i]);
         }
     }
+    render_frames(frames.ptr(), count, render_threaded);
+}
 
-    // ---- 12) Push image to texture ----
+void DoomRaycaster::update_textures() {
     render_texture->update(render_image);
+    for (uint32_t i = 0; i < views.size(); i++) {
+        if (views[i].active) {
+            views[i].texture->update(views[i].image);
+        }
+    }
 }
 
-int DoomRaycaster::get_map_value(int x, int y){
+int DoomRaycaster::get_map_value(int x, int y) const{
     if(x < 0 || y < 0 || x >= map_width || y >= map_height){
         return 1; // Out of bounds = wall
     }
     return map_data[y * map_width + x];
 }
 
+void DoomRaycaster::_cast_rays_group(uint32_t p_index, RayBatch *p_batch) {
+    int from = p_index * RayBatch::CHUNK_SIZE;
+    int to = MIN(from + RayBatch::CHUNK_SIZE, p_batch->count);
+    
+    for(int i = from; i < to; i++){
+        // The DDA starts from the origin's cell, so origins off the map (or NaN) are rejected
+        Vector2 origin = p_batch->origins[i];
+        if(!(origin.x >= 0.0f && origin.x < map_width && origin.y >= 0.0f && origin.y < map_height)){
+            p_batch->distances[i] = 0.0f;
+            p_batch->cells[i] = -1;
+            p_batch->sides[i] = -1;
+            continue;
+        }
+        
+        Vector2 dir = p_batch->directions[i];
+        float length = dir.length();
+        RayHit ray;
+        if(length > 0.0f){
+            dir /= length;
+            ray = trace_ray(origin.x, origin.y, dir.x, dir.y, p_batch->max_dist);
+        }
+        
+        // Hits past max_dist (the DDA can overshoot by one cell) count as misses
+        if(ray.hit && ray.dist <= p_batch->max_dist){
+            p_batch->distances[i] = MAX(ray.dist, 0.0f);
+            p_batch->cells[i] = ray.map_y * map_width + ray.map_x;
+            p_batch->sides[i] = ray.side;
+        } else {
+            p_batch->distances[i] = p_batch->max_dist;
+            p_batch->cells[i] = -1;
+            p_batch->sides[i] = -1;
+        }
+    }
+}
+
+Dictionary DoomRaycaster::cast_rays(const PackedVector2Array &p_origins, const PackedVector2Array &p_directions, float p_max_dist) const{
+    ERR_FAIL_COND_V(p_origins.size() != p_directions.size(), Dictionary());
+    
+    int count = p_origins.size();
+    PackedFloat32Array distances;
+    PackedInt32Array cells;
+    PackedInt32Array sides;
+    distances.resize(count);
+    cells.resize(count);
+    sides.resize(count);
+    
+    RayBatch batch;
+    batch.origins = p_origins.ptr();
+    batch.directions = p_directions.ptr();
+    batch.max_dist = p_max_dist;
+    batch.distances = distances.ptrw();
+    batch.cells = cells.ptrw();
+    batch.sides = sides.ptrw();
+    batch.count = count;
+    
+    int chunks = (count + RayBatch::CHUNK_SIZE - 1) / RayBatch::CHUNK_SIZE;
+    DoomRaycaster *self = const_cast<DoomRaycaster *>(this); // The group callback only reads the map
+    if(chunks > 1){
+        WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(self, &DoomRaycaster::_cast_rays_group, &batch, chunks, -1, true, "DoomRaycaster cast_rays");
+        WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+    } else if(chunks == 1){
+        self->_cast_rays_group(0, &batch);
+    }
+    
+    // cells are map indices (y * width + x); side: 0 = hit an x face, 1 = hit a y face; both -1 on a miss.
+    // Rays starting outside the map report a distance of 0 with no cell.
+    Dictionary result;
+    result["distances"] = distances;
+    result["cells"] = cells;
+    result["sides"] = sides;
+    return result;
+}
+
+bool DoomRaycaster::is_blocking_cell(int x, int y) const{
+    int value = get_map_value(x, y);
+    return value != 0 && value != 2; // Only empty cells and keys can be walked through
+}
+
+void DoomRaycaster::push_circle_out(Vector2 &r_pos, float radius) const{
+    int min_x = (int)Math::floor(r_pos.x - radius);
+    int max_x = (int)Math::floor(r_pos.x + radius);
+    int min_y = (int)Math::floor(r_pos.y - radius);
+    int max_y = (int)Math::floor(r_pos.y + radius);
+    float radius_sq = radius * radius;
+    
+    // Faces first, then corners: along a straight wall, the corner where two wall cells meet
+    // would otherwise push the circle sideways before the face in front of it is resolved
+    for(int pass = 0; pass < 2; pass++){
+        for(int cy = min_y; cy <= max_y; cy++){
+            for(int cx = min_x; cx <= max_x; cx++){
+                if(!is_blocking_cell(cx, cy)){
+                    continue;
+                }
+                
+                // Closest point of the cell square to the circle center
+                float dx = r_pos.x - CLAMP(r_pos.x, (float)cx, (float)cx + 1.0f);
+                float dy = r_pos.y - CLAMP(r_pos.y, (float)cy, (float)cy + 1.0f);
+                bool corner = dx != 0.0f && dy != 0.0f;
+                if(corner != (pass == 1)){
+                    continue;
+                }
+                float dist_sq = dx * dx + dy * dy;
+                
+                // Center inside the cell can't happen with the sub-steps in move_circle
+                if(dist_sq >= radius_sq || dist_sq < 1e-12f){
+                    continue;
+                }
+                
+                // Push out along the contact normal; motion along the wall is kept, which gives sliding
+                float dist = Math::sqrt(dist_sq);
+                float push = (radius - dist) / dist;
+                r_pos.x += dx * push;
+                r_pos.y += dy * push;
+            }
+        }
+    }
+}
+
+Vector2 DoomRaycaster::move_circle(Vector2 p_pos, Vector2 p_motion, float p_radius) const{
+    if(map_data.size() == 0){
+        return p_pos + p_motion;
+    }
+    
+    float radius = CLAMP(p_radius, 0.01f, 0.49f); // Must fit through one cell wide corridors
+    
+    // Sweep in steps of at most half the radius so fast movers can't tunnel through a wall
+    float max_step = radius * 0.5f;
+    int steps = MAX(1, (int)Math::ceil(p_motion.length() / max_step));
+    Vector2 step = p_motion / (float)steps;
+    Vector2 pos = p_pos;
+    
+    for(int i = 0; i < steps; i++){
+        // Axis separated, so a blocked axis doesn't cancel movement on the other one
+        pos.x += step.x;
+        push_circle_out(pos, radius);
+        pos.y += step.y;
+        push_circle_out(pos, radius);
+    }
+    
+    return pos;
+}
+
+PackedVector2Array DoomRaycaster::move_circles(const PackedVector2Array &p_positions, const PackedVector2Array &p_motions, float p_radius) const{
+    ERR_FAIL_COND_V(p_positions.size() != p_motions.size(), PackedVector2Array());
+    
+    PackedVector2Array result;
+    result.resize(p_positions.size());
+    
+    const Vector2 *positions = p_positions.ptr();
+    const Vector2 *motions = p_motions.ptr();
+    Vector2 *out = result.ptrw();
+    for(int i = 0; i < p_positions.size(); i++){
+        out[i] = move_circle(positions[i], motions[i], p_radius);
+    }
+    
+    return result;
+}
+
+int DoomRaycaster::add_sprite(Ref<Image> p_texture){
+    ERR_FAIL_COND_V(p_texture.is_null(), -1);
+    finish_render_task();
+    sprite_caches.push_back(TextureCache());
+    cache_texture(p_texture, sprite_caches[sprite_caches.size() - 1]);
+    return sprite_caches.size() - 1;
+}
+
+int DoomRaycaster::add_entity(Vector2 p_position, float p_radius, int p_sprite, int p_flags){
+    return entity_grid.add(p_position, p_radius, p_sprite, p_flags);
+}
+
+void DoomRaycaster::remove_entity(int p_entity){
+    entity_grid.remove(p_entity);
+}
+
+void DoomRaycaster::clear_entities(){
+    entity_grid.clear();
+}
+
+bool DoomRaycaster::has_entity(int p_entity) const{
+    return entity_grid.has(p_entity);
+}
+
+int DoomRaycaster::get_entity_count() const{
+    return entity_grid.get_count();
+}
+
+void DoomRaycaster::set_entity_position(int p_entity, Vector2 p_position){
+    entity_grid.move(p_entity, p_position);
+}
+
+Vector2 DoomRaycaster::get_entity_position(int p_entity) const{
+    ERR_FAIL_COND_V(!entity_grid.has(p_entity), Vector2());
+    return entity_grid.get(p_entity).position;
+}
+
+void DoomRaycaster::set_entity_positions(const PackedInt32Array &p_entities, const PackedVector2Array &p_positions){
+    ERR_FAIL_COND(p_entities.size() != p_positions.size());
+    const int32_t *ids = p_entities.ptr();
+    const Vector2 *positions = p_positions.ptr();
+    for(int i = 0; i < p_entities.size(); i++){
+        entity_grid.move(ids[i], positions[i]);
+    }
+}
+
+// One call per tick for all NPCs: every motion is swept against the walls with the entity's own radius
+void DoomRaycaster::move_entities(const PackedInt32Array &p_entities, const PackedVector2Array &p_motions){
+    ERR_FAIL_COND(p_entities.size() != p_motions.size());
+    const int32_t *ids = p_entities.ptr();
+    const Vector2 *motions = p_motions.ptr();
+    for(int i = 0; i < p_entities.size(); i++){
+        ERR_CONTINUE(!entity_grid.has(ids[i]));
+        const RaycasterEntityGrid::Entity &entity = entity_grid.get(ids[i]);
+        entity_grid.move(ids[i], move_circle(entity.position, motions[i], entity.radius));
+    }
+}
+
+void DoomRaycaster::set_entity_sprite(int p_entity, int p_sprite){
+    entity_grid.set_sprite(p_entity, p_sprite);
+}
+
+void DoomRaycaster::set_entity_flags(int p_entity, int p_flags){
+    entity_grid.set_flags(p_entity, p_flags);
+}
+
+int DoomRaycaster::get_entity_flags(int p_entity) const{
+    ERR_FAIL_COND_V(!entity_grid.has(p_entity), 0);
+    return entity_grid.get(p_entity).flags;
+}
+
+PackedInt32Array DoomRaycaster::query_entities(Vector2 p_center, float p_radius, int p_flags) const{
+    LocalVector<int> ids;
+    entity_grid.query_circle(p_center, p_radius, p_flags, ids);
+    
+    PackedInt32Array result;
+    result.resize(ids.size());
+    int32_t *dst = result.ptrw();
+    for(uint32_t i = 0; i < ids.size(); i++){
+        dst[i] = ids[i];
+    }
+    return result;
+}
+
+int DoomRaycaster::find_nearest_entity(Vector2 p_center, float p_max_distance, int p_flags) const{
+    return entity_grid.find_nearest(p_center, p_max_distance, p_flags);
+}
+
 void DoomRaycaster::set_map(const Array &p_map, int p_width, int p_height){
+    finish_render_task();
     map_width = p_width;
     map_height = p_height;
     map_data.clear();
@@ -657,10 +1606,581 @@ void DoomRaycaster::set_map(const Array &p_map, int p_width, int p_height){
     }
     
     print_line("DoomRaycaster: Map set - " + itos(map_width) + "x" + itos(map_height) + " = " + itos(map_data.size()) + " cells");
+    map_changed();
+}
+
+// Map files don't store sizes, every entity they spawn gets this radius
+static const float MAP_ENTITY_RADIUS = 0.25f;
+
+void DoomRaycaster::set_map_resource(const Ref<RaycasterMap> &p_map){
+    ERR_FAIL_COND(p_map.is_null());
+    finish_render_task();
+    map_width = p_map->get_width();
+    map_height = p_map->get_height();
+    collected_keys.clear();
+    
+    const uint8_t *cells = p_map->get_cell_data();
+    map_data.resize(map_width * map_height);
+    int *dst = map_data.ptrw();
+    for(int i = 0; i < map_data.size(); i++){
+        dst[i] = cells[i];
+    }
+    
+    print_line("DoomRaycaster: Map resource set - " + itos(map_width) + "x" + itos(map_height) + ", " + itos(p_map->get_entity_count()) + " entities");
+    map_changed();
+    
+    // The map's entities replace the current ones: the type picks the sprite and the value holds
+    // the EntityFlags. Ids follow the map's table, so entity i of the map is entity i here.
+    clear_entities();
+    for (int i = 0; i < p_map->get_entity_count(); i++) {
+        const RaycasterMap::Entity &entity = p_map->get_entity_data(i);
+        add_entity(entity.position, MAP_ENTITY_RADIUS, entity.type, entity.value);
+    }
+}
+
+// Rebuilds everything derived from the walls after the whole map was replaced
+void DoomRaycaster::map_changed(){
+    invalidate_angle_cache();
+    entity_grid.resize(map_width, map_height);
+    build_wall_segments();
+    pvs_bits.clear();
+    if (pvs_enabled) {
+        queue_pvs_build();
+    }
+    
+    // Every light's flood fill depends on the walls
+    light_grid.clear();
+    for (uint32_t i = 0; i < lights.size(); i++) {
+        if (lights[i].active) {
+            lights[i].dirty = true;
+        }
+    }
+    lights_dirty = true;
+}
+
+void DoomRaycaster::set_map_cell(Vector2i p_cell, int p_value){
+    ERR_FAIL_COND(p_cell.x < 0 || p_cell.y < 0 || p_cell.x >= map_width || p_cell.y >= map_height);
+    ERR_FAIL_COND(p_cell.y * map_width + p_cell.x >= map_data.size());
+    finish_render_task();
+    int index = p_cell.y * map_width + p_cell.x;
+    if (map_data[index] == p_value) {
+        return;
+    }
+    map_data.write[index] = p_value;
+    
+    invalidate_angle_cache();
+    build_wall_segments();
+    
+    // Everything stays visible until the rebuild on the pool is swapped in
+    pvs_bits.clear();
+    if (pvs_enabled) {
+        queue_pvs_build();
+    }
+    
+    // Only lights that can reach the cell change; their old region is summed again after propagating
+    for (uint32_t i = 0; i < lights.size(); i++) {
+        if (lights[i].active && lights[i].get_box().has_point(p_cell)) {
+            mark_light_dirty(lights[i]);
+        }
+    }
+    mark_light_rect(Rect2i(p_cell, Vector2i(1, 1)));
+}
+
+void DoomRaycaster::mark_light_rect(const Rect2i &p_rect){
+    light_dirty_rect = light_dirty_rect.has_area() ? light_dirty_rect.merge(p_rect) : p_rect;
+    lights_dirty = true;
+}
+
+void DoomRaycaster::mark_light_dirty(GridLight &r_light){
+    r_light.dirty = true;
+    mark_light_rect(r_light.get_box());
+}
+
+// Breadth-first flood fill through open cells; the level falls off linearly with the step count
+void DoomRaycaster::propagate_light(GridLight &r_light) const{
+    const int size = r_light.radius * 2 + 1;
+    const Vector2i origin = r_light.cell - Vector2i(r_light.radius, r_light.radius);
+    r_light.levels.resize(size * size);
+    for (uint32_t i = 0; i < r_light.levels.size(); i++) {
+        r_light.levels[i] = 0.0f;
+    }
+    if (get_map_value(r_light.cell.x, r_light.cell.y) == 1) {
+        return; // Inside a wall
+    }
+    
+    LocalVector<int> steps;
+    steps.resize(size * size);
+    for (uint32_t i = 0; i < steps.size(); i++) {
+        steps[i] = -1;
+    }
+    LocalVector<int> queue;
+    queue.reserve(size * size);
+    
+    int start = r_light.radius * size + r_light.radius;
+    steps[start] = 0;
+    queue.push_back(start);
+    
+    static const int NEIGHBORS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+    const float falloff = r_light.intensity / (r_light.radius + 1);
+    for (uint32_t head = 0; head < queue.size(); head++) {
+        int local = queue[head];
+        int lx = local % size;
+        int ly = local / size;
+        r_light.levels[local] = r_light.intensity - falloff * steps[local];
+        if (steps[local] == r_light.radius) {
+            continue;
+        }
+        
+        for (int n = 0; n < 4; n++) {
+            int nx = lx + NEIGHBORS[n][0];
+            int ny = ly + NEIGHBORS[n][1];
+            if (nx < 0 || ny < 0 || nx >= size || ny >= size) {
+                continue;
+            }
+            int next = ny * size + nx;
+            if (steps[next] >= 0 || get_map_value(origin.x + nx, origin.y + ny) == 1) {
+                continue;
+            }
+            steps[next] = steps[local] + 1;
+            queue.push_back(next);
+        }
+    }
+}
+
+void DoomRaycaster::_bake_light_group(uint32_t p_index, const int *p_lights){
+    propagate_light(lights[p_lights[p_index]]);
+}
+
+// Propagates the lights that changed (in parallel), then sums levels again only inside the changed region
+void DoomRaycaster::bake_lights(){
+    if (!lights_dirty) {
+        return;
+    }
+    lights_dirty = false;
+    
+    int cell_count = map_width * map_height;
+    if (light_grid.size() != (uint32_t)cell_count) {
+        light_grid.resize(cell_count);
+        light_dirty_rect = Rect2i(0, 0, map_width, map_height);
+    }
+    
+    LocalVector<int> changed;
+    for (uint32_t i = 0; i < lights.size(); i++) {
+        if (lights[i].active && lights[i].dirty) {
+            lights[i].dirty = false;
+            changed.push_back(i);
+            light_dirty_rect = light_dirty_rect.has_area() ? light_dirty_rect.merge(lights[i].get_box()) : lights[i].get_box();
+        }
+    }
+    if (changed.size() > 1) {
+        WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &DoomRaycaster::_bake_light_group, (const int *)changed.ptr(), changed.size(), -1, true, "DoomRaycaster lights");
+        WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+    } else if (changed.size() == 1) {
+        propagate_light(lights[changed[0]]);
+    }
+    
+    Rect2i rect = light_dirty_rect.intersection(Rect2i(0, 0, map_width, map_height));
+    light_dirty_rect = Rect2i();
+    for (int y = rect.position.y; y < rect.get_end().y; y++) {
+        for (int x = rect.position.x; x < rect.get_end().x; x++) {
+            float level = ambient_light;
+            for (uint32_t i = 0; i < lights.size(); i++) {
+                const GridLight &light = lights[i];
+                if (!light.active) {
+                    continue;
+                }
+                Vector2i local = Vector2i(x, y) - light.cell + Vector2i(light.radius, light.radius);
+                int size = light.radius * 2 + 1;
+                if (local.x >= 0 && local.y >= 0 && local.x < size && local.y < size) {
+                    level += light.levels[local.y * size + local.x];
+                }
+            }
+            light_grid[y * map_width + x] = level;
+        }
+    }
+}
+
+void DoomRaycaster::set_lighting_enabled(bool p_enabled){
+    finish_render_task();
+    lighting_enabled = p_enabled;
+}
+
+bool DoomRaycaster::is_lighting_enabled() const{
+    return lighting_enabled;
+}
+
+void DoomRaycaster::set_ambient_light(float p_level){
+    finish_render_task();
+    ambient_light = MAX(0.0f, p_level);
+    mark_light_rect(Rect2i(0, 0, map_width, map_height));
+}
+
+float DoomRaycaster::get_ambient_light() const{
+    return ambient_light;
+}
+
+int DoomRaycaster::add_light(Vector2i p_cell, float p_intensity, int p_radius){
+    ERR_FAIL_COND_V_MSG(p_radius < 1 || p_radius > MAX_LIGHT_RADIUS, -1, "DoomRaycaster: Light radius must be between 1 and " + itos(MAX_LIGHT_RADIUS) + ".");
+    ERR_FAIL_COND_V_MSG(!(p_intensity >= 0.0f), -1, "DoomRaycaster: Light intensity must not be negative.");
+    finish_render_task();
+    
+    uint32_t index = 0;
+    while (index < lights.size() && lights[index].active) {
+        index++;
+    }
+    if (index == lights.size()) {
+        lights.push_back(GridLight());
+    }
+    
+    GridLight &light = lights[index];
+    light.active = true;
+    light.cell = p_cell;
+    light.intensity = p_intensity;
+    light.radius = p_radius;
+    mark_light_dirty(light);
+    return index;
+}
+
+void DoomRaycaster::set_light(int p_light, Vector2i p_cell, float p_intensity, int p_radius){
+    ERR_FAIL_INDEX(p_light, (int)lights.size());
+    ERR_FAIL_COND(!lights[p_light].active);
+    ERR_FAIL_COND_MSG(p_radius < 1 || p_radius > MAX_LIGHT_RADIUS, "DoomRaycaster: Light radius must be between 1 and " + itos(MAX_LIGHT_RADIUS) + ".");
+    ERR_FAIL_COND_MSG(!(p_intensity >= 0.0f), "DoomRaycaster: Light intensity must not be negative.");
+    finish_render_task();
+    
+    // The old footprint goes dark, the new one lights up
+    GridLight &light = lights[p_light];
+    mark_light_rect(light.get_box());
+    light.cell = p_cell;
+    light.intensity = p_intensity;
+    light.radius = p_radius;
+    mark_light_dirty(light);
+}
+
+void DoomRaycaster::remove_light(int p_light){
+    ERR_FAIL_INDEX(p_light, (int)lights.size());
+    ERR_FAIL_COND(!lights[p_light].active);
+    finish_render_task();
+    mark_light_rect(lights[p_light].get_box());
+    lights[p_light] = GridLight();
+}
+
+float DoomRaycaster::get_light_level(Vector2i p_cell){
+    ERR_FAIL_COND_V(p_cell.x < 0 || p_cell.y < 0 || p_cell.x >= map_width || p_cell.y >= map_height, 0.0f);
+    finish_render_task();
+    bake_lights();
+    return light_grid[p_cell.y * map_width + p_cell.x];
+}
+
+// Shortest distance between two grid cells (0 for neighbors)
+static _FORCE_INLINE_ float pvs_cell_gap(int p_from_x, int p_from_y, int p_to_x, int p_to_y) {
+    float dx = MAX(Math::abs(p_to_x - p_from_x) - 1, 0);
+    float dy = MAX(Math::abs(p_to_y - p_from_y) - 1, 0);
+    return Math::sqrt(dx * dx + dy * dy);
+}
+
+// True when a whole column (or row) of walls spans the box around two cells. Any segment between
+// the cells crosses that column inside the box, so every sample would stop at it.
+bool DoomRaycaster::is_pvs_corridor_blocked(const PVSBuild &p_build, int p_from_x, int p_from_y, int p_to_x, int p_to_y) {
+    const int width = p_build.width;
+    const int min_x = MIN(p_from_x, p_to_x);
+    const int max_x = MAX(p_from_x, p_to_x);
+    const int min_y = MIN(p_from_y, p_to_y);
+    const int max_y = MAX(p_from_y, p_to_y);
+    
+    const int *column_walls = p_build.column_walls.ptr();
+    for (int x = min_x + 1; x < max_x; x++) {
+        if (column_walls[(max_y + 1) * width + x] - column_walls[min_y * width + x] == max_y - min_y + 1) {
+            return true;
+        }
+    }
+    const int *row_walls = p_build.row_walls.ptr();
+    for (int y = min_y + 1; y < max_y; y++) {
+        if (row_walls[y * (width + 1) + max_x + 1] - row_walls[y * (width + 1) + min_x] == max_x - min_x + 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DoomRaycaster::_build_pvs_row(uint32_t p_index, PVSBuild *p_build) {
+    const int *cells = p_build->cells.ptr();
+    const int width = p_build->width;
+    const int height = p_build->height;
+    const int cell_count = width * height;
+    const int words = p_build->words;
+    int from_x = p_index % width;
+    int from_y = p_index / width;
+    uint64_t *row = p_build->bits.ptr() + (uint64_t)p_index * words;
+    
+    // Rows of wall cells are never queried (is_cell_visible treats them as seeing everything)
+    if (cells[p_index] == 1 || p_build->cancelled.is_set()) {
+        return;
+    }
+    
+    // Flood fill the open cells around the source; only the cells it reaches are traced. A line of
+    // sight crosses open cells only, and the DDA steps between edge neighbors, so the fill finds
+    // every cell that can be seen. It runs 3 cells past the render distance because a line of
+    // sight to a cell in range can pass cells up to two cell diagonals farther out.
+    const float max_dist = p_build->max_dist;
+    const float fill_dist = max_dist + 3.0f;
+    static const int NEIGHBORS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+    LocalVector<uint64_t> reached;
+    reached.resize(words);
+    memset(reached.ptr(), 0, words * sizeof(uint64_t));
+    LocalVector<int> candidates;
+    candidates.push_back(p_index);
+    reached[p_index >> 6] |= (uint64_t)1 << (p_index & 63);
+    for (uint32_t head = 0; head < candidates.size(); head++) {
+        int cell_x = candidates[head] % width;
+        int cell_y = candidates[head] / width;
+        for (int n = 0; n < 4; n++) {
+            int x = cell_x + NEIGHBORS[n][0];
+            int y = cell_y + NEIGHBORS[n][1];
+            if (x < 0 || y < 0 || x >= width || y >= height) {
+                continue;
+            }
+            int neighbor = y * width + x;
+            if (cells[neighbor] == 1 || ((reached[neighbor >> 6] >> (neighbor & 63)) & 1) || pvs_cell_gap(from_x, from_y, x, y) > fill_dist) {
+                continue;
+            }
+            reached[neighbor >> 6] |= (uint64_t)1 << (neighbor & 63);
+            candidates.push_back(neighbor);
+        }
+    }
+    
+    // Points around the inset border of a cell. Any clear segment between two open cells can be
+    // shortened to one between their borders, so dense border samples miss only grazing lines
+    // of sight; the dilation below covers those.
+    static const int SAMPLE_COUNT = 12;
+    static const float SAMPLE_OFFSETS[SAMPLE_COUNT][2] = {
+        { 0.01f, 0.01f }, { 0.34f, 0.01f }, { 0.66f, 0.01f },
+        { 0.99f, 0.01f }, { 0.99f, 0.34f }, { 0.99f, 0.66f },
+        { 0.99f, 0.99f }, { 0.66f, 0.99f }, { 0.34f, 0.99f },
+        { 0.01f, 0.99f }, { 0.01f, 0.66f }, { 0.01f, 0.34f },
+    };
+    
+    LocalVector<uint64_t> direct;
+    direct.resize(words);
+    memset(direct.ptr(), 0, words * sizeof(uint64_t));
+    
+    for (uint32_t i = 0; i < candidates.size(); i++) {
+        int to = candidates[i];
+        int to_x = to % width;
+        int to_y = to / width;
+        
+        bool visible = (int)p_index == to;
+        if (!visible && (pvs_cell_gap(from_x, from_y, to_x, to_y) > max_dist || is_pvs_corridor_blocked(*p_build, from_x, from_y, to_x, to_y))) {
+            continue;
+        }
+        for (int a = 0; a < SAMPLE_COUNT && !visible; a++) {
+            Vector2 from_point(from_x + SAMPLE_OFFSETS[a][0], from_y + SAMPLE_OFFSETS[a][1]);
+            for (int b = 0; b < SAMPLE_COUNT && !visible; b++) {
+                Vector2 to_point(to_x + SAMPLE_OFFSETS[b][0], to_y + SAMPLE_OFFSETS[b][1]);
+                Vector2 delta = to_point - from_point;
+                float length = delta.length();
+                RayHit ray = trace_grid(cells, cell_count, width, height, from_point.x, from_point.y, delta.x / length, delta.y / length, length);
+                visible = !ray.hit || ray.dist >= length;
+            }
+        }
+        
+        if (visible) {
+            direct[to >> 6] |= (uint64_t)1 << (to & 63);
+        }
+    }
+    
+    // Grow the row by one open cell in every direction, so objects standing next to a
+    // visible cell (or seen only through a gap between samples) are never culled
+    for (uint32_t i = 0; i < candidates.size(); i++) {
+        int to = candidates[i];
+        if (!((direct[to >> 6] >> (to & 63)) & 1)) {
+            continue;
+        }
+        int to_x = to % width;
+        int to_y = to / width;
+        for (int y = MAX(to_y - 1, 0); y <= MIN(to_y + 1, height - 1); y++) {
+            for (int x = MAX(to_x - 1, 0); x <= MIN(to_x + 1, width - 1); x++) {
+                int neighbor = y * width + x;
+                if (cells[neighbor] != 1) {
+                    row[neighbor >> 6] |= (uint64_t)1 << (neighbor & 63);
+                }
+            }
+        }
+    }
+}
+
+// Starts a rebuild on the pool. A build that is already running traced an older map: its
+// remaining rows are dropped and it starts over once it ends.
+void DoomRaycaster::queue_pvs_build() {
+    int cell_count = map_width * map_height;
+    if (cell_count == 0 || map_data.size() < cell_count) {
+        return;
+    }
+    ERR_FAIL_COND_MSG(cell_count > PVS_MAX_CELLS, "DoomRaycaster: Map too large for a PVS (" + itos(cell_count) + " cells, max " + itos(PVS_MAX_CELLS) + ").");
+    
+    if (pvs_group != -1) {
+        pvs_build.cancelled.set();
+        pvs_rebuild_pending = true;
+    } else {
+        start_pvs_build(false);
+    }
+}
+
+// Snapshots the map and queues one task per source row, so tasks never write the same words
+void DoomRaycaster::start_pvs_build(bool p_high_priority) {
+    int cell_count = map_width * map_height;
+    pvs_build.cells = map_data;
+    pvs_build.width = map_width;
+    pvs_build.height = map_height;
+    pvs_build.words = (cell_count + 63) / 64;
+    pvs_build.max_dist = render_distance;
+    pvs_build.cancelled.clear();
+    
+    // Wall counts for the blocked corridor test
+    const int *cells = map_data.ptr();
+    pvs_build.column_walls.resize((map_height + 1) * map_width);
+    pvs_build.row_walls.resize(map_height * (map_width + 1));
+    for (int x = 0; x < map_width; x++) {
+        pvs_build.column_walls[x] = 0;
+    }
+    for (int y = 0; y < map_height; y++) {
+        pvs_build.row_walls[y * (map_width + 1)] = 0;
+        for (int x = 0; x < map_width; x++) {
+            int wall = cells[y * map_width + x] == 1 ? 1 : 0;
+            pvs_build.column_walls[(y + 1) * map_width + x] = pvs_build.column_walls[y * map_width + x] + wall;
+            pvs_build.row_walls[y * (map_width + 1) + x + 1] = pvs_build.row_walls[y * (map_width + 1) + x] + wall;
+        }
+    }
+    
+    pvs_build.bits.resize((uint64_t)cell_count * pvs_build.words);
+    memset(pvs_build.bits.ptr(), 0, pvs_build.bits.size() * sizeof(uint64_t));
+    pvs_group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &DoomRaycaster::_build_pvs_row, &pvs_build, cell_count, -1, p_high_priority, "DoomRaycaster PVS");
+}
+
+// Waits for the running build and swaps its rows in, unless a cell changed meanwhile
+void DoomRaycaster::finish_pvs_build() {
+    if (pvs_group == -1) {
+        return;
+    }
+    WorkerThreadPool::get_singleton()->wait_for_group_task_completion(pvs_group);
+    pvs_group = -1;
+    
+    if (pvs_rebuild_pending) {
+        pvs_rebuild_pending = false;
+        start_pvs_build(false);
+        return;
+    }
+    
+    // The renderer reads the rows while culling sprites
+    finish_render_task();
+    pvs_words = pvs_build.words;
+    SWAP(pvs_bits, pvs_build.bits);
+    pvs_build.bits.clear();
+    pvs_build.cells.clear();
+    pvs_build.column_walls.clear();
+    pvs_build.row_walls.clear();
+}
+
+void DoomRaycaster::cancel_pvs_build() {
+    if (pvs_group != -1) {
+        pvs_build.cancelled.set();
+        WorkerThreadPool::get_singleton()->wait_for_group_task_completion(pvs_group);
+        pvs_group = -1;
+    }
+    pvs_rebuild_pending = false;
+    pvs_build.bits.clear();
+    pvs_build.cells.clear();
+    pvs_build.column_walls.clear();
+    pvs_build.row_walls.clear();
+}
+
+void DoomRaycaster::poll_pvs_build() {
+    if (pvs_group != -1 && WorkerThreadPool::get_singleton()->is_group_task_completed(pvs_group)) {
+        finish_pvs_build();
+    }
+}
+
+// Builds the PVS right away, or waits for the build running in the background
+void DoomRaycaster::build_pvs() {
+    finish_render_task();
+    uint64_t start = OS::get_singleton()->get_ticks_usec();
+    if (pvs_group == -1) {
+        int cell_count = map_width * map_height;
+        if (cell_count == 0 || map_data.size() < cell_count) {
+            return;
+        }
+        ERR_FAIL_COND_MSG(cell_count > PVS_MAX_CELLS, "DoomRaycaster: Map too large for a PVS (" + itos(cell_count) + " cells, max " + itos(PVS_MAX_CELLS) + ").");
+        pvs_bits.clear();
+        start_pvs_build(true);
+    }
+    
+    // Finishing a build a cell changed during starts the next one
+    while (pvs_group != -1) {
+        finish_pvs_build();
+    }
+    
+    print_line("DoomRaycaster: PVS built - " + itos(map_width * map_height) + " cells in " + itos((OS::get_singleton()->get_ticks_usec() - start) / 1000) + " ms");
+}
+
+bool DoomRaycaster::is_cell_visible(Vector2i p_from, Vector2i p_to) const{
+    // Without a PVS everything is potentially visible
+    if (pvs_bits.is_empty()) {
+        return true;
+    }
+    if (p_from.x < 0 || p_from.y < 0 || p_from.x >= map_width || p_from.y >= map_height) {
+        return true;
+    }
+    if (p_to.x < 0 || p_to.y < 0 || p_to.x >= map_width || p_to.y >= map_height) {
+        return false;
+    }
+    
+    int from = p_from.y * map_width + p_from.x;
+    int to = p_to.y * map_width + p_to.x;
+    if (map_data[from] == 1) {
+        return true; // No row was baked for walls
+    }
+    return (pvs_bits[(uint64_t)from * pvs_words + (to >> 6)] >> (to & 63)) & 1;
+}
+
+PackedInt32Array DoomRaycaster::get_visible_cells(Vector2i p_from) const{
+    PackedInt32Array cells;
+    ERR_FAIL_COND_V_MSG(pvs_bits.is_empty(), cells, "DoomRaycaster: No PVS built, enable it with set_pvs_enabled() (it is rebuilt in the background after set_map_cell()).");
+    ERR_FAIL_COND_V(p_from.x < 0 || p_from.y < 0 || p_from.x >= map_width || p_from.y >= map_height, cells);
+    
+    const uint64_t *row = pvs_bits.ptr() + (uint64_t)(p_from.y * map_width + p_from.x) * pvs_words;
+    int cell_count = map_width * map_height;
+    for (int to = 0; to < cell_count; to++) {
+        if (row[to >> 6] == 0) {
+            to |= 63; // Skip empty words
+            continue;
+        }
+        if ((row[to >> 6] >> (to & 63)) & 1) {
+            cells.push_back(to);
+        }
+    }
+    return cells;
+}
+
+void DoomRaycaster::set_pvs_enabled(bool p_enabled){
+    pvs_enabled = p_enabled;
+    if (!pvs_enabled) {
+        finish_render_task();
+        cancel_pvs_build();
+        pvs_bits.clear();
+    } else if (pvs_bits.is_empty() && pvs_group == -1) {
+        queue_pvs_build();
+    }
+}
+
+bool DoomRaycaster::is_pvs_enabled() const{
+    return pvs_enabled;
 }
 
 void DoomRaycaster::set_player_position(Vector2 p_pos){
+    finish_render_task();
     player_pos = p_pos;
+    prev_player_pos = p_pos; // Teleport, don't interpolate from the old spot
+    view_pos = p_pos;
     print_line("DoomRaycaster: Player position set to (" + rtos(p_pos.x) + ", " + rtos(p_pos.y) + ")");
 }
 
@@ -669,7 +2189,10 @@ Vector2 DoomRaycaster::get_player_position() const{
 }
 
 void DoomRaycaster::set_player_angle(float p_angle){
+    finish_render_task();
     player_angle = p_angle;
+    prev_player_angle = p_angle;
+    view_angle = p_angle;
 }
 
 float DoomRaycaster::get_player_angle() const{
@@ -677,79 +2200,112 @@ float DoomRaycaster::get_player_angle() const{
 }
 
 void DoomRaycaster::set_screen_size(int p_width, int p_height){
+    finish_render_task();
     screen_width = p_width;
     screen_height = p_height;
     if (render_image.is_valid()) {
-        render_image->initialize_data(screen_width, screen_height, false, Image::FORMAT_RGB8);
+        render_image->initialize_data(screen_width, screen_height, false, Image::FORMAT_RGBA8);
         render_texture->set_image(render_image);
     }
 }
 
 void DoomRaycaster::set_fov(float p_fov){
+    finish_render_task();
     fov = p_fov;
 }
 
 void DoomRaycaster::set_render_distance(float p_distance){
+    finish_render_task();
+    if (render_distance == p_distance) {
+        return;
+    }
     render_distance = p_distance;
+    
+    // The PVS culls cells past the render distance
+    if (pvs_enabled) {
+        pvs_bits.clear();
+        queue_pvs_build();
+    }
 }
 
 void DoomRaycaster::set_wall_color(Color p_color){
+    finish_render_task();
     wall_color = p_color;
 }
 
 void DoomRaycaster::set_floor_color(Color p_color){
+    finish_render_task();
     floor_color = p_color;
 }
 
 void DoomRaycaster::set_ceiling_color(Color p_color){
+    finish_render_task();
     ceiling_color = p_color;
 }
 
 void DoomRaycaster::set_wall_texture(Ref<Image> p_texture){
+    finish_render_task();
     wall_texture = p_texture;
+    cache_texture(wall_texture, wall_cache);
     if(wall_texture.is_valid()){
         print_line("DoomRaycaster: Wall texture set - " + itos(wall_texture->get_width()) + "x" + itos(wall_texture->get_height()));
     }
 }
 
 void DoomRaycaster::set_floor_texture(Ref<Image> p_texture){
+    finish_render_task();
     floor_texture = p_texture;
+    cache_texture(floor_texture, floor_cache);
     if(floor_texture.is_valid()){
         print_line("DoomRaycaster: Floor texture set - " + itos(floor_texture->get_width()) + "x" + itos(floor_texture->get_height()));
     }
 }
 
 void DoomRaycaster::set_ceiling_texture(Ref<Image> p_texture){
+    finish_render_task();
     ceiling_texture = p_texture;
+    cache_texture(ceiling_texture, sky_cache);
+    invalidate_sky_strips();
     if(ceiling_texture.is_valid()){
         print_line("DoomRaycaster: Ceiling texture set (skybox cylinder) - " + itos(ceiling_texture->get_width()) + "x" + itos(ceiling_texture->get_height()));
     }
 }
 
 void DoomRaycaster::set_key_texture(Ref<Image> p_texture){
+    finish_render_task();
     key_texture = p_texture;
+    cache_texture(key_texture, key_cache);
     if(key_texture.is_valid()){
         print_line("DoomRaycaster: Key texture set - " + itos(key_texture->get_width()) + "x" + itos(key_texture->get_height()));
     }
 }
 
 void DoomRaycaster::clear_wall_texture(){
+    finish_render_task();
     wall_texture.unref();
+    cache_texture(wall_texture, wall_cache);
     print_line("DoomRaycaster: Wall texture cleared");
 }
 
 void DoomRaycaster::clear_floor_texture(){
+    finish_render_task();
     floor_texture.unref();
+    cache_texture(floor_texture, floor_cache);
     print_line("DoomRaycaster: Floor texture cleared");
 }
 
 void DoomRaycaster::clear_ceiling_texture(){
+    finish_render_task();
     ceiling_texture.unref();
+    cache_texture(ceiling_texture, sky_cache);
+    invalidate_sky_strips();
     print_line("DoomRaycaster: Ceiling texture cleared");
 }
 
 void DoomRaycaster::clear_key_texture(){
+    finish_render_task();
     key_texture.unref();
+    cache_texture(key_texture, key_cache);
     print_line("DoomRaycaster: Key texture cleared");
 }
 
@@ -763,4 +2319,597 @@ void DoomRaycaster::set_rotation_speed(float p_speed){
 
 void DoomRaycaster::set_skybox_radius(float p_radius){
     skybox_radius = p_radius;
-}
\ No newline at end of file
+}
+
+void DoomRaycaster::set_threaded_render(bool p_enabled){
+    if (!p_enabled) {
+        finish_render_task();
+    }
+    threaded_render = p_enabled;
+}
+
+bool DoomRaycaster::is_threaded_render() const{
+    return threaded_render;
+}
+
+void DoomRaycaster::set_player_radius(float p_radius){
+    player_radius = p_radius;
+}
+
+float DoomRaycaster::get_player_radius() const{
+    return player_radius;
+}
+
+void DoomRaycaster::resolve_backend(RenderBackend p_backend, const RaycasterKernels *&r_kernels, bool &r_threaded) const{
+    uint32_t features = raycaster_get_cpu_features();
+    r_kernels = raycaster_get_scalar_kernels();
+    r_threaded = false;
+    
+    switch (p_backend) {
+        case RENDER_BACKEND_AUTO: {
+            r_kernels = raycaster_get_best_kernels();
+            r_threaded = WorkerThreadPool::get_singleton() && WorkerThreadPool::get_singleton()->get_thread_count() > 1;
+        } break;
+        case RENDER_BACKEND_SCALAR: {
+        } break;
+        case RENDER_BACKEND_SSE2: {
+            ERR_FAIL_COND_MSG(!(features & RAYCASTER_CPU_SSE2) || !raycaster_get_sse2_kernels(), "DoomRaycaster: SSE2 backend not supported on this CPU, using scalar.");
+            r_kernels = raycaster_get_sse2_kernels();
+        } break;
+        case RENDER_BACKEND_AVX2: {
+            ERR_FAIL_COND_MSG(!(features & RAYCASTER_CPU_AVX2) || !raycaster_get_avx2_kernels(), "DoomRaycaster: AVX2 backend not supported on this CPU, using scalar.");
+            r_kernels = raycaster_get_avx2_kernels();
+        } break;
+        case RENDER_BACKEND_NEON: {
+            ERR_FAIL_COND_MSG(!(features & RAYCASTER_CPU_NEON) || !raycaster_get_neon_kernels(), "DoomRaycaster: NEON backend not supported on this CPU, using scalar.");
+            r_kernels = raycaster_get_neon_kernels();
+        } break;
+        case RENDER_BACKEND_THREADED: {
+            r_kernels = raycaster_get_best_kernels();
+            r_threaded = true;
+        } break;
+    }
+}
+
+void DoomRaycaster::set_render_backend(RenderBackend p_backend){
+    ERR_FAIL_INDEX((int)p_backend, (int)RENDER_BACKEND_THREADED + 1);
+    finish_render_task();
+    render_backend = p_backend;
+    resolve_backend(render_backend, render_kernels, render_threaded);
+    print_line("DoomRaycaster: Render backend - " + get_render_backend_name());
+}
+
+DoomRaycaster::RenderBackend DoomRaycaster::get_render_backend() const{
+    return render_backend;
+}
+
+String DoomRaycaster::get_render_backend_name() const{
+    String name = render_kernels ? render_kernels->name : "none";
+    return render_threaded ? "threaded (" + name + ")" : name;
+}
+
+void DoomRaycaster::invalidate_sky_strips(){
+    sky_strip.rows = 0;
+    for (uint32_t i = 0; i < views.size(); i++) {
+        views[i].sky_strip.rows = 0;
+    }
+}
+
+int DoomRaycaster::add_view(Vector2 p_position, float p_angle, float p_fov, Vector2i p_size){
+    ERR_FAIL_COND_V_MSG(p_size.x <= 0 || p_size.y <= 0 || p_size.x > MAX_VIEW_SIZE || p_size.y > MAX_VIEW_SIZE, -1, "DoomRaycaster: Invalid view size.");
+    ERR_FAIL_COND_V_MSG(p_fov <= 0.0f || p_fov >= 180.0f, -1, "DoomRaycaster: View fov must be between 0 and 180 degrees.");
+    finish_render_task();
+    
+    // Reuse a removed slot so view ids stay small and stable
+    uint32_t index = 0;
+    while (index < views.size() && views[index].active) {
+        index++;
+    }
+    if (index == views.size()) {
+        views.push_back(RenderView());
+    }
+    
+    RenderView &view = views[index];
+    view = RenderView();
+    view.active = true;
+    view.pos = p_position;
+    view.angle = p_angle;
+    view.render_pos = p_position;
+    view.render_angle = p_angle;
+    view.fov = p_fov;
+    view.width = p_size.x;
+    view.height = p_size.y;
+    
+    // Same projection as the main tables, built for this size and fov
+    float center = view.width * 0.5f;
+    int mid = view.height / 2;
+    view.column_angles.resize(view.width);
+    view.floor_ray_x.resize(view.width);
+    view.floor_ray_y.resize(view.width);
+    view.row_dist.resize(view.height);
+    if (view.width == RENDER_WIDTH && view.height == RENDER_HEIGHT && Math::deg_to_rad(p_fov) * 0.5f == -RAY_ANGLE[0]) {
+        // The main camera's own tables, so both render the same pixels from the same pose
+        memcpy(view.column_angles.ptr(), RAY_ANGLE, sizeof(RAY_ANGLE));
+        memcpy(view.floor_ray_x.ptr(), FLOOR_RAY_X, sizeof(FLOOR_RAY_X));
+        memcpy(view.floor_ray_y.ptr(), FLOOR_RAY_Y, sizeof(FLOOR_RAY_Y));
+        memcpy(view.row_dist.ptr(), ROW_DIST, sizeof(ROW_DIST));
+        view.columns_per_tan = center / Math::tan(-RAY_ANGLE[0]);
+    } else {
+        view.columns_per_tan = center / Math::tan(Math::deg_to_rad(p_fov) * 0.5f);
+        for (int x = 0; x < view.width; x++) {
+            float angle = Math::atan((x - center) / view.columns_per_tan);
+            view.column_angles[x] = angle;
+            view.floor_ray_x[x] = Math::sin(angle);
+            view.floor_ray_y[x] = Math::cos(angle);
+        }
+        for (int y = 0; y < view.height; y++) {
+            view.row_dist[y] = y == mid ? 0.0f : view.columns_per_tan / (y - mid);
+        }
+    }
+    // The edge columns are the closest together; narrow fovs keep their exact angles
+    view.angle_bins = view.width > 1 && view.column_angles[1] - view.column_angles[0] >= (float)(Math_TAU / ANGLE_CACHE_BINS);
+    
+    view.image.instantiate();
+    view.image->initialize_data(view.width, view.height, false, Image::FORMAT_RGBA8);
+    view.texture.instantiate();
+    view.texture->set_image(view.image);
+    
+    print_line("DoomRaycaster: View " + itos(index) + " added - " + itos(view.width) + "x" + itos(view.height));
+    return index;
+}
+
+void DoomRaycaster::remove_view(int p_view){
+    ERR_FAIL_INDEX(p_view, (int)views.size());
+    ERR_FAIL_COND(!views[p_view].active);
+    finish_render_task();
+    views[p_view] = RenderView();
+}
+
+void DoomRaycaster::set_view_pose(int p_view, Vector2 p_position, float p_angle){
+    ERR_FAIL_INDEX(p_view, (int)views.size());
+    ERR_FAIL_COND(!views[p_view].active);
+    // Picked up by the next frame; a frame in flight keeps the pose it started with
+    views[p_view].pos = p_position;
+    views[p_view].angle = p_angle;
+}
+
+Ref<ImageTexture> DoomRaycaster::get_view_texture(int p_view) const{
+    ERR_FAIL_INDEX_V(p_view, (int)views.size(), Ref<ImageTexture>());
+    return views[p_view].texture;
+}
+
+Ref<Image> DoomRaycaster::get_view_image(int p_view){
+    ERR_FAIL_INDEX_V(p_view, (int)views.size(), Ref<Image>());
+    ERR_FAIL_COND_V(!views[p_view].active, Ref<Image>());
+    finish_render_task();
+    return views[p_view].image;
+}
+
+int DoomRaycaster::get_view_count() const{
+    int count = 0;
+    for (uint32_t i = 0; i < views.size(); i++) {
+        if (views[i].active) {
+            count++;
+        }
+    }
+    return count;
+}
+
+Error DoomRaycaster::start_recording(const String &p_path){
+    ERR_FAIL_COND_V_MSG(replaying, ERR_BUSY, "DoomRaycaster: Cannot record while a replay is running.");
+    stop_recording();
+    
+    Error err;
+    record_file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+    ERR_FAIL_COND_V_MSG(err != OK, err, "DoomRaycaster: Cannot open '" + p_path + "' for recording.");
+    
+    // Header: the tick length and the state the first tick starts from. Entities and map edits
+    // aren't stored, only hashed, so a replay against a different world is caught when it loads.
+    record_file->store_buffer((const uint8_t *)REPLAY_MAGIC, 4);
+    record_file->store_32(REPLAY_VERSION);
+    record_file->store_float(1.0 / Engine::get_singleton()->get_physics_ticks_per_second());
+    record_file->store_float(player_pos.x);
+    record_file->store_float(player_pos.y);
+    record_file->store_float(player_angle);
+    record_file->store_32(map_width);
+    record_file->store_32(map_height);
+    record_file->store_32(hash_murmur3_buffer(map_data.ptr(), map_data.size() * sizeof(int)));
+    record_file->store_32(entity_grid.hash());
+    record_file->store_32(collected_keys.size());
+    for (int i = 0; i < collected_keys.size(); i++) {
+        record_file->store_float(collected_keys[i].x);
+        record_file->store_float(collected_keys[i].y);
+    }
+    print_line("DoomRaycaster: Recording input to " + p_path);
+    return OK;
+}
+
+void DoomRaycaster::stop_recording(){
+    if (record_file.is_valid()) {
+        record_file->close();
+        record_file.unref();
+        print_line("DoomRaycaster: Recording stopped");
+    }
+}
+
+bool DoomRaycaster::is_recording() const{
+    return record_file.is_valid();
+}
+
+Error DoomRaycaster::load_replay(const String &p_path){
+    Error err;
+    Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ, &err);
+    ERR_FAIL_COND_V_MSG(err != OK, err, "DoomRaycaster: Cannot open replay '" + p_path + "'.");
+    
+    char magic[4];
+    file->get_buffer((uint8_t *)magic, 4);
+    ERR_FAIL_COND_V_MSG(memcmp(magic, REPLAY_MAGIC, 4) != 0 || file->get_32() != REPLAY_VERSION, ERR_FILE_UNRECOGNIZED, "DoomRaycaster: '" + p_path + "' is not a replay file.");
+    replay_delta = file->get_float();
+    replay_start_pos.x = file->get_float();
+    replay_start_pos.y = file->get_float();
+    replay_start_angle = file->get_float();
+    uint32_t width = file->get_32();
+    uint32_t height = file->get_32();
+    uint32_t map_hash = file->get_32();
+    uint32_t entity_hash = file->get_32();
+    uint32_t key_count = file->get_32();
+    ERR_FAIL_COND_V(file->eof_reached() || !(replay_delta > 0.0f) || key_count > width * height, ERR_FILE_CORRUPT);
+    ERR_FAIL_COND_V_MSG((int)width != map_width || (int)height != map_height || map_hash != hash_murmur3_buffer(map_data.ptr(), map_data.size() * sizeof(int)), ERR_INVALID_DATA, "DoomRaycaster: Replay '" + p_path + "' was recorded on a different map (or before cells were edited).");
+    if (entity_hash != entity_grid.hash()) {
+        WARN_PRINT("DoomRaycaster: Replay '" + p_path + "' was recorded with different entities, it will likely desync.");
+    }
+    replay_start_keys.resize(key_count);
+    for (uint32_t i = 0; i < key_count; i++) {
+        replay_start_keys.write[i].x = file->get_float();
+        replay_start_keys.write[i].y = file->get_float();
+    }
+    ERR_FAIL_COND_V(file->eof_reached(), ERR_FILE_CORRUPT);
+    
+    // Fixed-size records, so the tick count follows from the length (a cut-off recording still plays)
+    uint64_t count = (file->get_length() - file->get_position()) / REPLAY_TICK_SIZE;
+    replay_ticks.resize(count);
+    for (uint64_t i = 0; i < count; i++) {
+        ReplayTick &tick = replay_ticks[i];
+        tick.buttons = file->get_8();
+        tick.pos.x = file->get_float();
+        tick.pos.y = file->get_float();
+        tick.angle = file->get_float();
+    }
+    return OK;
+}
+
+// Back to the recorded start pose and keys, so the ticks play out like they were recorded
+void DoomRaycaster::reset_to_replay_start(){
+    player_pos = replay_start_pos;
+    prev_player_pos = replay_start_pos;
+    player_angle = replay_start_angle;
+    prev_player_angle = replay_start_angle;
+    collected_keys = replay_start_keys;
+    replay_tick = 0;
+    replay_desyncs = 0;
+}
+
+void DoomRaycaster::check_replay_tick(){
+    const ReplayTick &tick = replay_ticks[replay_tick++];
+    if (tick.pos != player_pos || tick.angle != player_angle) {
+        if (replay_desyncs == 0) {
+            print_line("DoomRaycaster: Replay diverged at tick " + itos(replay_tick - 1));
+        }
+        replay_desyncs++;
+    }
+}
+
+Error DoomRaycaster::start_replay(const String &p_path){
+    stop_recording();
+    Error err = load_replay(p_path);
+    if (err != OK) {
+        return err;
+    }
+    reset_to_replay_start();
+    replaying = true;
+    print_line("DoomRaycaster: Replaying " + itos(replay_ticks.size()) + " ticks from " + p_path);
+    return OK;
+}
+
+void DoomRaycaster::stop_replay(){
+    replaying = false;
+}
+
+bool DoomRaycaster::is_replaying() const{
+    return replaying;
+}
+
+int DoomRaycaster::get_replay_desync_count() const{
+    return replay_desyncs;
+}
+
+// Plays a whole recording synchronously, one rendered frame per tick at the exact tick pose.
+// Meant for headless runs: per-frame times and hashes make field-reported hitches repeatable.
+// Ticks emit no signals, so a benchmark in a running game never counts towards its progress.
+Dictionary DoomRaycaster::run_replay_benchmark(const String &p_path, bool p_render){
+    Dictionary result;
+    ERR_FAIL_COND_V_MSG(map_data.size() == 0, result, "DoomRaycaster: No map set.");
+    finish_render_task();
+    stop_recording();
+    
+    // The benchmark drives the real player, so everything a tick can change is put back afterwards
+    const Vector2 saved_pos = player_pos;
+    const Vector2 saved_prev_pos = prev_player_pos;
+    const float saved_angle = player_angle;
+    const float saved_prev_angle = prev_player_angle;
+    const Vector2 saved_view_pos = view_pos;
+    const float saved_view_angle = view_angle;
+    const Vector<Vector2> saved_keys = collected_keys;
+    const Vector<Vector2> saved_view_keys = view_collected_keys;
+    const RaycasterEntityGrid saved_entities = entity_grid;
+    const bool saved_replaying = replaying;
+    const LocalVector<ReplayTick> saved_ticks = replay_ticks;
+    const uint32_t saved_tick = replay_tick;
+    const float saved_delta = replay_delta;
+    const Vector2 saved_start_pos = replay_start_pos;
+    const float saved_start_angle = replay_start_angle;
+    const Vector<Vector2> saved_start_keys = replay_start_keys;
+    const int saved_desyncs = replay_desyncs;
+    replaying = false;
+    
+    auto restore_state = [&]() {
+        player_pos = saved_pos;
+        prev_player_pos = saved_prev_pos;
+        player_angle = saved_angle;
+        prev_player_angle = saved_prev_angle;
+        view_pos = saved_view_pos;
+        view_angle = saved_view_angle;
+        collected_keys = saved_keys;
+        view_collected_keys = saved_view_keys;
+        entity_grid = saved_entities;
+        snapshot_sprites();
+        replaying = saved_replaying;
+        replay_ticks = saved_ticks;
+        replay_tick = saved_tick;
+        replay_delta = saved_delta;
+        replay_start_pos = saved_start_pos;
+        replay_start_angle = saved_start_angle;
+        replay_start_keys = saved_start_keys;
+        replay_desyncs = saved_desyncs;
+    };
+    
+    Error err = load_replay(p_path);
+    if (err != OK) {
+        restore_state(); // A partly read header already replaced the running replay
+        ERR_FAIL_V_MSG(result, "DoomRaycaster: Cannot load replay '" + p_path + "'.");
+    }
+    reset_to_replay_start();
+    
+    PackedInt32Array frame_usec;
+    PackedInt64Array frame_hashes;
+    uint64_t start = OS::get_singleton()->get_ticks_usec();
+    uint64_t render_usec = 0;
+    
+    while (replay_tick < replay_ticks.size()) {
+        apply_input(replay_ticks[replay_tick].buttons, replay_delta, false);
+        check_replay_tick();
+        
+        if (p_render) {
+            view_pos = player_pos;
+            view_angle = player_angle;
+            view_collected_keys = collected_keys;
+            snapshot_sprites();
+            
+            uint64_t frame_start = OS::get_singleton()->get_ticks_usec();
+            raycast_and_render();
+            uint64_t frame_time = OS::get_singleton()->get_ticks_usec() - frame_start;
+            render_usec += frame_time;
+            frame_usec.push_back(frame_time);
+            
+            Vector<uint8_t> pixels = render_image->get_data();
+            frame_hashes.push_back(hash_murmur3_buffer(pixels.ptr(), pixels.size()));
+        }
+    }
+    if (p_render) {
+        update_textures();
+    }
+    
+    uint64_t total = OS::get_singleton()->get_ticks_usec() - start;
+    int ticks = replay_ticks.size();
+    print_line("DoomRaycaster: Replay benchmark - " + itos(ticks) + " ticks, " + itos(replay_desyncs) + " desyncs" + (p_render && ticks > 0 ? ", " + itos(render_usec / ticks) + " us per frame" : String()));
+    
+    result["ticks"] = ticks;
+    result["desyncs"] = replay_desyncs;
+    result["total_usec"] = total;
+    result["frame_usec"] = frame_usec;
+    result["frame_hashes"] = frame_hashes;
+    
+    restore_state();
+    return result;
+}
+
+// Compares render_image against a golden PNG. A pixel mismatches when any channel differs by more
+// than the tolerance; mismatching frames also get a _diff.png next to the golden for review.
+Dictionary DoomRaycaster::compare_with_golden(const String &p_path, int p_tolerance, int p_max_mismatches, bool p_update){
+    Dictionary result;
+    result["golden"] = p_path;
+    
+    if (p_update) {
+        Error err = render_image->save_png(p_path);
+        result["updated"] = err == OK;
+        result["passed"] = err == OK;
+        return result;
+    }
+    
+    result["passed"] = false;
+    if (!FileAccess::exists(p_path)) {
+        result["error"] = "missing golden";
+        return result;
+    }
+    Ref<Image> golden = Image::load_from_file(p_path);
+    if (golden.is_null() || golden->get_width() != render_image->get_width() || golden->get_height() != render_image->get_height()) {
+        result["error"] = "size mismatch";
+        return result;
+    }
+    if (golden->get_format() != Image::FORMAT_RGBA8) {
+        golden->convert(Image::FORMAT_RGBA8);
+    }
+    
+    const uint8_t *expected = golden->ptr();
+    const uint8_t *actual = render_image->ptr();
+    int pixel_count = render_image->get_width() * render_image->get_height();
+    int mismatches = 0;
+    int max_difference = 0;
+    Vector<uint8_t> diff;
+    diff.resize(pixel_count * 4);
+    uint8_t *diff_ptr = diff.ptrw();
+    for (int i = 0; i < pixel_count; i++) {
+        int difference = 0;
+        for (int c = 0; c < 4; c++) {
+            difference = MAX(difference, ABS((int)expected[i * 4 + c] - (int)actual[i * 4 + c]));
+        }
+        max_difference = MAX(max_difference, difference);
+        bool mismatch = difference > p_tolerance;
+        mismatches += mismatch ? 1 : 0;
+        
+        // Mismatches in red over a dimmed copy of the frame
+        diff_ptr[i * 4 + 0] = mismatch ? 255 : actual[i * 4 + 0] / 4;
+        diff_ptr[i * 4 + 1] = mismatch ? 0 : actual[i * 4 + 1] / 4;
+        diff_ptr[i * 4 + 2] = mismatch ? 0 : actual[i * 4 + 2] / 4;
+        diff_ptr[i * 4 + 3] = 255;
+    }
+    
+    result["mismatches"] = mismatches;
+    result["max_difference"] = max_difference;
+    result["passed"] = mismatches <= p_max_mismatches;
+    if (mismatches > p_max_mismatches) {
+        Ref<Image> diff_image = Image::create_from_data(render_image->get_width(), render_image->get_height(), false, Image::FORMAT_RGBA8, diff);
+        diff_image->save_png(p_path.get_basename() + "_diff.png");
+    }
+    return result;
+}
+
+void DoomRaycaster::render_golden_frame(int p_index){
+    // Exact scripted pose: no interpolation, keys as currently collected
+    Vector3 pose = golden_poses[p_index];
+    view_pos = Vector2(pose.x, pose.y);
+    view_angle = pose.z;
+    view_collected_keys = collected_keys;
+    snapshot_sprites();
+    raycast_and_render();
+    
+    String path = golden_dir.path_join(vformat("frame_%03d.png", p_index));
+    Dictionary frame = compare_with_golden(path, golden_tolerance, golden_max_mismatches, golden_update);
+    if (!(bool)frame["passed"]) {
+        print_line("DoomRaycaster: Golden frame " + itos(p_index) + " failed (" + path + ")");
+    }
+    golden_frames.push_back(frame);
+}
+
+Dictionary DoomRaycaster::finish_golden_run(){
+    bool passed = true;
+    for (int i = 0; i < golden_frames.size(); i++) {
+        passed = passed && (bool)((Dictionary)golden_frames[i])["passed"];
+    }
+    Dictionary result;
+    result["passed"] = passed;
+    result["frames"] = golden_frames;
+    print_line("DoomRaycaster: Golden test " + String(passed ? "passed" : "FAILED") + " - " + itos(golden_frames.size()) + " frames, backend " + get_render_backend_name());
+    
+    golden_run_active = false;
+    golden_poses.clear();
+    golden_frames = Array();
+    return result;
+}
+
+bool DoomRaycaster::setup_golden_run(const PackedVector3Array &p_poses, const String &p_golden_dir, int p_tolerance, int p_max_mismatches, bool p_update){
+    ERR_FAIL_COND_V_MSG(map_data.size() == 0, false, "DoomRaycaster: No map set.");
+    ERR_FAIL_COND_V_MSG(golden_run_active, false, "DoomRaycaster: A golden run is already in progress.");
+    finish_render_task();
+    if (p_update) {
+        DirAccess::make_dir_recursive_absolute(p_golden_dir);
+    }
+    golden_poses = p_poses;
+    golden_dir = p_golden_dir;
+    golden_tolerance = p_tolerance;
+    golden_max_mismatches = p_max_mismatches;
+    golden_update = p_update;
+    golden_next = 0;
+    golden_frames = Array();
+    return true;
+}
+
+// Renders every pose (x, y, angle) and compares it with golden_dir/frame_NNN.png, or writes
+// the goldens when p_update is set. Synchronous, for headless CI runs.
+Dictionary DoomRaycaster::run_golden_test(const PackedVector3Array &p_poses, const String &p_golden_dir, int p_tolerance, int p_max_mismatches, bool p_update){
+    if (!setup_golden_run(p_poses, p_golden_dir, p_tolerance, p_max_mismatches, p_update)) {
+        return Dictionary();
+    }
+    for (int i = 0; i < golden_poses.size(); i++) {
+        render_golden_frame(i);
+    }
+    update_textures();
+    return finish_golden_run();
+}
+
+// Same test, but one frame per process frame and shown on screen. Run with --write-movie
+// (a .png or .avi path picks MovieWriterPNGWAV or MovieWriterMJPEG) to dump the frames for review.
+void DoomRaycaster::start_golden_run(const PackedVector3Array &p_poses, const String &p_golden_dir, int p_tolerance, int p_max_mismatches, bool p_update){
+    if (setup_golden_run(p_poses, p_golden_dir, p_tolerance, p_max_mismatches, p_update)) {
+        golden_run_active = true;
+    }
+}
+
+void DoomRaycaster::step_golden_run(){
+    if (golden_next < golden_poses.size()) {
+        render_golden_frame(golden_next++);
+        update_textures();
+        return;
+    }
+    emit_signal("golden_run_finished", finish_golden_run());
+}
+
+void DoomRaycaster::set_wall_mode(WallMode p_mode){
+    ERR_FAIL_INDEX((int)p_mode, (int)WALL_MODE_SEGMENTS + 1);
+    finish_render_task();
+    wall_mode = p_mode;
+}
+
+DoomRaycaster::WallMode DoomRaycaster::get_wall_mode() const{
+    return wall_mode;
+}
+
+int DoomRaycaster::get_wall_segment_count() const{
+    return wall_segments.size();
+}
+
+Ref<Image> DoomRaycaster::render_with_backend(RenderBackend p_backend){
+    ERR_FAIL_INDEX_V((int)p_backend, (int)RENDER_BACKEND_THREADED + 1, Ref<Image>());
+    ERR_FAIL_COND_V_MSG(map_data.size() == 0, Ref<Image>(), "DoomRaycaster: No map set.");
+    finish_render_task();
+    
+    const RaycasterKernels *kernels = nullptr;
+    bool threaded = false;
+    resolve_backend(p_backend, kernels, threaded);
+    
+    Ref<Image> image;
+    image.instantiate();
+    LocalVector<uint32_t> columns;
+    LocalVector<float> depth;
+    FrameState frame;
+    ERR_FAIL_COND_V(!prepare_main_frame(frame, kernels, columns, image, depth), Ref<Image>());
+    render_frames(&frame, 1, threaded);
+    return image;
+}
+
+int DoomRaycaster::compare_with_reference(RenderBackend p_backend){
+    Ref<Image> reference = render_with_backend(RENDER_BACKEND_SCALAR);
+    Ref<Image> candidate = render_with_backend(p_backend);
+    ERR_FAIL_COND_V(reference.is_null() || candidate.is_null(), -1);
+    
+    const uint32_t *a = (const uint32_t *)reference->ptr();
+    const uint32_t *b = (const uint32_t *)candidate->ptr();
+    int pixel_count = reference->get_width() * reference->get_height();
+    int mismatches = 0;
+    for (int i = 0; i < pixel_count; i++) {
+        if (a[i] != b[i]) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
@@ -5,10 +5,36 @@
 #include "scene/2d/node_2d.h"
 #include "core/io/image.h"
 #include "scene/resources/image_texture.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/io/file_access.h"
+#include "raycaster_backend.h"
+#include "raycaster_map.h"
+#include "raycaster_entities.h"
 
 class DoomRaycaster : public Node2D{
     GDCLASS(DoomRaycaster, Node2D);
 
+    public:
+        enum RenderBackend {
+            RENDER_BACKEND_AUTO, // Threaded when the pool has more than one thread, best SIMD kernels otherwise
+            RENDER_BACKEND_SCALAR, // Reference implementation
+            RENDER_BACKEND_SSE2,
+            RENDER_BACKEND_AVX2,
+            RENDER_BACKEND_NEON,
+            RENDER_BACKEND_THREADED, // Best SIMD kernels, columns split across worker threads
+        };
+        
+        enum WallMode {
+            WALL_MODE_DDA, // March the grid once per column
+            WALL_MODE_SEGMENTS, // Project merged wall faces and fill the columns they cover
+        };
+        
+        enum EntityFlags {
+            ENTITY_FLAG_SOLID = 1 << 0, // Pushes the player out
+            ENTITY_FLAG_PICKUP = 1 << 1, // Removed on contact with the player, emits entity_picked_up
+            ENTITY_FLAG_HIDDEN = 1 << 2, // Not drawn
+        };
+
     private:
         // Map data
         Vector<int> map_data;
@@ -19,6 +45,14 @@ class DoomRaycaster : public Node2D{
         Vector2 player_pos = Vector2(1.5, 1.5);
         float player_angle = 0.0f;
         
+        // Pose at the previous physics tick, used to interpolate between ticks
+        Vector2 prev_player_pos = Vector2(1.5, 1.5);
+        float prev_player_angle = 0.0f;
+        
+        // Pose the renderer draws from (interpolated, written only on the main thread)
+        Vector2 view_pos = Vector2(1.5, 1.5);
+        float view_angle = 0.0f;
+        
         // Rendering settings
         int screen_width = 1152;
         int screen_height = 648;
@@ -36,24 +70,335 @@ class DoomRaycaster : public Node2D{
         Ref<Image> ceiling_texture; // Now used as skybox cylinder
         Ref<Image> key_texture;
         
+        // Texture data the render kernels read (RGBA8, converted once per set_*_texture)
+        struct TextureCache {
+            LocalVector<uint32_t> texels;
+            int width = 0;
+            int height = 0;
+            RaycasterTexture get() const {
+                RaycasterTexture texture;
+                if (texels.size() > 0) {
+                    texture.texels = texels.ptr();
+                    texture.width = width;
+                    texture.height = height;
+                }
+                return texture;
+            }
+        };
+        TextureCache wall_cache;
+        TextureCache floor_cache;
+        TextureCache sky_cache;
+        TextureCache key_cache;
+        
+        // Sky panorama resampled to the ceiling height, column-major (one run of rows per texel column)
+        struct SkyStrip {
+            LocalVector<uint32_t> texels;
+            int rows = 0;
+        };
+        SkyStrip sky_strip;
+        
         // Skybox settings
         float skybox_radius = 10.0f;
         
         // Movement
         float move_speed = 3.0f;
         float rotation_speed = 2.0f;
+        float player_radius = 0.2f; // Keeps the camera clear of the 0.1 near plane
         
         // Key tracking
         Vector<Vector2> collected_keys;
+        Vector<Vector2> view_collected_keys;
+        
+        // Entities, and the sprites the renderer draws for them (snapshot taken with the view pose)
+        struct SpriteInstance {
+            Vector2 pos;
+            float size = 0.0f;
+            int sprite = 0;
+        };
+        RaycasterEntityGrid entity_grid;
+        LocalVector<TextureCache> sprite_caches;
+        LocalVector<SpriteInstance> view_sprites;
+        LocalVector<int> entity_query; // Scratch for the per-tick contact query
+        
+        // Input of one physics tick, as recorded and replayed
+        enum InputButton {
+            INPUT_TURN_LEFT = 1 << 0,
+            INPUT_TURN_RIGHT = 1 << 1,
+            INPUT_FORWARD = 1 << 2,
+            INPUT_BACK = 1 << 3,
+            INPUT_STRAFE_LEFT = 1 << 4,
+            INPUT_STRAFE_RIGHT = 1 << 5,
+        };
+        struct ReplayTick {
+            uint8_t buttons = 0;
+            Vector2 pos; // Pose after the tick, to detect divergence
+            float angle = 0.0f;
+        };
+        Ref<FileAccess> record_file;
+        bool replaying = false;
+        LocalVector<ReplayTick> replay_ticks;
+        uint32_t replay_tick = 0;
+        float replay_delta = 0.0f;
+        Vector2 replay_start_pos;
+        float replay_start_angle = 0.0f;
+        Vector<Vector2> replay_start_keys; // Keys already collected when the recording started
+        int replay_desyncs = 0;
+        
+        // Golden-image test run (scripted poses compared against stored frames)
+        bool golden_run_active = false;
+        PackedVector3Array golden_poses; // x, y, angle
+        String golden_dir;
+        int golden_tolerance = 2;
+        int golden_max_mismatches = 0;
+        bool golden_update = false;
+        int golden_next = 0;
+        Array golden_frames;
+        
+        // Threaded rendering
+        bool threaded_render = false;
+        WorkerThreadPool::TaskID render_task_id = WorkerThreadPool::INVALID_TASK_ID;
+        
+        // Result of one grid DDA trace
+        struct RayHit {
+            bool hit = false;
+            float dist = 0.0f;
+            int side = 0; // 0 = hit in x, 1 = hit in y
+            int map_x = 0;
+            int map_y = 0;
+            float wall_x = 0.0f; // Hit position along the face (0..1)
+        };
+        
+        // Shared state for a cast_rays batch split across worker threads
+        struct RayBatch {
+            static const int CHUNK_SIZE = 256;
+            const Vector2 *origins = nullptr;
+            const Vector2 *directions = nullptr;
+            float max_dist = 0.0f;
+            float *distances = nullptr;
+            int32_t *cells = nullptr;
+            int32_t *sides = nullptr;
+            int count = 0;
+        };
+        
+        // Last trace per quantized absolute ray angle; entries older than angle_cache_epoch are stale.
+        // The main view traces along the bin directions even on a miss, so its walls are always quantized.
+        struct AngleHit {
+            RayHit ray;
+            uint32_t stamp = 0;
+        };
+        LocalVector<AngleHit> angle_cache;
+        uint32_t angle_cache_epoch = 1;
+        Vector2 angle_cache_pos;
+        float angle_cache_distance = -1.0f;
+        
+        // A merged run of wall faces on one grid line, facing into the open cells
+        struct WallSegment {
+            int side = 0; // 0 = on a vertical grid line (x constant), 1 = on a horizontal one
+            int line = 0; // Grid line the faces lie on
+            int normal = 1; // Direction along the line's axis that points out of the wall (+1 / -1)
+            int from = 0; // Covered range along the line, in cells
+            int to = 0;
+        };
+        
+        // A wall segment clipped and projected for the current frame; 1/z and u/z are linear in screen x
+        struct ProjectedSegment {
+            int segment = 0;
+            float min_dist = 0.0f; // Closest distance from the camera, the front-to-back sort key
+            int from_x = 0;
+            int to_x = 0;
+            float screen_x = 0.0f; // Where the inv_z / u_over_z values are taken
+            float inv_z = 0.0f;
+            float u_over_z = 0.0f;
+            float inv_z_step = 0.0f;
+            float u_over_z_step = 0.0f;
+            bool operator<(const ProjectedSegment &p_other) const { return min_dist < p_other.min_dist; }
+        };
+        
+        WallMode wall_mode = WALL_MODE_DDA;
+        LocalVector<WallSegment> wall_segments;
+        LocalVector<ProjectedSegment> projected_segments;
+        LocalVector<RayHit> segment_hits; // One per column
+        LocalVector<int> open_columns; // Coverage buffer: next column at or after x that may still change
+        
+        // Baked lighting: point lights flood-filled through open cells into one level per cell
+        static const int MAX_LIGHT_RADIUS = 32;
+        struct GridLight {
+            bool active = false;
+            bool dirty = false; // Needs propagating again
+            Vector2i cell;
+            float intensity = 1.0f;
+            int radius = 8; // In BFS steps
+            LocalVector<float> levels; // Contribution over the box around the cell, 0 where it does not reach
+            Rect2i get_box() const { return Rect2i(cell - Vector2i(radius, radius), Vector2i(radius * 2 + 1, radius * 2 + 1)); }
+        };
+        LocalVector<GridLight> lights;
+        bool lighting_enabled = false;
+        float ambient_light = 0.3f;
+        LocalVector<float> light_grid; // Ambient plus every light, one level per map cell
+        Rect2i light_dirty_rect; // Cells whose level needs summing again
+        bool lights_dirty = false;
+        
+        // Potentially visible set: one bitset row per cell, built after set_map when enabled
+        static const int PVS_MAX_CELLS = 128 * 128; // 32 MiB of bits
+        bool pvs_enabled = false;
+        LocalVector<uint64_t> pvs_bits;
+        int pvs_words = 0;
         
+        // Rows are traced against a snapshot of the map, so a rebuild can run on the pool
+        // while the game keeps editing cells; the bits are swapped in once it finishes
+        struct PVSBuild {
+            Vector<int> cells;
+            int width = 0;
+            int height = 0;
+            int words = 0;
+            float max_dist = 0.0f; // Render distance; cells farther than this from the source stay culled
+            LocalVector<int> column_walls; // Walls above each cell in its column, (height + 1) x width
+            LocalVector<int> row_walls; // Walls left of each cell in its row, height x (width + 1)
+            SafeFlag cancelled; // Rows that haven't started yet return right away
+            LocalVector<uint64_t> bits;
+        };
+        PVSBuild pvs_build;
+        WorkerThreadPool::GroupID pvs_group = -1;
+        bool pvs_rebuild_pending = false; // A cell changed while the running build was tracing
+        
+        // Everything the column kernels need for one frame, resolved up front
+        struct FrameState {
+            static const int COLUMN_CHUNK = 32;
+            static const int ROW_CHUNK = 32;
+            const RaycasterKernels *kernels = nullptr;
+            uint32_t *columns = nullptr; // Column-major, column x starts at x * height
+            uint32_t *rows = nullptr; // Target image data (RGBA8)
+            int width = 0;
+            int height = 0;
+            int mid = 0;
+            Vector2 pos;
+            float angle = 0.0f;
+            float fov = 0.0f; // Degrees, for billboards
+            const float *column_angles = nullptr; // Ray angle of every column relative to the view angle
+            const float *row_dist = nullptr; // Floor distance of every row below the horizon
+            const float *floor_ray_x = nullptr;
+            const float *floor_ray_y = nullptr;
+            float column_center = 0.0f; // Pinhole projection the column angles follow
+            float columns_per_tan = 0.0f;
+            float render_distance = 0.0f;
+            float inv_render_distance = 0.0f;
+            RaycasterTexture wall;
+            RaycasterTexture floor;
+            RaycasterTexture sky;
+            const SkyStrip *sky_strip = nullptr;
+            const float *light_grid = nullptr; // Baked level per map cell, null when lighting is off
+            int map_width = 0;
+            int map_height = 0;
+            const RayHit *column_hits = nullptr; // Set when the walls were resolved up front instead of per column
+            float *column_depth = nullptr; // Wall distance of every column, written by render_columns for the sprites
+            bool angle_bins = false; // Trace along the angle cache bins instead of the exact column angles
+            AngleHit *angle_cache = nullptr; // Needs angle_bins
+            uint32_t angle_cache_epoch = 0;
+            uint32_t ceiling_color = 0;
+            uint32_t floor_color = 0;
+            Color wall_color;
+            int first_column_chunk = 0; // Where this frame's chunks start in a batch
+            int first_row_chunk = 0;
+        };
+        
+        // Frames rendered together, split into chunks by one group task per pass
+        struct FrameBatch {
+            FrameState *frames = nullptr;
+            int count = 0;
+            int find_frame(uint32_t p_index, bool p_rows) const;
+        };
+        
+        // An extra camera rendered in the same batch as the main one
+        static const int MAX_VIEW_SIZE = 4096;
+        struct RenderView {
+            bool active = false;
+            Vector2 pos; // Set from scripts
+            float angle = 0.0f;
+            Vector2 render_pos; // Snapshot the renderer uses, taken on the main thread
+            float render_angle = 0.0f;
+            float fov = 60.0f;
+            int width = 0;
+            int height = 0;
+            float columns_per_tan = 0.0f;
+            bool angle_bins = false; // Columns at least one bin apart, so they snap like the main view
+            LocalVector<float> column_angles;
+            LocalVector<float> floor_ray_x;
+            LocalVector<float> floor_ray_y;
+            LocalVector<float> row_dist;
+            SkyStrip sky_strip;
+            LocalVector<RayHit> segment_hits;
+            LocalVector<float> depth;
+            LocalVector<uint32_t> columns;
+            Ref<Image> image;
+            Ref<ImageTexture> texture;
+        };
+        LocalVector<RenderView> views;
+        
+        // Render backend
+        RenderBackend render_backend = RENDER_BACKEND_AUTO;
+        const RaycasterKernels *render_kernels = nullptr;
+        bool render_threaded = false;
+        
+        // Columns are drawn top to bottom into a column-major buffer, then transposed into render_image
+        LocalVector<uint32_t> column_buffer;
+        LocalVector<float> column_depth;
         Ref<Image> render_image;
         Ref<ImageTexture> render_texture;
         
+        void simulate_tick(double delta);
+        uint32_t poll_input() const;
+        void apply_input(uint32_t p_buttons, float delta, bool p_notify);
+        Error load_replay(const String &p_path);
+        void reset_to_replay_start();
+        void check_replay_tick();
+        Dictionary compare_with_golden(const String &p_path, int p_tolerance, int p_max_mismatches, bool p_update);
+        bool setup_golden_run(const PackedVector3Array &p_poses, const String &p_golden_dir, int p_tolerance, int p_max_mismatches, bool p_update);
+        void render_golden_frame(int p_index);
+        void step_golden_run();
+        Dictionary finish_golden_run();
+        void update_view_pose();
+        void snapshot_sprites();
+        void touch_entities(bool p_notify);
+        void _render_task(void *p_userdata);
+        void finish_render_task();
         void raycast_and_render();
-        int get_map_value(int x, int y);
-        Color sample_texture(Ref<Image> texture, float u, float v);
-        void render_billboard(int screen_x, float distance, Vector2 billboard_pos, Ref<Image> texture);
-        void render_skybox_cylinder(float ray_angle, int x, int ceiling_end, int sky_tex_width, int sky_tex_height);
+        void invalidate_angle_cache();
+        void build_wall_segments();
+        void rasterize_wall_segments(const FrameState &p_frame, LocalVector<RayHit> &r_hits);
+        static RayHit trace_grid(const int *p_cells, int p_cell_count, int p_width, int p_height, float ray_pos_x, float ray_pos_y, float dir_x, float dir_y, float max_dist);
+        RayHit trace_ray(float ray_pos_x, float ray_pos_y, float dir_x, float dir_y, float max_dist) const;
+        void _cast_rays_group(uint32_t p_index, RayBatch *p_batch);
+        static bool is_pvs_corridor_blocked(const PVSBuild &p_build, int p_from_x, int p_from_y, int p_to_x, int p_to_y);
+        void _build_pvs_row(uint32_t p_index, PVSBuild *p_build);
+        void queue_pvs_build();
+        void start_pvs_build(bool p_high_priority);
+        void finish_pvs_build();
+        void cancel_pvs_build();
+        void poll_pvs_build();
+        int get_map_value(int x, int y) const;
+        void map_changed();
+        void mark_light_rect(const Rect2i &p_rect);
+        void mark_light_dirty(GridLight &r_light);
+        void propagate_light(GridLight &r_light) const;
+        void _bake_light_group(uint32_t p_index, const int *p_lights);
+        bool is_blocking_cell(int x, int y) const;
+        void push_circle_out(Vector2 &r_pos, float radius) const;
+        void cache_texture(const Ref<Image> &p_image, TextureCache &r_cache);
+        void prepare_frame(FrameState &r_frame, const RaycasterKernels *p_kernels, int p_width, int p_height, LocalVector<uint32_t> &r_columns, const Ref<Image> &r_target, SkyStrip &r_sky_strip, LocalVector<RayHit> &r_segment_hits, LocalVector<float> &r_depth);
+        bool prepare_main_frame(FrameState &r_frame, const RaycasterKernels *p_kernels, LocalVector<uint32_t> &r_columns, const Ref<Image> &r_target, LocalVector<float> &r_depth);
+        void prepare_view_frame(FrameState &r_frame, const RaycasterKernels *p_kernels, RenderView &r_view);
+        void render_frames(FrameState *p_frames, int p_count, bool p_threaded);
+        void render_keys(const FrameState &p_frame);
+        void render_entities(const FrameState &p_frame);
+        void update_textures();
+        void render_columns(const FrameState &p_frame, int p_from, int p_to);
+        void _render_columns_group(uint32_t p_index, const FrameBatch *p_batch);
+        void _transpose_group(uint32_t p_index, const FrameBatch *p_batch);
+        void render_billboard(const FrameState &p_frame, float distance, Vector2 billboard_pos, const RaycasterTexture &texture);
+        void build_sky_strip(int ceiling_end, SkyStrip &r_strip);
+        void invalidate_sky_strips();
+        void render_skybox_cylinder(const FrameState &p_frame, float ray_angle, uint32_t *r_column, int ceiling_end);
+        void resolve_backend(RenderBackend p_backend, const RaycasterKernels *&r_kernels, bool &r_threaded) const;
 
     protected:
         static void _bind_methods();
@@ -65,6 +410,7 @@ class DoomRaycaster : public Node2D{
         
         // Map setup
         void set_map(const Array &p_map, int p_width, int p_height);
+        void set_map_resource(const Ref<RaycasterMap> &p_map); // Straight from the cell bytes, no Variant array; also spawns the map's entities
         
         // Player control
         void set_player_position(Vector2 p_pos);
@@ -97,9 +443,102 @@ class DoomRaycaster : public Node2D{
         // Movement settings
         void set_move_speed(float p_speed);
         void set_rotation_speed(float p_speed);
+        void set_player_radius(float p_radius);
+        float get_player_radius() const;
+        
+        // Collision (swept circle vs. the map grid, slides along walls; usable for NPCs too)
+        Vector2 move_circle(Vector2 p_pos, Vector2 p_motion, float p_radius) const;
+        PackedVector2Array move_circles(const PackedVector2Array &p_positions, const PackedVector2Array &p_motions, float p_radius) const;
+        
+        // Entities (NPCs, pickups) bucketed per map cell; queries only visit the cells around them
+        int add_sprite(Ref<Image> p_texture);
+        int add_entity(Vector2 p_position, float p_radius, int p_sprite = -1, int p_flags = 0);
+        void remove_entity(int p_entity);
+        void clear_entities();
+        bool has_entity(int p_entity) const;
+        int get_entity_count() const;
+        void set_entity_position(int p_entity, Vector2 p_position);
+        Vector2 get_entity_position(int p_entity) const;
+        void set_entity_positions(const PackedInt32Array &p_entities, const PackedVector2Array &p_positions);
+        void move_entities(const PackedInt32Array &p_entities, const PackedVector2Array &p_motions);
+        void set_entity_sprite(int p_entity, int p_sprite);
+        void set_entity_flags(int p_entity, int p_flags);
+        int get_entity_flags(int p_entity) const;
+        PackedInt32Array query_entities(Vector2 p_center, float p_radius, int p_flags = 0) const;
+        int find_nearest_entity(Vector2 p_center, float p_max_distance, int p_flags = 0) const;
+        
+        // Ray queries (same DDA as the renderer, batched over worker threads)
+        Dictionary cast_rays(const PackedVector2Array &p_origins, const PackedVector2Array &p_directions, float p_max_dist) const;
+        
+        // Precomputed cell-to-cell visibility (border-sampled, grown by one cell, limited to the render distance).
+        // Built in the background; everything is visible while it is disabled or not ready yet.
+        // build_pvs() builds it right away, or waits for the background build.
+        void set_pvs_enabled(bool p_enabled);
+        bool is_pvs_enabled() const;
+        void build_pvs();
+        bool is_cell_visible(Vector2i p_from, Vector2i p_to) const;
+        PackedInt32Array get_visible_cells(Vector2i p_from) const;
+        
+        // Edit one cell at runtime (doors, destructible walls); updates every cache that depends on the map
+        void set_map_cell(Vector2i p_cell, int p_value);
+        
+        // Baked lighting (levels can exceed 1 for bright spots; the renderer clamps)
+        void set_lighting_enabled(bool p_enabled);
+        bool is_lighting_enabled() const;
+        void set_ambient_light(float p_level);
+        float get_ambient_light() const;
+        int add_light(Vector2i p_cell, float p_intensity, int p_radius);
+        void set_light(int p_light, Vector2i p_cell, float p_intensity, int p_radius);
+        void remove_light(int p_light);
+        void bake_lights();
+        float get_light_level(Vector2i p_cell);
+        
+        // Deterministic input capture and playback (per-tick buttons plus the resulting pose)
+        Error start_recording(const String &p_path);
+        void stop_recording();
+        bool is_recording() const;
+        Error start_replay(const String &p_path);
+        void stop_replay();
+        bool is_replaying() const;
+        int get_replay_desync_count() const;
+        Dictionary run_replay_benchmark(const String &p_path, bool p_render = true); // Emits no signals, restores the game state afterwards
+        
+        // Golden-image regression tests: render scripted poses and compare with stored PNGs
+        Dictionary run_golden_test(const PackedVector3Array &p_poses, const String &p_golden_dir, int p_tolerance = 2, int p_max_mismatches = 0, bool p_update = false);
+        void start_golden_run(const PackedVector3Array &p_poses, const String &p_golden_dir, int p_tolerance = 2, int p_max_mismatches = 0, bool p_update = false);
+        
+        // Extra cameras (split-screen, in-world monitors), rendered with the main view in one batch
+        int add_view(Vector2 p_position, float p_angle, float p_fov, Vector2i p_size);
+        void remove_view(int p_view);
+        void set_view_pose(int p_view, Vector2 p_position, float p_angle);
+        Ref<ImageTexture> get_view_texture(int p_view) const;
+        Ref<Image> get_view_image(int p_view); // The last rendered frame
+        int get_view_count() const;
+        
+        // Wall visibility: per-column DDA or projected wall segments
+        void set_wall_mode(WallMode p_mode);
+        WallMode get_wall_mode() const;
+        int get_wall_segment_count() const;
         
         // Skybox settings
         void set_skybox_radius(float p_radius);
+        
+        // Render on a worker thread while the next physics tick simulates
+        void set_threaded_render(bool p_enabled);
+        bool is_threaded_render() const;
+        
+        // Inner loop implementation, picked from the CPU features when set to auto
+        void set_render_backend(RenderBackend p_backend);
+        RenderBackend get_render_backend() const;
+        String get_render_backend_name() const;
+        
+        // Render the current view with any backend; compare against the scalar reference for pixel-exact tests
+        Ref<Image> render_with_backend(RenderBackend p_backend);
+        int compare_with_reference(RenderBackend p_backend);
 };
 
+VARIANT_ENUM_CAST(DoomRaycaster::RenderBackend);
+VARIANT_ENUM_CAST(DoomRaycaster::WallMode);
+VARIANT_ENUM_CAST(DoomRaycaster::EntityFlags);
+
 #endif // DOOM_RAYCASTER_H
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "raycaster_backend.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// ---- Scalar reference kernels ----
+
+static void scalar_fill_span(uint32_t *r_dst, int p_count, uint32_t p_color) {
+    for (int i = 0; i < p_count; i++) {
+        r_dst[i] = p_color;
+    }
+}
+
+static void scalar_draw_wall_span(uint32_t *r_dst, int p_count, const RaycasterTexture &p_tex, int p_tex_x, float p_tex_pos, float p_tex_step, float p_shade) {
+    const uint32_t *column = p_tex.texels + p_tex_x;
+    for (int i = 0; i < p_count; i++) {
+        int tex_y = raycaster_wrap_row(p_tex_pos, p_tex.height);
+        r_dst[i] = raycaster_shade_texel(column[tex_y * p_tex.width], p_shade);
+        p_tex_pos += p_tex_step;
+    }
+}
+
+static void scalar_draw_floor_span(uint32_t *r_dst, const float *p_row_dist, int p_count, float p_pos_x, float p_pos_y, float p_dir_x, float p_dir_y, const RaycasterTexture &p_tex, uint32_t p_fallback) {
+    for (int i = 0; i < p_count; i++) {
+        float row_dist = p_row_dist[i];
+        if (row_dist > 0.0f) {
+            r_dst[i] = raycaster_sample_floor(p_pos_x + p_dir_x * row_dist, p_pos_y + p_dir_y * row_dist, p_tex);
+        } else {
+            r_dst[i] = p_fallback;
+        }
+    }
+}
+
+static void scalar_transpose(const uint32_t *p_columns, int p_width, int p_height, uint32_t *r_rows, int p_from_row, int p_to_row) {
+    // Blocked so both the column reads and the row writes stay in cache
+    const int BLOCK = 16;
+    for (int by = p_from_row; by < p_to_row; by += BLOCK) {
+        int end_y = MIN(by + BLOCK, p_to_row);
+        for (int bx = 0; bx < p_width; bx += BLOCK) {
+            int end_x = MIN(bx + BLOCK, p_width);
+            for (int x = bx; x < end_x; x++) {
+                const uint32_t *src = p_columns + x * p_height;
+                for (int y = by; y < end_y; y++) {
+                    r_rows[y * p_width + x] = src[y];
+                }
+            }
+        }
+    }
+}
+
+static const RaycasterKernels scalar_kernels = {
+    "scalar",
+    scalar_fill_span,
+    scalar_draw_wall_span,
+    scalar_draw_floor_span,
+    scalar_transpose,
+};
+
+const RaycasterKernels *raycaster_get_scalar_kernels() {
+    return &scalar_kernels;
+}
+
+// ---- CPU feature detection ----
+
+static uint32_t detect_cpu_features() {
+    uint32_t features = 0;
+
+#if defined(__x86_64__) || defined(_M_X64)
+    features |= RAYCASTER_CPU_SSE2; // Part of the x86_64 baseline
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6; // OSXSAVE and XMM/YMM state
+        __cpuidex(info, 7, 0);
+        if (os_saves_ymm && (info[1] & (1 << 5))) {
+            features |= RAYCASTER_CPU_AVX2;
+        }
+    }
+#elif defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        features |= RAYCASTER_CPU_AVX2;
+    }
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    features |= RAYCASTER_CPU_NEON; // Part of the arm64 baseline
+#endif
+
+    return features;
+}
+
+uint32_t raycaster_get_cpu_features() {
+    static uint32_t features = detect_cpu_features();
+    return features;
+}
+
+const RaycasterKernels *raycaster_get_best_kernels() {
+    uint32_t features = raycaster_get_cpu_features();
+    if ((features & RAYCASTER_CPU_AVX2) && raycaster_get_avx2_kernels()) {
+        return raycaster_get_avx2_kernels();
+    }
+    if ((features & RAYCASTER_CPU_SSE2) && raycaster_get_sse2_kernels()) {
+        return raycaster_get_sse2_kernels();
+    }
+    if ((features & RAYCASTER_CPU_NEON) && raycaster_get_neon_kernels()) {
+        return raycaster_get_neon_kernels();
+    }
+    return raycaster_get_scalar_kernels();
+}
@@ -0,0 +1,89 @@
+#ifndef RAYCASTER_BACKEND_H
+#define RAYCASTER_BACKEND_H
+
+#include "core/typedefs.h"
+
+#include <math.h>
+#include <stdint.h>
+
+// Pixels are packed RGBA8 in a uint32_t (R in the low byte), so a pixel written
+// as a uint32_t lands in memory in Image::FORMAT_RGBA8 order.
+#define RAYCASTER_ALPHA_MASK 0xFF000000u
+
+// Raw texture data, converted to RGBA8 once when the texture is set
+struct RaycasterTexture {
+    const uint32_t *texels = nullptr;
+    int width = 0;
+    int height = 0;
+};
+
+// Inner loops of the renderer. Every backend must produce exactly the same
+// pixels as the scalar one, which is the reference the others are tested against.
+// Spans are contiguous runs of one column of the column-major frame buffer.
+struct RaycasterKernels {
+    const char *name;
+
+    // Solid color run
+    void (*fill_span)(uint32_t *r_dst, int p_count, uint32_t p_color);
+
+    // Textured wall run: texel row advances by p_tex_step per pixel, rgb scaled by p_shade
+    void (*draw_wall_span)(uint32_t *r_dst, int p_count, const RaycasterTexture &p_tex, int p_tex_x, float p_tex_pos, float p_tex_step, float p_shade);
+
+    // Textured floor run: pixel i samples the world at pos + dir * p_row_dist[i], p_fallback where p_row_dist[i] <= 0
+    void (*draw_floor_span)(uint32_t *r_dst, const float *p_row_dist, int p_count, float p_pos_x, float p_pos_y, float p_dir_x, float p_dir_y, const RaycasterTexture &p_tex, uint32_t p_fallback);
+
+    // Copies rows [p_from_row, p_to_row) of the column-major buffer into a row-major image
+    void (*transpose)(const uint32_t *p_columns, int p_width, int p_height, uint32_t *r_rows, int p_from_row, int p_to_row);
+};
+
+// Scalar building blocks, also used by the SIMD kernels for their remainders
+
+static _FORCE_INLINE_ uint32_t raycaster_shade_texel(uint32_t p_texel, float p_shade) {
+    uint32_t r = (uint32_t)((float)(p_texel & 0xFF) * p_shade);
+    uint32_t g = (uint32_t)((float)((p_texel >> 8) & 0xFF) * p_shade);
+    uint32_t b = (uint32_t)((float)((p_texel >> 16) & 0xFF) * p_shade);
+    return MIN(r, 255u) | (MIN(g, 255u) << 8) | (MIN(b, 255u) << 16) | RAYCASTER_ALPHA_MASK;
+}
+
+static _FORCE_INLINE_ int raycaster_wrap_row(float p_tex_pos, int p_height) {
+    int tex_y = (int)p_tex_pos;
+    if (tex_y >= p_height) {
+        tex_y %= p_height;
+    } else if (tex_y < 0) {
+        tex_y += p_height;
+    }
+    return tex_y;
+}
+
+static _FORCE_INLINE_ uint32_t raycaster_sample_floor(float p_world_x, float p_world_y, const RaycasterTexture &p_tex) {
+    // Wrap to the fractional part, then scale to texels
+    int tex_x = (int)((p_world_x - floorf(p_world_x)) * (float)p_tex.width);
+    int tex_y = (int)((p_world_y - floorf(p_world_y)) * (float)p_tex.height);
+    if (tex_x >= p_tex.width) {
+        tex_x -= p_tex.width;
+    }
+    if (tex_y >= p_tex.height) {
+        tex_y -= p_tex.height;
+    }
+    return p_tex.texels[tex_y * p_tex.width + tex_x] | RAYCASTER_ALPHA_MASK;
+}
+
+enum RaycasterCPUFeature {
+    RAYCASTER_CPU_SSE2 = 1 << 0,
+    RAYCASTER_CPU_AVX2 = 1 << 1,
+    RAYCASTER_CPU_NEON = 1 << 2,
+};
+
+// Detected once, bitmask of RaycasterCPUFeature
+uint32_t raycaster_get_cpu_features();
+
+// Kernel tables; the SIMD ones return nullptr when not built for this architecture
+const RaycasterKernels *raycaster_get_scalar_kernels();
+const RaycasterKernels *raycaster_get_sse2_kernels();
+const RaycasterKernels *raycaster_get_avx2_kernels();
+const RaycasterKernels *raycaster_get_neon_kernels();
+
+// Fastest table the running CPU supports
+const RaycasterKernels *raycaster_get_best_kernels();
+
+#endif // RAYCASTER_BACKEND_H
@@ -0,0 +1,169 @@
+#include "raycaster_backend.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+// Built for the x86_64 baseline; these functions only run after raycaster_get_cpu_features() saw AVX2.
+// FMA is deliberately not enabled so mul + add round exactly like the scalar kernels.
+#if defined(__GNUC__) || defined(__clang__)
+#define RAYCASTER_AVX2 __attribute__((target("avx2")))
+#else
+#define RAYCASTER_AVX2
+#endif
+
+RAYCASTER_AVX2 static void avx2_fill_span(uint32_t *r_dst, int p_count, uint32_t p_color) {
+    __m256i color = _mm256_set1_epi32((int)p_color);
+    int i = 0;
+    for (; i + 8 <= p_count; i += 8) {
+        _mm256_storeu_si256((__m256i *)(r_dst + i), color);
+    }
+    for (; i < p_count; i++) {
+        r_dst[i] = p_color;
+    }
+}
+
+// Unpack and pack both work per 128-bit lane, so pixel order is preserved
+RAYCASTER_AVX2 static inline __m256i avx2_shade8(__m256i p_pixels, __m256 p_shade) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_unpacklo_epi8(p_pixels, zero);
+    __m256i hi = _mm256_unpackhi_epi8(p_pixels, zero);
+    __m256i p0 = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(lo, zero)), p_shade));
+    __m256i p1 = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(lo, zero)), p_shade));
+    __m256i p2 = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(hi, zero)), p_shade));
+    __m256i p3 = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(hi, zero)), p_shade));
+    __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(p0, p1), _mm256_packs_epi32(p2, p3));
+    return _mm256_or_si256(packed, _mm256_set1_epi32((int)RAYCASTER_ALPHA_MASK));
+}
+
+RAYCASTER_AVX2 static void avx2_draw_wall_span(uint32_t *r_dst, int p_count, const RaycasterTexture &p_tex, int p_tex_x, float p_tex_pos, float p_tex_step, float p_shade) {
+    const uint32_t *column = p_tex.texels + p_tex_x;
+    const __m256 shade = _mm256_set1_ps(p_shade);
+    alignas(32) int32_t offsets[8];
+    int i = 0;
+    for (; i + 8 <= p_count; i += 8) {
+        // Texel rows stay sequential so tex_pos accumulates exactly like the scalar loop
+        for (int k = 0; k < 8; k++) {
+            offsets[k] = raycaster_wrap_row(p_tex_pos, p_tex.height) * p_tex.width;
+            p_tex_pos += p_tex_step;
+        }
+        __m256i pixels = _mm256_i32gather_epi32((const int *)column, _mm256_load_si256((const __m256i *)offsets), 4);
+        _mm256_storeu_si256((__m256i *)(r_dst + i), avx2_shade8(pixels, shade));
+    }
+    for (; i < p_count; i++) {
+        r_dst[i] = raycaster_shade_texel(column[raycaster_wrap_row(p_tex_pos, p_tex.height) * p_tex.width], p_shade);
+        p_tex_pos += p_tex_step;
+    }
+}
+
+RAYCASTER_AVX2 static inline __m256i avx2_texel_coord(__m256 p_world, __m256 p_size_f, __m256i p_size) {
+    __m256i coord = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(p_world, _mm256_floor_ps(p_world)), p_size_f));
+    __m256i overflow = _mm256_cmpgt_epi32(coord, _mm256_sub_epi32(p_size, _mm256_set1_epi32(1)));
+    return _mm256_sub_epi32(coord, _mm256_and_si256(overflow, p_size));
+}
+
+RAYCASTER_AVX2 static void avx2_draw_floor_span(uint32_t *r_dst, const float *p_row_dist, int p_count, float p_pos_x, float p_pos_y, float p_dir_x, float p_dir_y, const RaycasterTexture &p_tex, uint32_t p_fallback) {
+    const __m256 pos_x = _mm256_set1_ps(p_pos_x);
+    const __m256 pos_y = _mm256_set1_ps(p_pos_y);
+    const __m256 dir_x = _mm256_set1_ps(p_dir_x);
+    const __m256 dir_y = _mm256_set1_ps(p_dir_y);
+    const __m256 width_f = _mm256_set1_ps((float)p_tex.width);
+    const __m256 height_f = _mm256_set1_ps((float)p_tex.height);
+    const __m256i width = _mm256_set1_epi32(p_tex.width);
+    const __m256i height = _mm256_set1_epi32(p_tex.height);
+    const __m256i fallback = _mm256_set1_epi32((int)p_fallback);
+    const __m256i alpha = _mm256_set1_epi32((int)RAYCASTER_ALPHA_MASK);
+
+    int i = 0;
+    for (; i + 8 <= p_count; i += 8) {
+        __m256 row_dist = _mm256_loadu_ps(p_row_dist + i);
+        __m256i valid = _mm256_castps_si256(_mm256_cmp_ps(row_dist, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+        __m256 world_x = _mm256_add_ps(pos_x, _mm256_mul_ps(dir_x, row_dist));
+        __m256 world_y = _mm256_add_ps(pos_y, _mm256_mul_ps(dir_y, row_dist));
+        __m256i tex_x = avx2_texel_coord(world_x, width_f, width);
+        __m256i tex_y = avx2_texel_coord(world_y, height_f, height);
+        __m256i index = _mm256_and_si256(_mm256_add_epi32(_mm256_mullo_epi32(tex_y, width), tex_x), valid);
+
+        // Masked lanes never touch memory and take the fallback color
+        __m256i texels = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int *)p_tex.texels, index, valid, 4);
+        _mm256_storeu_si256((__m256i *)(r_dst + i), _mm256_blendv_epi8(fallback, _mm256_or_si256(texels, alpha), valid));
+    }
+    for (; i < p_count; i++) {
+        float row_dist = p_row_dist[i];
+        if (row_dist > 0.0f) {
+            r_dst[i] = raycaster_sample_floor(p_pos_x + p_dir_x * row_dist, p_pos_y + p_dir_y * row_dist, p_tex);
+        } else {
+            r_dst[i] = p_fallback;
+        }
+    }
+}
+
+RAYCASTER_AVX2 static void avx2_transpose(const uint32_t *p_columns, int p_width, int p_height, uint32_t *r_rows, int p_from_row, int p_to_row) {
+    int y = p_from_row;
+    for (; y + 8 <= p_to_row; y += 8) {
+        int x = 0;
+        for (; x + 8 <= p_width; x += 8) {
+            // 8x8 transpose: 32-bit, then 64-bit interleave within lanes, then swap 128-bit halves
+            __m256i c[8];
+            for (int k = 0; k < 8; k++) {
+                c[k] = _mm256_loadu_si256((const __m256i *)(p_columns + (x + k) * p_height + y));
+            }
+            __m256i t0 = _mm256_unpacklo_epi32(c[0], c[1]);
+            __m256i t1 = _mm256_unpackhi_epi32(c[0], c[1]);
+            __m256i t2 = _mm256_unpacklo_epi32(c[2], c[3]);
+            __m256i t3 = _mm256_unpackhi_epi32(c[2], c[3]);
+            __m256i t4 = _mm256_unpacklo_epi32(c[4], c[5]);
+            __m256i t5 = _mm256_unpackhi_epi32(c[4], c[5]);
+            __m256i t6 = _mm256_unpacklo_epi32(c[6], c[7]);
+            __m256i t7 = _mm256_unpackhi_epi32(c[6], c[7]);
+            __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+            __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+            __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+            __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+            __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+            __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+            __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+            __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+            uint32_t *dst = r_rows + y * p_width + x;
+            _mm256_storeu_si256((__m256i *)(dst + 0 * p_width), _mm256_permute2x128_si256(u0, u4, 0x20));
+            _mm256_storeu_si256((__m256i *)(dst + 1 * p_width), _mm256_permute2x128_si256(u1, u5, 0x20));
+            _mm256_storeu_si256((__m256i *)(dst + 2 * p_width), _mm256_permute2x128_si256(u2, u6, 0x20));
+            _mm256_storeu_si256((__m256i *)(dst + 3 * p_width), _mm256_permute2x128_si256(u3, u7, 0x20));
+            _mm256_storeu_si256((__m256i *)(dst + 4 * p_width), _mm256_permute2x128_si256(u0, u4, 0x31));
+            _mm256_storeu_si256((__m256i *)(dst + 5 * p_width), _mm256_permute2x128_si256(u1, u5, 0x31));
+            _mm256_storeu_si256((__m256i *)(dst + 6 * p_width), _mm256_permute2x128_si256(u2, u6, 0x31));
+            _mm256_storeu_si256((__m256i *)(dst + 7 * p_width), _mm256_permute2x128_si256(u3, u7, 0x31));
+        }
+        for (; x < p_width; x++) {
+            for (int k = 0; k < 8; k++) {
+                r_rows[(y + k) * p_width + x] = p_columns[x * p_height + y + k];
+            }
+        }
+    }
+    for (; y < p_to_row; y++) {
+        for (int x = 0; x < p_width; x++) {
+            r_rows[y * p_width + x] = p_columns[x * p_height + y];
+        }
+    }
+}
+
+static const RaycasterKernels avx2_kernels = {
+    "avx2",
+    avx2_fill_span,
+    avx2_draw_wall_span,
+    avx2_draw_floor_span,
+    avx2_transpose,
+};
+
+const RaycasterKernels *raycaster_get_avx2_kernels() {
+    return &avx2_kernels;
+}
+
+#else
+
+const RaycasterKernels *raycaster_get_avx2_kernels() {
+    return nullptr;
+}
+
+#endif // x86_64
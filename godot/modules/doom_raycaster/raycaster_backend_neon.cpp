@@ -0,0 +1,147 @@
+#include "raycaster_backend.h"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+#include <arm_neon.h>
+
+// Note: the floor kernel uses separate multiply and add like the scalar code. Compilers that
+// contract the scalar mul + add into fused ops (GCC's default on arm64) can make floor texels
+// differ by one texel at wrap boundaries, so the module's SCsub builds with -ffp-contract=off.
+
+static void neon_fill_span(uint32_t *r_dst, int p_count, uint32_t p_color) {
+    uint32x4_t color = vdupq_n_u32(p_color);
+    int i = 0;
+    for (; i + 4 <= p_count; i += 4) {
+        vst1q_u32(r_dst + i, color);
+    }
+    for (; i < p_count; i++) {
+        r_dst[i] = p_color;
+    }
+}
+
+static inline uint16x4_t neon_shade_channels(uint16x4_t p_channels, float32x4_t p_shade) {
+    uint32x4_t scaled = vcvtq_u32_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(p_channels)), p_shade));
+    return vqmovn_u32(scaled);
+}
+
+// Scales the rgb of four packed pixels by p_shade, with the same float math as raycaster_shade_texel
+static inline uint32x4_t neon_shade4(uint32x4_t p_pixels, float32x4_t p_shade) {
+    uint8x16_t bytes = vreinterpretq_u8_u32(p_pixels);
+    uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+    uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+    uint16x8_t shaded_lo = vcombine_u16(neon_shade_channels(vget_low_u16(lo), p_shade), neon_shade_channels(vget_high_u16(lo), p_shade));
+    uint16x8_t shaded_hi = vcombine_u16(neon_shade_channels(vget_low_u16(hi), p_shade), neon_shade_channels(vget_high_u16(hi), p_shade));
+    // Saturating narrow clamps to 255 like the scalar MIN
+    uint8x16_t packed = vcombine_u8(vqmovn_u16(shaded_lo), vqmovn_u16(shaded_hi));
+    return vorrq_u32(vreinterpretq_u32_u8(packed), vdupq_n_u32(RAYCASTER_ALPHA_MASK));
+}
+
+static void neon_draw_wall_span(uint32_t *r_dst, int p_count, const RaycasterTexture &p_tex, int p_tex_x, float p_tex_pos, float p_tex_step, float p_shade) {
+    const uint32_t *column = p_tex.texels + p_tex_x;
+    const float32x4_t shade = vdupq_n_f32(p_shade);
+    uint32_t texels[4];
+    int i = 0;
+    for (; i + 4 <= p_count; i += 4) {
+        // Texel rows stay sequential so tex_pos accumulates exactly like the scalar loop
+        for (int k = 0; k < 4; k++) {
+            texels[k] = column[raycaster_wrap_row(p_tex_pos, p_tex.height) * p_tex.width];
+            p_tex_pos += p_tex_step;
+        }
+        vst1q_u32(r_dst + i, neon_shade4(vld1q_u32(texels), shade));
+    }
+    for (; i < p_count; i++) {
+        r_dst[i] = raycaster_shade_texel(column[raycaster_wrap_row(p_tex_pos, p_tex.height) * p_tex.width], p_shade);
+        p_tex_pos += p_tex_step;
+    }
+}
+
+static inline int32x4_t neon_texel_coord(float32x4_t p_world, float32x4_t p_size_f, int32x4_t p_size) {
+    int32x4_t coord = vcvtq_s32_f32(vmulq_f32(vsubq_f32(p_world, vrndmq_f32(p_world)), p_size_f));
+    uint32x4_t overflow = vcgeq_s32(coord, p_size);
+    return vsubq_s32(coord, vandq_s32(vreinterpretq_s32_u32(overflow), p_size));
+}
+
+static void neon_draw_floor_span(uint32_t *r_dst, const float *p_row_dist, int p_count, float p_pos_x, float p_pos_y, float p_dir_x, float p_dir_y, const RaycasterTexture &p_tex, uint32_t p_fallback) {
+    const float32x4_t pos_x = vdupq_n_f32(p_pos_x);
+    const float32x4_t pos_y = vdupq_n_f32(p_pos_y);
+    const float32x4_t width_f = vdupq_n_f32((float)p_tex.width);
+    const float32x4_t height_f = vdupq_n_f32((float)p_tex.height);
+    const int32x4_t width = vdupq_n_s32(p_tex.width);
+    const int32x4_t height = vdupq_n_s32(p_tex.height);
+
+    int32_t index[4];
+    uint32_t valid[4];
+    int i = 0;
+    for (; i + 4 <= p_count; i += 4) {
+        float32x4_t row_dist = vld1q_f32(p_row_dist + i);
+        vst1q_u32(valid, vcgtq_f32(row_dist, vdupq_n_f32(0.0f)));
+
+        float32x4_t world_x = vaddq_f32(pos_x, vmulq_n_f32(row_dist, p_dir_x));
+        float32x4_t world_y = vaddq_f32(pos_y, vmulq_n_f32(row_dist, p_dir_y));
+        int32x4_t tex_x = neon_texel_coord(world_x, width_f, width);
+        int32x4_t tex_y = neon_texel_coord(world_y, height_f, height);
+        vst1q_s32(index, vmlaq_s32(tex_x, tex_y, width));
+
+        for (int k = 0; k < 4; k++) {
+            r_dst[i + k] = valid[k] ? (p_tex.texels[index[k]] | RAYCASTER_ALPHA_MASK) : p_fallback;
+        }
+    }
+    for (; i < p_count; i++) {
+        float row_dist = p_row_dist[i];
+        if (row_dist > 0.0f) {
+            r_dst[i] = raycaster_sample_floor(p_pos_x + p_dir_x * row_dist, p_pos_y + p_dir_y * row_dist, p_tex);
+        } else {
+            r_dst[i] = p_fallback;
+        }
+    }
+}
+
+static void neon_transpose(const uint32_t *p_columns, int p_width, int p_height, uint32_t *r_rows, int p_from_row, int p_to_row) {
+    int y = p_from_row;
+    for (; y + 4 <= p_to_row; y += 4) {
+        int x = 0;
+        for (; x + 4 <= p_width; x += 4) {
+            uint32x4_t c0 = vld1q_u32(p_columns + (x + 0) * p_height + y);
+            uint32x4_t c1 = vld1q_u32(p_columns + (x + 1) * p_height + y);
+            uint32x4_t c2 = vld1q_u32(p_columns + (x + 2) * p_height + y);
+            uint32x4_t c3 = vld1q_u32(p_columns + (x + 3) * p_height + y);
+            uint32x4x2_t t01 = vtrnq_u32(c0, c1);
+            uint32x4x2_t t23 = vtrnq_u32(c2, c3);
+            uint32_t *dst = r_rows + y * p_width + x;
+            vst1q_u32(dst + 0 * p_width, vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+            vst1q_u32(dst + 1 * p_width, vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+            vst1q_u32(dst + 2 * p_width, vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+            vst1q_u32(dst + 3 * p_width, vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+        }
+        for (; x < p_width; x++) {
+            for (int k = 0; k < 4; k++) {
+                r_rows[(y + k) * p_width + x] = p_columns[x * p_height + y + k];
+            }
+        }
+    }
+    for (; y < p_to_row; y++) {
+        for (int x = 0; x < p_width; x++) {
+            r_rows[y * p_width + x] = p_columns[x * p_height + y];
+        }
+    }
+}
+
+static const RaycasterKernels neon_kernels = {
+    "neon",
+    neon_fill_span,
+    neon_draw_wall_span,
+    neon_draw_floor_span,
+    neon_transpose,
+};
+
+const RaycasterKernels *raycaster_get_neon_kernels() {
+    return &neon_kernels;
+}
+
+#else
+
+const RaycasterKernels *raycaster_get_neon_kernels() {
+    return nullptr;
+}
+
+#endif // arm64
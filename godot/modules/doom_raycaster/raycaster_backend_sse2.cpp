@@ -0,0 +1,156 @@
+#include "raycaster_backend.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+static void sse2_fill_span(uint32_t *r_dst, int p_count, uint32_t p_color) {
+    __m128i color = _mm_set1_epi32((int)p_color);
+    int i = 0;
+    for (; i + 4 <= p_count; i += 4) {
+        _mm_storeu_si128((__m128i *)(r_dst + i), color);
+    }
+    for (; i < p_count; i++) {
+        r_dst[i] = p_color;
+    }
+}
+
+// Scales the rgb of four packed pixels by p_shade, with the same float math as raycaster_shade_texel
+static _FORCE_INLINE_ __m128i sse2_shade4(__m128i p_pixels, __m128 p_shade) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_unpacklo_epi8(p_pixels, zero);
+    __m128i hi = _mm_unpackhi_epi8(p_pixels, zero);
+    __m128i p0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), p_shade));
+    __m128i p1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), p_shade));
+    __m128i p2 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), p_shade));
+    __m128i p3 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), p_shade));
+    // Saturating packs clamp to 255 like the scalar MIN
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+    return _mm_or_si128(packed, _mm_set1_epi32((int)RAYCASTER_ALPHA_MASK));
+}
+
+static void sse2_draw_wall_span(uint32_t *r_dst, int p_count, const RaycasterTexture &p_tex, int p_tex_x, float p_tex_pos, float p_tex_step, float p_shade) {
+    const uint32_t *column = p_tex.texels + p_tex_x;
+    const int width = p_tex.width;
+    const __m128 shade = _mm_set1_ps(p_shade);
+    int i = 0;
+    for (; i + 4 <= p_count; i += 4) {
+        // Texel rows stay sequential so tex_pos accumulates exactly like the scalar loop
+        uint32_t t0 = column[raycaster_wrap_row(p_tex_pos, p_tex.height) * width];
+        p_tex_pos += p_tex_step;
+        uint32_t t1 = column[raycaster_wrap_row(p_tex_pos, p_tex.height) * width];
+        p_tex_pos += p_tex_step;
+        uint32_t t2 = column[raycaster_wrap_row(p_tex_pos, p_tex.height) * width];
+        p_tex_pos += p_tex_step;
+        uint32_t t3 = column[raycaster_wrap_row(p_tex_pos, p_tex.height) * width];
+        p_tex_pos += p_tex_step;
+        __m128i pixels = _mm_set_epi32((int)t3, (int)t2, (int)t1, (int)t0);
+        _mm_storeu_si128((__m128i *)(r_dst + i), sse2_shade4(pixels, shade));
+    }
+    for (; i < p_count; i++) {
+        r_dst[i] = raycaster_shade_texel(column[raycaster_wrap_row(p_tex_pos, p_tex.height) * width], p_shade);
+        p_tex_pos += p_tex_step;
+    }
+}
+
+// floor() for |x| < 2^31 without SSE4.1
+static _FORCE_INLINE_ __m128 sse2_floor(__m128 p_x) {
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(p_x));
+    return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, p_x), _mm_set1_ps(1.0f)));
+}
+
+// Texel coordinate of a world coordinate, wrapped to [0, p_size)
+static _FORCE_INLINE_ __m128i sse2_texel_coord(__m128 p_world, __m128 p_size_f, __m128i p_size) {
+    __m128i coord = _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(p_world, sse2_floor(p_world)), p_size_f));
+    __m128i overflow = _mm_cmpgt_epi32(coord, _mm_sub_epi32(p_size, _mm_set1_epi32(1)));
+    return _mm_sub_epi32(coord, _mm_and_si128(overflow, p_size));
+}
+
+static void sse2_draw_floor_span(uint32_t *r_dst, const float *p_row_dist, int p_count, float p_pos_x, float p_pos_y, float p_dir_x, float p_dir_y, const RaycasterTexture &p_tex, uint32_t p_fallback) {
+    const __m128 pos_x = _mm_set1_ps(p_pos_x);
+    const __m128 pos_y = _mm_set1_ps(p_pos_y);
+    const __m128 dir_x = _mm_set1_ps(p_dir_x);
+    const __m128 dir_y = _mm_set1_ps(p_dir_y);
+    const __m128 width_f = _mm_set1_ps((float)p_tex.width);
+    const __m128 height_f = _mm_set1_ps((float)p_tex.height);
+    const __m128i width = _mm_set1_epi32(p_tex.width);
+    const __m128i height = _mm_set1_epi32(p_tex.height);
+
+    alignas(16) int32_t tex_x[4];
+    alignas(16) int32_t tex_y[4];
+    int i = 0;
+    for (; i + 4 <= p_count; i += 4) {
+        __m128 row_dist = _mm_loadu_ps(p_row_dist + i);
+        int valid = _mm_movemask_ps(_mm_cmpgt_ps(row_dist, _mm_setzero_ps()));
+
+        __m128 world_x = _mm_add_ps(pos_x, _mm_mul_ps(dir_x, row_dist));
+        __m128 world_y = _mm_add_ps(pos_y, _mm_mul_ps(dir_y, row_dist));
+        _mm_store_si128((__m128i *)tex_x, sse2_texel_coord(world_x, width_f, width));
+        _mm_store_si128((__m128i *)tex_y, sse2_texel_coord(world_y, height_f, height));
+
+        // No gather in SSE2
+        for (int k = 0; k < 4; k++) {
+            r_dst[i + k] = (valid & (1 << k)) ? (p_tex.texels[tex_y[k] * p_tex.width + tex_x[k]] | RAYCASTER_ALPHA_MASK) : p_fallback;
+        }
+    }
+    for (; i < p_count; i++) {
+        float row_dist = p_row_dist[i];
+        if (row_dist > 0.0f) {
+            r_dst[i] = raycaster_sample_floor(p_pos_x + p_dir_x * row_dist, p_pos_y + p_dir_y * row_dist, p_tex);
+        } else {
+            r_dst[i] = p_fallback;
+        }
+    }
+}
+
+static void sse2_transpose(const uint32_t *p_columns, int p_width, int p_height, uint32_t *r_rows, int p_from_row, int p_to_row) {
+    int y = p_from_row;
+    for (; y + 4 <= p_to_row; y += 4) {
+        int x = 0;
+        for (; x + 4 <= p_width; x += 4) {
+            // Four rows of four columns in, four columns of four rows out
+            __m128i c0 = _mm_loadu_si128((const __m128i *)(p_columns + (x + 0) * p_height + y));
+            __m128i c1 = _mm_loadu_si128((const __m128i *)(p_columns + (x + 1) * p_height + y));
+            __m128i c2 = _mm_loadu_si128((const __m128i *)(p_columns + (x + 2) * p_height + y));
+            __m128i c3 = _mm_loadu_si128((const __m128i *)(p_columns + (x + 3) * p_height + y));
+            __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+            __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+            __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+            __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+            _mm_storeu_si128((__m128i *)(r_rows + (y + 0) * p_width + x), _mm_unpacklo_epi64(t0, t1));
+            _mm_storeu_si128((__m128i *)(r_rows + (y + 1) * p_width + x), _mm_unpackhi_epi64(t0, t1));
+            _mm_storeu_si128((__m128i *)(r_rows + (y + 2) * p_width + x), _mm_unpacklo_epi64(t2, t3));
+            _mm_storeu_si128((__m128i *)(r_rows + (y + 3) * p_width + x), _mm_unpackhi_epi64(t2, t3));
+        }
+        for (; x < p_width; x++) {
+            for (int k = 0; k < 4; k++) {
+                r_rows[(y + k) * p_width + x] = p_columns[x * p_height + y + k];
+            }
+        }
+    }
+    for (; y < p_to_row; y++) {
+        for (int x = 0; x < p_width; x++) {
+            r_rows[y * p_width + x] = p_columns[x * p_height + y];
+        }
+    }
+}
+
+static const RaycasterKernels sse2_kernels = {
+    "sse2",
+    sse2_fill_span,
+    sse2_draw_wall_span,
+    sse2_draw_floor_span,
+    sse2_transpose,
+};
+
+const RaycasterKernels *raycaster_get_sse2_kernels() {
+    return &sse2_kernels;
+}
+
+#else
+
+const RaycasterKernels *raycaster_get_sse2_kernels() {
+    return nullptr;
+}
+
+#endif // x86_64
@@ -0,0 +1,213 @@
+#include "raycaster_entities.h"
+#include "core/error/error_macros.h"
+#include "core/math/math_funcs.h"
+#include "core/templates/hashfuncs.h"
+
+// Positions outside the map fall into the nearest edge bucket. Clamping never moves two
+// points further apart, so the ring bounds the queries use still hold for them.
+int RaycasterEntityGrid::get_bucket(Vector2 p_position) const{
+    int x = CLAMP((int)Math::floor(p_position.x), 0, width - 1);
+    int y = CLAMP((int)Math::floor(p_position.y), 0, height - 1);
+    return y * width + x;
+}
+
+void RaycasterEntityGrid::link(int p_id){
+    Entity &entity = entities[p_id];
+    entity.bucket = get_bucket(entity.position);
+    entity.prev = -1;
+    entity.next = buckets[entity.bucket];
+    if (entity.next >= 0) {
+        entities[entity.next].prev = p_id;
+    }
+    buckets[entity.bucket] = p_id;
+}
+
+void RaycasterEntityGrid::unlink(int p_id){
+    Entity &entity = entities[p_id];
+    if (entity.prev >= 0) {
+        entities[entity.prev].next = entity.next;
+    } else {
+        buckets[entity.bucket] = entity.next;
+    }
+    if (entity.next >= 0) {
+        entities[entity.next].prev = entity.prev;
+    }
+    entity.bucket = -1;
+    entity.prev = -1;
+    entity.next = -1;
+}
+
+// Rebuckets every entity for the new map size; ids stay the same
+void RaycasterEntityGrid::resize(int p_width, int p_height){
+    width = MAX(1, p_width);
+    height = MAX(1, p_height);
+    buckets.resize(width * height);
+    for (uint32_t i = 0; i < buckets.size(); i++) {
+        buckets[i] = -1;
+    }
+    for (uint32_t i = 0; i < entities.size(); i++) {
+        if (entities[i].active) {
+            link(i);
+        }
+    }
+}
+
+void RaycasterEntityGrid::clear(){
+    entities.clear();
+    free_ids.clear();
+    count = 0;
+    max_radius = 0.0f;
+    for (uint32_t i = 0; i < buckets.size(); i++) {
+        buckets[i] = -1;
+    }
+}
+
+int RaycasterEntityGrid::add(Vector2 p_position, float p_radius, int p_sprite, uint32_t p_flags){
+    ERR_FAIL_COND_V(buckets.size() == 0, -1);
+    ERR_FAIL_COND_V(p_radius < 0.0f, -1);
+
+    int id;
+    if (free_ids.size() > 0) {
+        id = free_ids[free_ids.size() - 1];
+        free_ids.resize(free_ids.size() - 1);
+    } else {
+        id = entities.size();
+        entities.push_back(Entity());
+    }
+
+    Entity &entity = entities[id];
+    entity.active = true;
+    entity.position = p_position;
+    entity.radius = p_radius;
+    entity.sprite = p_sprite;
+    entity.flags = p_flags;
+    link(id);
+
+    count++;
+    max_radius = MAX(max_radius, p_radius);
+    return id;
+}
+
+void RaycasterEntityGrid::remove(int p_id){
+    ERR_FAIL_COND(!has(p_id));
+    unlink(p_id);
+    entities[p_id].active = false;
+    free_ids.push_back(p_id);
+    count--;
+}
+
+void RaycasterEntityGrid::move(int p_id, Vector2 p_position){
+    ERR_FAIL_COND(!has(p_id));
+    Entity &entity = entities[p_id];
+    entity.position = p_position;
+
+    // Most moves stay inside the cell
+    if (get_bucket(p_position) != entity.bucket) {
+        unlink(p_id);
+        link(p_id);
+    }
+}
+
+void RaycasterEntityGrid::set_flags(int p_id, uint32_t p_flags){
+    ERR_FAIL_COND(!has(p_id));
+    entities[p_id].flags = p_flags;
+}
+
+void RaycasterEntityGrid::set_sprite(int p_id, int p_sprite){
+    ERR_FAIL_COND(!has(p_id));
+    entities[p_id].sprite = p_sprite;
+}
+
+uint32_t RaycasterEntityGrid::hash() const{
+    uint32_t h = hash_murmur3_one_32(count);
+    for (uint32_t i = 0; i < entities.size(); i++) {
+        const Entity &entity = entities[i];
+        if (!entity.active) {
+            continue;
+        }
+        h = hash_murmur3_one_32(i, h);
+        h = hash_murmur3_one_float(entity.position.x, h);
+        h = hash_murmur3_one_float(entity.position.y, h);
+        h = hash_murmur3_one_float(entity.radius, h);
+        h = hash_murmur3_one_32(entity.sprite, h);
+        h = hash_murmur3_one_32(entity.flags, h);
+    }
+    return hash_fmix32(h);
+}
+
+void RaycasterEntityGrid::query_circle(Vector2 p_center, float p_radius, uint32_t p_flags, LocalVector<int> &r_ids) const{
+    if (count == 0) {
+        return;
+    }
+
+    // Entities are bucketed by their center, so look max_radius further out
+    float reach = p_radius + max_radius;
+    int from_x = CLAMP((int)Math::floor(p_center.x - reach), 0, width - 1);
+    int from_y = CLAMP((int)Math::floor(p_center.y - reach), 0, height - 1);
+    int to_x = CLAMP((int)Math::floor(p_center.x + reach), 0, width - 1);
+    int to_y = CLAMP((int)Math::floor(p_center.y + reach), 0, height - 1);
+
+    for (int y = from_y; y <= to_y; y++) {
+        for (int x = from_x; x <= to_x; x++) {
+            for (int id = buckets[y * width + x]; id >= 0; id = entities[id].next) {
+                const Entity &entity = entities[id];
+                if ((entity.flags & p_flags) != p_flags) {
+                    continue;
+                }
+                float overlap = p_radius + entity.radius;
+                if (entity.position.distance_squared_to(p_center) <= overlap * overlap) {
+                    r_ids.push_back(id);
+                }
+            }
+        }
+    }
+}
+
+// Searches rings of buckets outwards from the center cell. An entity in ring r is at least
+// r - 1 cells away, so the search stops once that bound passes the best distance found.
+int RaycasterEntityGrid::find_nearest(Vector2 p_center, float p_max_distance, uint32_t p_flags, int p_exclude) const{
+    if (count == 0) {
+        return -1;
+    }
+
+    int center = get_bucket(p_center);
+    int center_x = center % width;
+    int center_y = center / width;
+    int max_ring = MAX(width, height);
+
+    int best = -1;
+    float best_dist_sq = p_max_distance * p_max_distance;
+    for (int ring = 0; ring <= max_ring; ring++) {
+        float bound = (float)(ring - 1);
+        if (bound > 0.0f && bound * bound > best_dist_sq) {
+            break;
+        }
+
+        int from_x = center_x - ring;
+        int to_x = center_x + ring;
+        int from_y = center_y - ring;
+        int to_y = center_y + ring;
+        for (int y = MAX(from_y, 0); y <= MIN(to_y, height - 1); y++) {
+            // Only the border of the ring: full rows at the top and bottom, two cells in between
+            bool edge_row = y == from_y || y == to_y;
+            int step = edge_row ? 1 : to_x - from_x;
+            for (int x = from_x; x <= to_x; x += MAX(step, 1)) {
+                if (x < 0 || x >= width) {
+                    continue;
+                }
+                for (int id = buckets[y * width + x]; id >= 0; id = entities[id].next) {
+                    const Entity &entity = entities[id];
+                    if (id == p_exclude || (entity.flags & p_flags) != p_flags) {
+                        continue;
+                    }
+                    float dist_sq = entity.position.distance_squared_to(p_center);
+                    if (dist_sq <= best_dist_sq) {
+                        best = id;
+                        best_dist_sq = dist_sq;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,60 @@
+#ifndef RAYCASTER_ENTITIES_H
+#define RAYCASTER_ENTITIES_H
+
+#include "core/math/vector2.h"
+#include "core/math/vector2i.h"
+#include "core/templates/local_vector.h"
+
+// Entities (NPCs, pickups, ...) bucketed in a uniform grid with one bucket per map cell.
+// Each bucket is an intrusive doubly linked list, so adding, removing and moving an
+// entity is O(1) and queries only walk the buckets around the query area.
+class RaycasterEntityGrid{
+    public:
+        struct Entity {
+            bool active = false;
+            Vector2 position;
+            float radius = 0.0f;
+            int sprite = -1;
+            uint32_t flags = 0;
+            // Bucket links, -1 = none
+            int bucket = -1;
+            int prev = -1;
+            int next = -1;
+        };
+
+    private:
+        int width = 0;
+        int height = 0;
+        LocalVector<int> buckets; // First entity of every cell
+        LocalVector<Entity> entities; // Indexed by id
+        LocalVector<int> free_ids;
+        int count = 0;
+        float max_radius = 0.0f; // Largest radius ever added, how far queries look past their own area
+
+        int get_bucket(Vector2 p_position) const;
+        void link(int p_id);
+        void unlink(int p_id);
+
+    public:
+        void resize(int p_width, int p_height);
+        void clear();
+
+        int add(Vector2 p_position, float p_radius, int p_sprite, uint32_t p_flags);
+        void remove(int p_id);
+        void move(int p_id, Vector2 p_position);
+        void set_flags(int p_id, uint32_t p_flags);
+        void set_sprite(int p_id, int p_sprite);
+
+        bool has(int p_id) const { return p_id >= 0 && p_id < (int)entities.size() && entities[p_id].active; }
+        const Entity &get(int p_id) const { return entities[p_id]; }
+        int get_count() const { return count; }
+        int get_capacity() const { return entities.size(); } // Ids are below this
+        uint32_t hash() const; // Over the ids and state of the active entities
+
+        // Entities whose circle overlaps the query circle and that have every flag in p_flags
+        void query_circle(Vector2 p_center, float p_radius, uint32_t p_flags, LocalVector<int> &r_ids) const;
+        // Closest entity center within p_max_distance, -1 if none
+        int find_nearest(Vector2 p_center, float p_max_distance, uint32_t p_flags, int p_exclude = -1) const;
+};
+
+#endif // RAYCASTER_ENTITIES_H
@@ -0,0 +1,232 @@
+#include "raycaster_map.h"
+#include "core/io/compression.h"
+#include "core/io/file_access.h"
+
+static const char RCMAP_MAGIC[4] = { 'R', 'C', 'M', 'P' };
+
+void RaycasterMap::_bind_methods(){
+    ClassDB::bind_method(D_METHOD("set_size", "width", "height"), &RaycasterMap::set_size);
+    ClassDB::bind_method(D_METHOD("get_width"), &RaycasterMap::get_width);
+    ClassDB::bind_method(D_METHOD("get_height"), &RaycasterMap::get_height);
+    ClassDB::bind_method(D_METHOD("set_cell", "cell", "value"), &RaycasterMap::set_cell);
+    ClassDB::bind_method(D_METHOD("get_cell", "cell"), &RaycasterMap::get_cell);
+    ClassDB::bind_method(D_METHOD("set_cells", "cells"), &RaycasterMap::set_cells);
+    ClassDB::bind_method(D_METHOD("get_cells"), &RaycasterMap::get_cells);
+    ClassDB::bind_method(D_METHOD("add_entity", "type", "position", "value"), &RaycasterMap::add_entity);
+    ClassDB::bind_method(D_METHOD("get_entity_count"), &RaycasterMap::get_entity_count);
+    ClassDB::bind_method(D_METHOD("get_entity", "index"), &RaycasterMap::get_entity);
+    ClassDB::bind_method(D_METHOD("clear_entities"), &RaycasterMap::clear_entities);
+    ClassDB::bind_method(D_METHOD("save_file", "path"), &RaycasterMap::save_file);
+    ClassDB::bind_method(D_METHOD("load_file", "path"), &RaycasterMap::load_file);
+}
+
+void RaycasterMap::set_size(int p_width, int p_height){
+    ERR_FAIL_COND(p_width < 0 || p_height < 0 || p_width > MAX_SIZE || p_height > MAX_SIZE);
+    width = p_width;
+    height = p_height;
+    cells.resize(width * height);
+    cells.fill(0);
+}
+
+int RaycasterMap::get_width() const{
+    return width;
+}
+
+int RaycasterMap::get_height() const{
+    return height;
+}
+
+void RaycasterMap::set_cell(Vector2i p_cell, int p_value){
+    ERR_FAIL_COND(p_cell.x < 0 || p_cell.y < 0 || p_cell.x >= width || p_cell.y >= height);
+    ERR_FAIL_COND(p_value < 0 || p_value > 255);
+    cells.write[p_cell.y * width + p_cell.x] = p_value;
+}
+
+int RaycasterMap::get_cell(Vector2i p_cell) const{
+    ERR_FAIL_COND_V(p_cell.x < 0 || p_cell.y < 0 || p_cell.x >= width || p_cell.y >= height, 1);
+    return cells[p_cell.y * width + p_cell.x];
+}
+
+void RaycasterMap::set_cells(const PackedByteArray &p_cells){
+    ERR_FAIL_COND_MSG(p_cells.size() != width * height, "RaycasterMap: Cell count must be width * height.");
+    cells = p_cells;
+}
+
+PackedByteArray RaycasterMap::get_cells() const{
+    return cells;
+}
+
+int RaycasterMap::add_entity(int p_type, Vector2 p_position, int p_value){
+    Entity entity;
+    entity.type = p_type;
+    entity.position = p_position;
+    entity.value = p_value;
+    entities.push_back(entity);
+    return entities.size() - 1;
+}
+
+int RaycasterMap::get_entity_count() const{
+    return entities.size();
+}
+
+Dictionary RaycasterMap::get_entity(int p_index) const{
+    ERR_FAIL_INDEX_V(p_index, entities.size(), Dictionary());
+    Dictionary entity;
+    entity["type"] = entities[p_index].type;
+    entity["position"] = entities[p_index].position;
+    entity["value"] = entities[p_index].value;
+    return entity;
+}
+
+void RaycasterMap::clear_entities(){
+    entities.clear();
+}
+
+Error RaycasterMap::save_file(const String &p_path) const{
+    Error err;
+    Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+    ERR_FAIL_COND_V_MSG(err != OK, err, "RaycasterMap: Cannot open '" + p_path + "' for writing.");
+
+    file->store_buffer((const uint8_t *)RCMAP_MAGIC, 4);
+    file->store_32(FORMAT_VERSION);
+    file->store_32(width);
+    file->store_32(height);
+
+    // Mazes are long runs of a few values, so zstd usually shrinks the cell layer by an order of magnitude
+    Vector<uint8_t> packed;
+    packed.resize(Compression::get_max_compressed_buffer_size(cells.size(), Compression::MODE_ZSTD));
+    int packed_size = cells.size() > 0 ? Compression::compress(packed.ptrw(), cells.ptr(), cells.size(), Compression::MODE_ZSTD) : -1;
+    bool compressed = packed_size > 0 && packed_size < cells.size();
+
+    file->store_32(1); // Layer count
+    file->store_32(LAYER_CELLS);
+    file->store_32(compressed ? ENCODING_ZSTD : ENCODING_RAW);
+    file->store_32(cells.size());
+    if (compressed) {
+        file->store_32(packed_size);
+        file->store_buffer(packed.ptr(), packed_size);
+    } else {
+        file->store_32(cells.size());
+        file->store_buffer(cells.ptr(), cells.size());
+    }
+
+    file->store_32(entities.size());
+    for (int i = 0; i < entities.size(); i++) {
+        file->store_32(entities[i].type);
+        file->store_float(entities[i].position.x);
+        file->store_float(entities[i].position.y);
+        file->store_32(entities[i].value);
+    }
+
+    return file->get_error() == OK ? OK : ERR_FILE_CANT_WRITE;
+}
+
+// Streams the file through FileAccess (so it works from a PCK): raw layers are read
+// straight into the cell buffer, compressed ones are decompressed into it in one call.
+Error RaycasterMap::load_file(const String &p_path){
+    Error err;
+    Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ, &err);
+    ERR_FAIL_COND_V_MSG(err != OK, err, "RaycasterMap: Cannot open '" + p_path + "'.");
+
+    char magic[4];
+    file->get_buffer((uint8_t *)magic, 4);
+    ERR_FAIL_COND_V_MSG(memcmp(magic, RCMAP_MAGIC, 4) != 0, ERR_FILE_UNRECOGNIZED, "RaycasterMap: '" + p_path + "' is not a maze file.");
+    uint32_t version = file->get_32();
+    ERR_FAIL_COND_V_MSG(version > FORMAT_VERSION, ERR_FILE_UNRECOGNIZED, "RaycasterMap: '" + p_path + "' uses a newer format version (" + itos(version) + ").");
+
+    uint32_t new_width = file->get_32();
+    uint32_t new_height = file->get_32();
+    ERR_FAIL_COND_V_MSG(new_width > (uint32_t)MAX_SIZE || new_height > (uint32_t)MAX_SIZE, ERR_FILE_CORRUPT, "RaycasterMap: Invalid maze size in '" + p_path + "'.");
+
+    Vector<uint8_t> new_cells;
+    new_cells.resize(new_width * new_height);
+    new_cells.fill(0);
+
+    uint32_t layer_count = file->get_32();
+    for (uint32_t i = 0; i < layer_count; i++) {
+        uint32_t id = file->get_32();
+        uint32_t encoding = file->get_32();
+        uint32_t raw_size = file->get_32();
+        uint32_t stored_size = file->get_32();
+        ERR_FAIL_COND_V(file->eof_reached() || stored_size > file->get_length() - file->get_position(), ERR_FILE_CORRUPT);
+
+        if (id != LAYER_CELLS) {
+            file->seek(file->get_position() + stored_size);
+            continue;
+        }
+
+        ERR_FAIL_COND_V_MSG(raw_size != (uint32_t)new_cells.size(), ERR_FILE_CORRUPT, "RaycasterMap: Cell layer size does not match the maze size in '" + p_path + "'.");
+        if (encoding == ENCODING_RAW) {
+            ERR_FAIL_COND_V(stored_size != raw_size, ERR_FILE_CORRUPT);
+            ERR_FAIL_COND_V(file->get_buffer(new_cells.ptrw(), raw_size) != raw_size, ERR_FILE_CORRUPT);
+        } else if (encoding == ENCODING_ZSTD) {
+            Vector<uint8_t> packed;
+            packed.resize(stored_size);
+            ERR_FAIL_COND_V(file->get_buffer(packed.ptrw(), stored_size) != stored_size, ERR_FILE_CORRUPT);
+            int result = Compression::decompress(new_cells.ptrw(), new_cells.size(), packed.ptr(), stored_size, Compression::MODE_ZSTD);
+            ERR_FAIL_COND_V_MSG(result != (int)raw_size, ERR_FILE_CORRUPT, "RaycasterMap: Cannot decompress the cell layer of '" + p_path + "'.");
+        } else {
+            ERR_FAIL_V_MSG(ERR_FILE_UNRECOGNIZED, "RaycasterMap: Unknown layer encoding " + itos(encoding) + " in '" + p_path + "'.");
+        }
+    }
+
+    uint32_t entity_count = file->get_32();
+    ERR_FAIL_COND_V(file->eof_reached() || (uint64_t)entity_count * 16 > file->get_length() - file->get_position(), ERR_FILE_CORRUPT);
+    Vector<Entity> new_entities;
+    new_entities.resize(entity_count);
+    for (uint32_t i = 0; i < entity_count; i++) {
+        Entity &entity = new_entities.write[i];
+        entity.type = (int32_t)file->get_32();
+        entity.position.x = file->get_float();
+        entity.position.y = file->get_float();
+        entity.value = (int32_t)file->get_32();
+    }
+
+    width = new_width;
+    height = new_height;
+    cells = new_cells;
+    entities = new_entities;
+    emit_changed();
+    return OK;
+}
+
+Ref<Resource> ResourceFormatLoaderRaycasterMap::load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode){
+    Ref<RaycasterMap> map;
+    map.instantiate();
+    Error err = map->load_file(p_path);
+    if (r_error) {
+        *r_error = err;
+    }
+    if (err != OK) {
+        return Ref<Resource>();
+    }
+    return map;
+}
+
+void ResourceFormatLoaderRaycasterMap::get_recognized_extensions(List<String> *p_extensions) const{
+    p_extensions->push_back("rcmap");
+}
+
+bool ResourceFormatLoaderRaycasterMap::handles_type(const String &p_type) const{
+    return ClassDB::is_parent_class(p_type, "RaycasterMap");
+}
+
+String ResourceFormatLoaderRaycasterMap::get_resource_type(const String &p_path) const{
+    return p_path.get_extension().to_lower() == "rcmap" ? "RaycasterMap" : "";
+}
+
+Error ResourceFormatSaverRaycasterMap::save(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags){
+    Ref<RaycasterMap> map = p_resource;
+    ERR_FAIL_COND_V(map.is_null(), ERR_INVALID_PARAMETER);
+    return map->save_file(p_path);
+}
+
+bool ResourceFormatSaverRaycasterMap::recognize(const Ref<Resource> &p_resource) const{
+    return Object::cast_to<RaycasterMap>(*p_resource) != nullptr;
+}
+
+void ResourceFormatSaverRaycasterMap::get_recognized_extensions(const Ref<Resource> &p_resource, List<String> *p_extensions) const{
+    if (Object::cast_to<RaycasterMap>(*p_resource)) {
+        p_extensions->push_back("rcmap");
+    }
+}
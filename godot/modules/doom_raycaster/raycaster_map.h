@@ -0,0 +1,82 @@
+#ifndef RAYCASTER_MAP_H
+#define RAYCASTER_MAP_H
+
+#include "core/io/resource.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+
+// A maze stored as a resource: one byte per cell (0 = empty, 1 = wall, 2 = key, ...)
+// plus a table of entities. Saved and loaded as the compact .rcmap binary format.
+class RaycasterMap : public Resource{
+    GDCLASS(RaycasterMap, Resource);
+
+    public:
+        // File layout, all little endian:
+        //   "RCMP", u32 version, u32 width, u32 height
+        //   u32 layer count, then per layer: u32 id, u32 encoding, u32 raw size, u32 stored size, stored bytes
+        //   u32 entity count, then per entity: u32 type, float x, float y, s32 value
+        // Unknown layers are skipped, so newer files with extra layers still load.
+        static const uint32_t FORMAT_VERSION = 1;
+        static const int MAX_SIZE = 16384; // Per side
+
+        enum Layer {
+            LAYER_CELLS = 0,
+        };
+
+        enum Encoding {
+            ENCODING_RAW = 0,
+            ENCODING_ZSTD = 1,
+        };
+
+        struct Entity {
+            int type = 0;
+            Vector2 position;
+            int value = 0;
+        };
+
+    private:
+        int width = 0;
+        int height = 0;
+        Vector<uint8_t> cells;
+        Vector<Entity> entities;
+
+    protected:
+        static void _bind_methods();
+
+    public:
+        void set_size(int p_width, int p_height);
+        int get_width() const;
+        int get_height() const;
+
+        void set_cell(Vector2i p_cell, int p_value);
+        int get_cell(Vector2i p_cell) const;
+        void set_cells(const PackedByteArray &p_cells);
+        PackedByteArray get_cells() const;
+        const uint8_t *get_cell_data() const { return cells.ptr(); }
+
+        int add_entity(int p_type, Vector2 p_position, int p_value);
+        int get_entity_count() const;
+        Dictionary get_entity(int p_index) const;
+        const Entity &get_entity_data(int p_index) const { return entities[p_index]; }
+        void clear_entities();
+
+        Error save_file(const String &p_path) const;
+        Error load_file(const String &p_path);
+};
+
+class ResourceFormatLoaderRaycasterMap : public ResourceFormatLoader{
+    public:
+        virtual Ref<Resource> load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE) override;
+        virtual void get_recognized_extensions(List<String> *p_extensions) const override;
+        virtual bool handles_type(const String &p_type) const override;
+        virtual String get_resource_type(const String &p_path) const override;
+};
+
+class ResourceFormatSaverRaycasterMap : public ResourceFormatSaver{
+    public:
+        virtual Error save(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags = 0) override;
+        virtual bool recognize(const Ref<Resource> &p_resource) const override;
+        virtual void get_recognized_extensions(const Ref<Resource> &p_resource, List<String> *p_extensions) const override;
+};
+
+#endif // RAYCASTER_MAP_H
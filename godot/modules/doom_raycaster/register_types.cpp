@@ -1,16 +1,31 @@
 #include "register_types.h"
 #include "doom_raycaster.h"
+#include "raycaster_map.h"
 #include "core/object/class_db.h"
 
+static Ref<ResourceFormatLoaderRaycasterMap> raycaster_map_loader;
+static Ref<ResourceFormatSaverRaycasterMap> raycaster_map_saver;
+
 void initialize_doom_raycaster_module(ModuleInitializationLevel p_level){
     if(p_level != MODULE_INITIALIZATION_LEVEL_SCENE){
         return;
     }
     ClassDB::register_class<DoomRaycaster>();
+    ClassDB::register_class<RaycasterMap>();
+    
+    raycaster_map_loader.instantiate();
+    ResourceLoader::add_resource_format_loader(raycaster_map_loader);
+    raycaster_map_saver.instantiate();
+    ResourceSaver::add_resource_format_saver(raycaster_map_saver);
 }
 
 void uninitialize_doom_raycaster_module(ModuleInitializationLevel p_level){
     if(p_level != MODULE_INITIALIZATION_LEVEL_SCENE){
         return;
     }
+    
+    ResourceLoader::remove_resource_format_loader(raycaster_map_loader);
+    raycaster_map_loader.unref();
+    ResourceSaver::remove_resource_format_saver(raycaster_map_saver);
+    raycaster_map_saver.unref();
 }
\ No newline at end of file
@@ -0,0 +1,841 @@
+#ifndef TEST_DOOM_RAYCASTER_H
+#define TEST_DOOM_RAYCASTER_H
+
+#include "../doom_raycaster.h"
+
+#include "core/config/engine.h"
+#include "core/io/dir_access.h"
+#include "core/math/random_pcg.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestDoomRaycaster {
+
+// 8x8 room with a border wall, a pillar at (4, 3) and a key at (5, 5)
+static DoomRaycaster *make_raycaster(){
+    static const int CELLS[64] = {
+        1, 1, 1, 1, 1, 1, 1, 1,
+        1, 0, 0, 0, 0, 0, 0, 1,
+        1, 0, 0, 0, 0, 0, 0, 1,
+        1, 0, 0, 0, 1, 0, 0, 1,
+        1, 0, 0, 0, 0, 0, 0, 1,
+        1, 0, 0, 0, 0, 2, 0, 1,
+        1, 0, 0, 0, 0, 0, 0, 1,
+        1, 1, 1, 1, 1, 1, 1, 1,
+    };
+    Array map;
+    for (int i = 0; i < 64; i++) {
+        map.push_back(CELLS[i]);
+    }
+
+    DoomRaycaster *raycaster = memnew(DoomRaycaster);
+    raycaster->set_map(map, 8, 8);
+    raycaster->set_player_position(Vector2(1.5f, 1.5f));
+    raycaster->set_player_angle(0.6f);
+    return raycaster;
+}
+
+static Ref<Image> make_texture(int p_width, int p_height, int p_seed){
+    Ref<Image> image = Image::create_empty(p_width, p_height, false, Image::FORMAT_RGBA8);
+    for (int y = 0; y < p_height; y++) {
+        for (int x = 0; x < p_width; x++) {
+            image->set_pixel(x, y, Color::from_rgba8((x * 37 + p_seed) & 0xFF, (y * 59 + p_seed * 3) & 0xFF, ((x ^ y) * 11) & 0xFF));
+        }
+    }
+    return image;
+}
+
+// Every SIMD backend this CPU runs (plus the threaded one) must match the scalar reference exactly
+static void check_backends_match_scalar(DoomRaycaster *p_raycaster){
+    uint32_t features = raycaster_get_cpu_features();
+    struct {
+        DoomRaycaster::RenderBackend backend;
+        bool supported;
+    } backends[] = {
+        { DoomRaycaster::RENDER_BACKEND_SSE2, (features & RAYCASTER_CPU_SSE2) && raycaster_get_sse2_kernels() },
+        { DoomRaycaster::RENDER_BACKEND_AVX2, (features & RAYCASTER_CPU_AVX2) && raycaster_get_avx2_kernels() },
+        { DoomRaycaster::RENDER_BACKEND_NEON, (features & RAYCASTER_CPU_NEON) && raycaster_get_neon_kernels() },
+        { DoomRaycaster::RENDER_BACKEND_THREADED, true },
+    };
+    for (const auto &entry : backends) {
+        if (!entry.supported) {
+            continue;
+        }
+        CHECK_MESSAGE(p_raycaster->compare_with_reference(entry.backend) == 0, vformat("Backend %d should render the same pixels as the scalar one.", (int)entry.backend));
+    }
+}
+
+TEST_CASE("[DoomRaycaster] SIMD backends match the scalar reference") {
+    DoomRaycaster *raycaster = make_raycaster();
+
+    SUBCASE("Flat colors") {
+        check_backends_match_scalar(raycaster);
+    }
+
+    SUBCASE("Textured walls, floor and sky") {
+        raycaster->set_wall_texture(make_texture(64, 64, 1));
+        raycaster->set_floor_texture(make_texture(32, 32, 2));
+        raycaster->set_ceiling_texture(make_texture(128, 32, 3));
+        check_backends_match_scalar(raycaster);
+    }
+
+    SUBCASE("Lit floor and walls") {
+        raycaster->set_floor_texture(make_texture(32, 32, 2));
+        raycaster->set_lighting_enabled(true);
+        raycaster->add_light(Vector2i(3, 2), 1.5f, 4);
+        check_backends_match_scalar(raycaster);
+    }
+
+    memdelete(raycaster);
+}
+
+static void check_light_levels_match(DoomRaycaster *p_a, DoomRaycaster *p_b){
+    int mismatches = 0;
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            if (!Math::is_equal_approx(p_a->get_light_level(Vector2i(x, y)), p_b->get_light_level(Vector2i(x, y)))) {
+                mismatches++;
+            }
+        }
+    }
+    CHECK_MESSAGE(mismatches == 0, "Incremental re-baking should give the levels of a full bake.");
+}
+
+TEST_CASE("[DoomRaycaster] Baked lights") {
+    DoomRaycaster *raycaster = make_raycaster();
+    const float ambient = raycaster->get_ambient_light();
+    
+    // One step costs intensity / (radius + 1)
+    int light = raycaster->add_light(Vector2i(3, 3), 1.0f, 3);
+    REQUIRE(light >= 0);
+    CHECK(raycaster->get_light_level(Vector2i(3, 3)) == doctest::Approx(ambient + 1.0f));
+    CHECK(raycaster->get_light_level(Vector2i(2, 3)) == doctest::Approx(ambient + 0.75f));
+    CHECK(raycaster->get_light_level(Vector2i(4, 2)) == doctest::Approx(ambient + 0.5f));
+    CHECK(raycaster->get_light_level(Vector2i(3, 6)) == doctest::Approx(ambient + 0.25f));
+    CHECK(raycaster->get_light_level(Vector2i(1, 1)) == doctest::Approx(ambient));
+    
+    SUBCASE("Walls stop the flood fill") {
+        CHECK_MESSAGE(raycaster->get_light_level(Vector2i(4, 3)) == doctest::Approx(ambient), "Wall cells take no light.");
+        CHECK_MESSAGE(raycaster->get_light_level(Vector2i(5, 3)) == doctest::Approx(ambient), "The way around the pillar is longer than the radius.");
+        CHECK(raycaster->get_light_level(Vector2i(0, 3)) == doctest::Approx(ambient));
+    }
+    
+    SUBCASE("Editing cells re-bakes the lights that reach them") {
+        raycaster->set_map_cell(Vector2i(4, 3), 0);
+        CHECK(raycaster->get_light_level(Vector2i(4, 3)) == doctest::Approx(ambient + 0.75f));
+        CHECK(raycaster->get_light_level(Vector2i(5, 3)) == doctest::Approx(ambient + 0.5f));
+        
+        raycaster->set_map_cell(Vector2i(3, 4), 1);
+        CHECK(raycaster->get_light_level(Vector2i(3, 4)) == doctest::Approx(ambient));
+        CHECK_MESSAGE(raycaster->get_light_level(Vector2i(3, 5)) == doctest::Approx(ambient), "The way around the new wall is longer than the radius.");
+        CHECK(raycaster->get_light_level(Vector2i(2, 5)) == doctest::Approx(ambient + 0.25f));
+        
+        DoomRaycaster *full = make_raycaster();
+        full->set_map_cell(Vector2i(4, 3), 0);
+        full->set_map_cell(Vector2i(3, 4), 1);
+        full->add_light(Vector2i(3, 3), 1.0f, 3);
+        check_light_levels_match(raycaster, full);
+        memdelete(full);
+    }
+    
+    SUBCASE("Moving and removing lights") {
+        raycaster->set_light(light, Vector2i(2, 2), 2.0f, 2);
+        CHECK(raycaster->get_light_level(Vector2i(2, 2)) == doctest::Approx(ambient + 2.0f));
+        CHECK(raycaster->get_light_level(Vector2i(3, 3)) == doctest::Approx(ambient + 2.0f / 3.0f));
+        CHECK_MESSAGE(raycaster->get_light_level(Vector2i(3, 6)) == doctest::Approx(ambient), "The old footprint should go dark.");
+        
+        DoomRaycaster *full = make_raycaster();
+        full->add_light(Vector2i(2, 2), 2.0f, 2);
+        check_light_levels_match(raycaster, full);
+        memdelete(full);
+        
+        raycaster->remove_light(light);
+        CHECK(raycaster->get_light_level(Vector2i(2, 2)) == doctest::Approx(ambient));
+    }
+    
+    SUBCASE("Negative intensities are rejected") {
+        ERR_PRINT_OFF;
+        CHECK(raycaster->add_light(Vector2i(2, 2), -1.0f, 3) == -1);
+        raycaster->set_light(light, Vector2i(3, 3), -0.5f, 3);
+        ERR_PRINT_ON;
+        CHECK(raycaster->get_light_level(Vector2i(3, 3)) == doctest::Approx(ambient + 1.0f));
+    }
+    
+    memdelete(raycaster);
+}
+
+// Columns where more than two pixels differ by more than the tolerance. Rounding the wall
+// height can move each end of a wall slice by a pixel, anything beyond that is a different hit.
+static int count_mismatched_columns(const Ref<Image> &p_a, const Ref<Image> &p_b, int p_tolerance){
+    const int width = p_a->get_width();
+    const int height = p_a->get_height();
+    const uint8_t *a = p_a->ptr();
+    const uint8_t *b = p_b->ptr();
+    int mismatched = 0;
+    for (int x = 0; x < width; x++) {
+        int pixels = 0;
+        for (int y = 0; y < height; y++) {
+            int offset = (y * width + x) * 4;
+            for (int c = 0; c < 4; c++) {
+                if (Math::abs(a[offset + c] - b[offset + c]) > p_tolerance) {
+                    pixels++;
+                    break;
+                }
+            }
+        }
+        if (pixels > 2) {
+            mismatched++;
+        }
+    }
+    return mismatched;
+}
+
+TEST_CASE("[DoomRaycaster] Wall segments match the per-column DDA") {
+    DoomRaycaster *raycaster = make_raycaster();
+    REQUIRE(raycaster->get_wall_segment_count() > 0);
+    
+    // x, y, angle: open room, against walls, into corners and inside the 0.1 near-plane clamp
+    static const Vector3 POSES[] = {
+        Vector3(1.5f, 1.5f, 0.6f),
+        Vector3(1.2f, 3.5f, Math_PI),
+        Vector3(1.2f, 1.2f, -Math_PI * 0.75f),
+        Vector3(3.8f, 3.5f, 0.0f),
+        Vector3(6.5f, 6.5f, -2.4f),
+        Vector3(3.8f, 2.8f, Math_PI * 0.25f),
+        Vector3(3.95f, 3.5f, 0.3f),
+        Vector3(3.99f, 2.99f, 0.785f),
+        Vector3(2.5f, 6.8f, -Math_PI * 0.5f),
+    };
+    for (const Vector3 &pose : POSES) {
+        raycaster->set_player_position(Vector2(pose.x, pose.y));
+        raycaster->set_player_angle(pose.z);
+        
+        raycaster->set_wall_mode(DoomRaycaster::WALL_MODE_DDA);
+        Ref<Image> dda = raycaster->render_with_backend(DoomRaycaster::RENDER_BACKEND_SCALAR);
+        raycaster->set_wall_mode(DoomRaycaster::WALL_MODE_SEGMENTS);
+        Ref<Image> segments = raycaster->render_with_backend(DoomRaycaster::RENDER_BACKEND_SCALAR);
+        REQUIRE(dda.is_valid());
+        REQUIRE(segments.is_valid());
+        
+        // Columns that graze a corner can land on either face
+        CHECK_MESSAGE(count_mismatched_columns(dda, segments, 2) <= 4, vformat("Pose (%f, %f, %f) should render the same walls in both modes.", pose.x, pose.y, pose.z));
+    }
+    
+    memdelete(raycaster);
+}
+
+TEST_CASE("[DoomRaycaster] Cached wall hits match fresh traces after turning") {
+    DoomRaycaster *warm = make_raycaster();
+    warm->set_wall_texture(make_texture(64, 64, 1));
+    REQUIRE(warm->render_with_backend(DoomRaycaster::RENDER_BACKEND_SCALAR).is_valid());
+    
+    // Turning in place reuses the hits of earlier frames: within one bin, half the view, none of it
+    for (float angle : { 0.60001f, 0.9f, 1.3f, -0.3f, 0.6f }) {
+        warm->set_player_angle(angle);
+        Ref<Image> cached = warm->render_with_backend(DoomRaycaster::RENDER_BACKEND_SCALAR);
+        
+        DoomRaycaster *cold = make_raycaster();
+        cold->set_wall_texture(make_texture(64, 64, 1));
+        cold->set_player_angle(angle);
+        Ref<Image> fresh = cold->render_with_backend(DoomRaycaster::RENDER_BACKEND_SCALAR);
+        memdelete(cold);
+        
+        REQUIRE(cached.is_valid());
+        REQUIRE(fresh.is_valid());
+        CHECK_MESSAGE(cached->get_data() == fresh->get_data(), vformat("Turning to %f should draw the same frame as a cold cache.", angle));
+    }
+    
+    memdelete(warm);
+}
+
+TEST_CASE("[DoomRaycaster] Moving circles slides along walls") {
+    DoomRaycaster *raycaster = make_raycaster();
+    const float radius = 0.25f;
+
+    SUBCASE("Open space") {
+        Vector2 pos = raycaster->move_circle(Vector2(2.5f, 2.5f), Vector2(0.5f, 0.25f), radius);
+        CHECK(pos.is_equal_approx(Vector2(3.0f, 2.75f)));
+    }
+
+    SUBCASE("Stops at the wall it runs into") {
+        Vector2 pos = raycaster->move_circle(Vector2(1.5f, 1.5f), Vector2(-2.0f, 0.0f), radius);
+        CHECK(pos.x == doctest::Approx(1.0f + radius));
+        CHECK(pos.y == doctest::Approx(1.5f));
+    }
+
+    SUBCASE("Keeps the motion along the wall") {
+        Vector2 pos = raycaster->move_circle(Vector2(1.5f, 1.5f), Vector2(-1.0f, 1.0f), radius);
+        CHECK(pos.x == doctest::Approx(1.0f + radius));
+        CHECK(pos.y == doctest::Approx(2.5f));
+    }
+
+    SUBCASE("Fast motion doesn't tunnel through a pillar") {
+        Vector2 pos = raycaster->move_circle(Vector2(1.5f, 3.5f), Vector2(10.0f, 0.0f), radius);
+        CHECK(pos.x == doctest::Approx(4.0f - radius));
+        CHECK(pos.y == doctest::Approx(3.5f));
+    }
+
+    SUBCASE("Keys can be walked through") {
+        Vector2 pos = raycaster->move_circle(Vector2(4.5f, 5.5f), Vector2(1.0f, 0.0f), radius);
+        CHECK(pos.is_equal_approx(Vector2(5.5f, 5.5f)));
+    }
+
+    SUBCASE("Batches move every circle on its own") {
+        PackedVector2Array positions = { Vector2(1.5f, 1.5f), Vector2(1.5f, 3.5f), Vector2(2.5f, 2.5f) };
+        PackedVector2Array motions = { Vector2(-1.0f, 1.0f), Vector2(10.0f, 0.0f), Vector2(0.5f, 0.25f) };
+        PackedVector2Array moved = raycaster->move_circles(positions, motions, radius);
+        REQUIRE(moved.size() == positions.size());
+        for (int i = 0; i < positions.size(); i++) {
+            CHECK(moved[i] == raycaster->move_circle(positions[i], motions[i], radius));
+        }
+    }
+
+    memdelete(raycaster);
+}
+
+TEST_CASE("[DoomRaycaster] Casting rays") {
+    DoomRaycaster *raycaster = make_raycaster();
+
+    PackedVector2Array origins = {
+        Vector2(1.5f, 1.5f), // East to the border
+        Vector2(1.5f, 1.5f), // South to the border
+        Vector2(1.5f, 3.5f), // East to the pillar
+        Vector2(1.5f, 1.5f), // Unnormalized direction
+        Vector2(1.5f, 1.5f), // No direction
+        Vector2(-1.0f, 1.5f), // Outside the map
+        Vector2(NAN, 1.5f),
+    };
+    PackedVector2Array directions = {
+        Vector2(1.0f, 0.0f),
+        Vector2(0.0f, 1.0f),
+        Vector2(1.0f, 0.0f),
+        Vector2(3.0f, 0.0f),
+        Vector2(),
+        Vector2(1.0f, 0.0f),
+        Vector2(1.0f, 0.0f),
+    };
+
+    Dictionary result = raycaster->cast_rays(origins, directions, 20.0f);
+    PackedFloat32Array distances = result["distances"];
+    PackedInt32Array cells = result["cells"];
+    PackedInt32Array sides = result["sides"];
+    REQUIRE(distances.size() == origins.size());
+
+    CHECK(distances[0] == doctest::Approx(5.5f));
+    CHECK(cells[0] == 1 * 8 + 7);
+    CHECK(sides[0] == 0);
+    CHECK(distances[1] == doctest::Approx(5.5f));
+    CHECK(cells[1] == 7 * 8 + 1);
+    CHECK(sides[1] == 1);
+    CHECK(distances[2] == doctest::Approx(2.5f));
+    CHECK(cells[2] == 3 * 8 + 4);
+    CHECK(distances[3] == doctest::Approx(5.5f));
+    CHECK_MESSAGE(cells[4] == -1, "A ray without a direction should miss.");
+    CHECK(distances[4] == doctest::Approx(20.0f));
+    for (int i = 5; i < 7; i++) {
+        CHECK_MESSAGE(cells[i] == -1, "Rays starting outside the map should be rejected.");
+        CHECK(sides[i] == -1);
+        CHECK(distances[i] == 0.0f);
+    }
+
+    SUBCASE("Walls past the maximum distance are misses") {
+        Dictionary short_result = raycaster->cast_rays(PackedVector2Array({ Vector2(1.5f, 1.5f) }), PackedVector2Array({ Vector2(1.0f, 0.0f) }), 2.0f);
+        CHECK(PackedFloat32Array(short_result["distances"])[0] == doctest::Approx(2.0f));
+        CHECK(PackedInt32Array(short_result["cells"])[0] == -1);
+    }
+
+    SUBCASE("Unbounded distances still stop at the map") {
+        Dictionary far_result = raycaster->cast_rays(PackedVector2Array({ Vector2(1.5f, 1.5f) }), PackedVector2Array({ Vector2(1.0f, 0.0f) }), INFINITY);
+        CHECK(PackedFloat32Array(far_result["distances"])[0] == doctest::Approx(5.5f));
+    }
+
+    SUBCASE("Batches split across threads") {
+        PackedVector2Array many_origins;
+        PackedVector2Array many_directions;
+        for (int i = 0; i < 1000; i++) {
+            many_origins.push_back(origins[i % 4]);
+            many_directions.push_back(directions[i % 4]);
+        }
+        Dictionary many_result = raycaster->cast_rays(many_origins, many_directions, 20.0f);
+        PackedFloat32Array many_distances = many_result["distances"];
+        PackedInt32Array many_cells = many_result["cells"];
+        REQUIRE(many_distances.size() == 1000);
+        bool matches = true;
+        for (int i = 0; i < 1000; i++) {
+            matches = matches && many_distances[i] == distances[i % 4] && many_cells[i] == cells[i % 4];
+        }
+        CHECK_MESSAGE(matches, "Every ray of a large batch should match the same ray cast alone.");
+    }
+
+    memdelete(raycaster);
+}
+
+// 10x10 maze: rooms joined by one cell wide corridors
+static DoomRaycaster *make_maze_raycaster(){
+    static const char *MAZE[10] = {
+        "1111111111",
+        "1000100001",
+        "1010101101",
+        "1010001001",
+        "1011111011",
+        "1000001001",
+        "1110101101",
+        "1000100001",
+        "1010001011",
+        "1111111111",
+    };
+    Array map;
+    for (int y = 0; y < 10; y++) {
+        for (int x = 0; x < 10; x++) {
+            map.push_back(MAZE[y][x] - '0');
+        }
+    }
+    
+    DoomRaycaster *raycaster = memnew(DoomRaycaster);
+    raycaster->set_map(map, 10, 10);
+    return raycaster;
+}
+
+TEST_CASE("[DoomRaycaster] PVS keeps every cell a ray can reach") {
+    DoomRaycaster *raycaster = make_maze_raycaster();
+    raycaster->set_pvs_enabled(true);
+    raycaster->build_pvs();
+    
+    // Brute force: rays between points inside every pair of open cells, away from the builder's
+    // border samples. If one of them arrives unblocked the pair has to stay visible.
+    static const Vector2 OFFSETS[3] = { Vector2(0.2f, 0.3f), Vector2(0.5f, 0.5f), Vector2(0.8f, 0.7f) };
+    PackedInt32Array open_cells;
+    for (int i = 0; i < 100; i++) {
+        // Rows of wall cells are left empty
+        if (raycaster->get_visible_cells(Vector2i(i % 10, i / 10)).size() > 0) {
+            open_cells.push_back(i);
+        }
+    }
+    PackedVector2Array origins;
+    PackedVector2Array directions;
+    PackedFloat32Array lengths;
+    PackedInt32Array pairs;
+    for (int from : open_cells) {
+        for (int to : open_cells) {
+            for (const Vector2 &a : OFFSETS) {
+                for (const Vector2 &b : OFFSETS) {
+                    Vector2 origin = Vector2(from % 10, from / 10) + a;
+                    Vector2 delta = Vector2(to % 10, to / 10) + b - origin;
+                    if (delta.is_zero_approx()) {
+                        continue;
+                    }
+                    origins.push_back(origin);
+                    directions.push_back(delta);
+                    lengths.push_back(delta.length());
+                    pairs.push_back(from * 100 + to);
+                }
+            }
+        }
+    }
+    
+    Dictionary result = raycaster->cast_rays(origins, directions, 20.0f);
+    PackedFloat32Array distances = result["distances"];
+    REQUIRE(distances.size() == origins.size());
+    int missed = 0;
+    for (int i = 0; i < distances.size(); i++) {
+        int from = pairs[i] / 100;
+        int to = pairs[i] % 100;
+        if (distances[i] >= lengths[i] && !raycaster->is_cell_visible(Vector2i(from % 10, from / 10), Vector2i(to % 10, to / 10))) {
+            missed++;
+        }
+    }
+    CHECK_MESSAGE(missed == 0, "Cells a ray reaches unblocked should never be culled.");
+    
+    int culled = 0;
+    for (int from : open_cells) {
+        culled += open_cells.size() - raycaster->get_visible_cells(Vector2i(from % 10, from / 10)).size();
+    }
+    CHECK_MESSAGE(culled > 0, "Cells hidden behind walls should be culled.");
+    CHECK_FALSE(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(8, 1)));
+    CHECK(raycaster->is_cell_visible(Vector2i(5, 1), Vector2i(5, 3)));
+    
+    memdelete(raycaster);
+}
+
+TEST_CASE("[DoomRaycaster] PVS is rebuilt after map edits") {
+    DoomRaycaster *raycaster = make_maze_raycaster();
+    raycaster->set_pvs_enabled(true);
+    raycaster->build_pvs();
+    REQUIRE_FALSE(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(8, 1)));
+    REQUIRE_FALSE(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(1, 7)));
+    
+    SUBCASE("Opening a wall") {
+        raycaster->set_map_cell(Vector2i(4, 1), 0);
+        CHECK_MESSAGE(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(1, 7)), "Everything should stay visible until the rebuild is installed.");
+        
+        raycaster->build_pvs();
+        CHECK(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(8, 1)));
+        CHECK_FALSE(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(1, 7)));
+    }
+    
+    SUBCASE("Edits while a rebuild is running") {
+        raycaster->set_map_cell(Vector2i(4, 1), 0);
+        raycaster->set_map_cell(Vector2i(5, 4), 0);
+        raycaster->build_pvs();
+        CHECK(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(8, 1)));
+        CHECK(raycaster->is_cell_visible(Vector2i(5, 3), Vector2i(5, 5)));
+        CHECK_FALSE(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(1, 7)));
+    }
+    
+    SUBCASE("Cells past the render distance") {
+        raycaster->set_map_cell(Vector2i(4, 1), 0);
+        raycaster->set_render_distance(3.0f);
+        raycaster->build_pvs();
+        CHECK(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(5, 1)));
+        CHECK_FALSE(raycaster->is_cell_visible(Vector2i(1, 1), Vector2i(8, 1)));
+    }
+    
+    memdelete(raycaster);
+}
+
+static void run_physics_ticks(int p_count){
+    for (int i = 0; i < p_count; i++) {
+        SceneTree::get_singleton()->physics_process(1.0 / Engine::get_singleton()->get_physics_ticks_per_second());
+    }
+}
+
+TEST_CASE("[SceneTree][DoomRaycaster] Recorded input replays without desyncs") {
+    DoomRaycaster *raycaster = make_raycaster();
+    raycaster->set_screen_size(64, 48);
+    raycaster->set_map_cell(Vector2i(3, 2), 2); // A key on the way
+    REQUIRE(raycaster->add_entity(Vector2(2.5f, 2.2f), 0.25f, -1, DoomRaycaster::ENTITY_FLAG_PICKUP) == 0);
+    SceneTree::get_singleton()->get_root()->add_child(raycaster);
+    SIGNAL_WATCH(raycaster, "key_collected");
+    SIGNAL_WATCH(raycaster, "entity_picked_up");
+    
+    Array key_args;
+    key_args.push_back(Array());
+    Array pickup_entity;
+    pickup_entity.push_back(0);
+    Array pickup_args;
+    pickup_args.push_back(pickup_entity);
+    
+    // Walk over the key and the pickup, then turn into the pillar and slide along it
+    const String path = TestUtils::get_temp_path("doom_raycaster_replay.rcrp");
+    REQUIRE(raycaster->start_recording(path) == OK);
+    SEND_GUI_KEY_EVENT(Key::W);
+    run_physics_ticks(45);
+    SEND_GUI_KEY_EVENT(Key::D);
+    run_physics_ticks(20);
+    SEND_GUI_KEY_UP_EVENT(Key::W);
+    SEND_GUI_KEY_UP_EVENT(Key::D);
+    SEND_GUI_KEY_EVENT(Key::Q);
+    run_physics_ticks(10);
+    SEND_GUI_KEY_UP_EVENT(Key::Q);
+    raycaster->stop_recording();
+    
+    const Vector2 end_pos = raycaster->get_player_position();
+    const float end_angle = raycaster->get_player_angle();
+    REQUIRE_FALSE(raycaster->has_entity(0));
+    SIGNAL_CHECK("key_collected", key_args);
+    SIGNAL_CHECK("entity_picked_up", pickup_args);
+    
+    // Put the pickup back under its old id, so the entities are the ones the recording started with
+    REQUIRE(raycaster->add_entity(Vector2(2.5f, 2.2f), 0.25f, -1, DoomRaycaster::ENTITY_FLAG_PICKUP) == 0);
+    
+    SUBCASE("Benchmark") {
+        Dictionary result = raycaster->run_replay_benchmark(path, false);
+        CHECK(int(result["ticks"]) == 75);
+        CHECK(int(result["desyncs"]) == 0);
+        SIGNAL_CHECK_FALSE("key_collected");
+        SIGNAL_CHECK_FALSE("entity_picked_up");
+        CHECK_MESSAGE(raycaster->has_entity(0), "The benchmark should put back what its ticks picked up.");
+        CHECK(raycaster->get_player_position() == end_pos);
+    }
+    
+    SUBCASE("Live replay") {
+        REQUIRE(raycaster->start_replay(path) == OK);
+        run_physics_ticks(75);
+        CHECK(raycaster->get_replay_desync_count() == 0);
+        CHECK(raycaster->get_player_position() == end_pos);
+        CHECK(raycaster->get_player_angle() == end_angle);
+        SIGNAL_CHECK("key_collected", key_args);
+        SIGNAL_CHECK("entity_picked_up", pickup_args);
+    }
+    
+    SUBCASE("Another map") {
+        raycaster->set_map_cell(Vector2i(6, 6), 1);
+        ERR_PRINT_OFF;
+        CHECK(raycaster->start_replay(path) == ERR_INVALID_DATA);
+        ERR_PRINT_ON;
+        CHECK_FALSE(raycaster->is_replaying());
+    }
+    
+    SIGNAL_UNWATCH(raycaster, "key_collected");
+    SIGNAL_UNWATCH(raycaster, "entity_picked_up");
+    memdelete(raycaster);
+}
+
+// Every entity that overlaps the circle, by looking at all of them
+static PackedInt32Array query_entities_brute_force(DoomRaycaster *p_raycaster, const LocalVector<float> &p_radii, Vector2 p_center, float p_radius, int p_flags){
+    PackedInt32Array ids;
+    for (uint32_t id = 0; id < p_radii.size(); id++) {
+        if (!p_raycaster->has_entity(id) || (p_raycaster->get_entity_flags(id) & p_flags) != p_flags) {
+            continue;
+        }
+        float overlap = p_radius + p_radii[id];
+        if (p_raycaster->get_entity_position(id).distance_squared_to(p_center) <= overlap * overlap) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+static void check_entity_queries(DoomRaycaster *p_raycaster, const LocalVector<float> &p_radii, uint32_t p_seed){
+    RandomPCG rng(p_seed);
+    for (int i = 0; i < 200; i++) {
+        Vector2 center(rng.random(-2.0f, 18.0f), rng.random(-2.0f, 18.0f));
+        float radius = rng.random(0.0f, 3.0f);
+        int flags = rng.rand(3);
+        
+        PackedInt32Array found = p_raycaster->query_entities(center, radius, flags);
+        PackedInt32Array expected = query_entities_brute_force(p_raycaster, p_radii, center, radius, flags);
+        found.sort();
+        CHECK_MESSAGE(found == expected, vformat("Query at %s with radius %f should find every overlapping entity.", center, radius));
+        
+        // Ties may resolve to either entity, so compare the distance
+        float max_distance = rng.random(0.5f, 12.0f);
+        float best_dist_sq = max_distance * max_distance;
+        int best = -1;
+        for (uint32_t id = 0; id < p_radii.size(); id++) {
+            if (!p_raycaster->has_entity(id) || (p_raycaster->get_entity_flags(id) & flags) != flags) {
+                continue;
+            }
+            float dist_sq = p_raycaster->get_entity_position(id).distance_squared_to(center);
+            if (dist_sq <= best_dist_sq) {
+                best = id;
+                best_dist_sq = dist_sq;
+            }
+        }
+        int nearest = p_raycaster->find_nearest_entity(center, max_distance, flags);
+        if (best < 0) {
+            CHECK(nearest == -1);
+        } else {
+            REQUIRE_MESSAGE(nearest >= 0, vformat("Nearest entity to %s within %f should be found.", center, max_distance));
+            CHECK(p_raycaster->get_entity_position(nearest).distance_squared_to(center) == best_dist_sq);
+        }
+    }
+}
+
+TEST_CASE("[DoomRaycaster] Entity queries match a brute-force search") {
+    // 16x16 map; the grid buckets only depend on its size
+    Array map;
+    for (int i = 0; i < 16 * 16; i++) {
+        map.push_back(0);
+    }
+    DoomRaycaster *raycaster = memnew(DoomRaycaster);
+    raycaster->set_map(map, 16, 16);
+    
+    // Some of them outside the map, where they fall into the edge buckets
+    RandomPCG rng(7);
+    LocalVector<float> radii;
+    for (int i = 0; i < 150; i++) {
+        float radius = rng.random(0.0f, 0.6f);
+        int id = raycaster->add_entity(Vector2(rng.random(-1.0f, 17.0f), rng.random(-1.0f, 17.0f)), radius, -1, rng.rand(3));
+        REQUIRE(id == i);
+        radii.push_back(radius);
+    }
+    
+    SUBCASE("Circles that reach into the next bucket") {
+        int id = raycaster->add_entity(Vector2(5.9f, 5.5f), 0.3f, -1, 0);
+        radii.push_back(0.3f);
+        CHECK(raycaster->query_entities(Vector2(6.15f, 5.5f), 0.0f).has(id));
+        CHECK(raycaster->query_entities(Vector2(7.05f, 5.5f), 0.9f).has(id));
+        CHECK_FALSE(raycaster->query_entities(Vector2(7.05f, 5.5f), 0.8f).has(id));
+        check_entity_queries(raycaster, radii, 1);
+    }
+    
+    SUBCASE("An entity larger than the query reach") {
+        int id = raycaster->add_entity(Vector2(3.5f, 12.5f), 5.0f, -1, DoomRaycaster::ENTITY_FLAG_SOLID);
+        radii.push_back(5.0f);
+        CHECK(raycaster->query_entities(Vector2(8.4f, 12.5f), 0.05f, DoomRaycaster::ENTITY_FLAG_SOLID).has(id));
+        CHECK(raycaster->query_entities(Vector2(3.5f, 17.0f), 0.1f).has(id));
+        check_entity_queries(raycaster, radii, 2);
+    }
+    
+    SUBCASE("Removed entities and reused ids") {
+        for (int id = 0; id < 150; id += 3) {
+            raycaster->remove_entity(id);
+        }
+        CHECK(raycaster->get_entity_count() == 100);
+        check_entity_queries(raycaster, radii, 3);
+        
+        // Freed ids are handed out again, the last one first
+        int id = raycaster->add_entity(Vector2(8.5f, 8.5f), 0.5f, -1, 0);
+        CHECK(id == 147);
+        radii[id] = 0.5f;
+        CHECK(raycaster->query_entities(Vector2(8.5f, 8.5f), 0.0f).has(id));
+        CHECK(raycaster->find_nearest_entity(Vector2(8.5f, 8.5f), 0.1f) == id);
+        check_entity_queries(raycaster, radii, 4);
+        
+        ERR_PRINT_OFF;
+        raycaster->remove_entity(0);
+        ERR_PRINT_ON;
+        CHECK(raycaster->get_entity_count() == 101);
+    }
+    
+    memdelete(raycaster);
+}
+
+TEST_CASE("[SceneTree][DoomRaycaster] Touching entities") {
+    DoomRaycaster *raycaster = make_raycaster();
+    raycaster->set_screen_size(64, 48);
+    raycaster->set_player_position(Vector2(2.0f, 1.5f));
+    
+    // Two pickups in different buckets under the player, one out of reach and a solid NPC
+    const int near_left = raycaster->add_entity(Vector2(1.9f, 1.5f), 0.1f, -1, DoomRaycaster::ENTITY_FLAG_PICKUP);
+    const int near_right = raycaster->add_entity(Vector2(2.1f, 1.5f), 0.1f, -1, DoomRaycaster::ENTITY_FLAG_PICKUP);
+    const int far = raycaster->add_entity(Vector2(5.5f, 4.5f), 0.1f, -1, DoomRaycaster::ENTITY_FLAG_PICKUP);
+    const int solid = raycaster->add_entity(Vector2(2.0f, 1.8f), 0.15f, -1, DoomRaycaster::ENTITY_FLAG_SOLID);
+    
+    SceneTree::get_singleton()->get_root()->add_child(raycaster);
+    SIGNAL_WATCH(raycaster, "entity_picked_up");
+    run_physics_ticks(1);
+    
+    Array left_args;
+    left_args.push_back(near_left);
+    Array right_args;
+    right_args.push_back(near_right);
+    Array pickup_args;
+    pickup_args.push_back(left_args);
+    pickup_args.push_back(right_args);
+    SIGNAL_CHECK("entity_picked_up", pickup_args);
+    
+    CHECK_FALSE(raycaster->has_entity(near_left));
+    CHECK_FALSE(raycaster->has_entity(near_right));
+    CHECK(raycaster->has_entity(far));
+    CHECK(raycaster->has_entity(solid));
+    CHECK(raycaster->get_entity_count() == 2);
+    CHECK(raycaster->query_entities(Vector2(2.0f, 1.5f), 0.2f, DoomRaycaster::ENTITY_FLAG_PICKUP).is_empty());
+    CHECK_MESSAGE(raycaster->get_player_position().y == doctest::Approx(1.45f), "The solid entity should push the player out.");
+    
+    // Nothing left to pick up on the next tick
+    run_physics_ticks(1);
+    SIGNAL_CHECK_FALSE("entity_picked_up");
+    
+    // The picked up ids are reused, the last one removed first
+    CHECK(raycaster->add_entity(Vector2(6.5f, 6.5f), 0.1f) == near_right);
+    CHECK(raycaster->add_entity(Vector2(6.5f, 5.5f), 0.1f) == near_left);
+    CHECK(raycaster->add_entity(Vector2(6.5f, 4.5f), 0.1f) == 4);
+    
+    SIGNAL_UNWATCH(raycaster, "entity_picked_up");
+    memdelete(raycaster);
+}
+
+static void check_view_matches_main(DoomRaycaster *p_raycaster, int p_view){
+    Ref<Image> main = p_raycaster->render_with_backend(DoomRaycaster::RENDER_BACKEND_SCALAR);
+    Ref<Image> view = p_raycaster->get_view_image(p_view);
+    REQUIRE(main.is_valid());
+    REQUIRE(view.is_valid());
+    REQUIRE(view->get_size() == main->get_size());
+    CHECK_MESSAGE(view->get_data() == main->get_data(), "A view with the main camera's pose, size and fov should render the same pixels.");
+}
+
+TEST_CASE("[SceneTree][DoomRaycaster] Extra views") {
+    DoomRaycaster *raycaster = make_raycaster();
+    raycaster->set_render_backend(DoomRaycaster::RENDER_BACKEND_SCALAR);
+    raycaster->set_wall_texture(make_texture(64, 64, 1));
+    raycaster->set_floor_texture(make_texture(32, 32, 2));
+    raycaster->set_ceiling_texture(make_texture(128, 32, 3));
+    raycaster->add_entity(Vector2(4.5f, 4.5f), 0.3f, raycaster->add_sprite(make_texture(16, 16, 4)));
+    
+    const int view = raycaster->add_view(raycaster->get_player_position(), raycaster->get_player_angle(), 60.0f, Vector2i(1152, 648));
+    const int monitor = raycaster->add_view(Vector2(6.5f, 6.5f), 3.5f, 90.0f, Vector2i(64, 48));
+    REQUIRE(view == 0);
+    REQUIRE(monitor == 1);
+    SceneTree::get_singleton()->get_root()->add_child(raycaster);
+    SceneTree::get_singleton()->process(0.016);
+    check_view_matches_main(raycaster, view);
+    
+    SUBCASE("After moving and turning") {
+        raycaster->set_player_position(Vector2(3.2f, 4.7f));
+        raycaster->set_player_angle(-2.0f);
+        raycaster->set_view_pose(view, Vector2(3.2f, 4.7f), -2.0f);
+        SceneTree::get_singleton()->process(0.016);
+        check_view_matches_main(raycaster, view);
+    }
+    
+    SUBCASE("Removing a view while a frame renders") {
+        raycaster->set_threaded_render(true);
+        SceneTree::get_singleton()->process(0.016); // Leaves a frame rendering on a worker
+        raycaster->remove_view(view);
+        CHECK(raycaster->get_view_count() == 1);
+        ERR_PRINT_OFF;
+        CHECK(raycaster->get_view_image(view).is_null());
+        raycaster->remove_view(view);
+        ERR_PRINT_ON;
+        
+        SceneTree::get_singleton()->process(0.016);
+        raycaster->remove_view(monitor);
+        SceneTree::get_singleton()->process(0.016);
+        CHECK(raycaster->get_view_count() == 0);
+        
+        // The freed slot is reused, and the view renders like the main one again
+        CHECK(raycaster->add_view(raycaster->get_player_position(), raycaster->get_player_angle(), 60.0f, Vector2i(1152, 648)) == view);
+        SceneTree::get_singleton()->process(0.016);
+        SceneTree::get_singleton()->process(0.016);
+        check_view_matches_main(raycaster, view);
+        raycaster->set_threaded_render(false);
+    }
+    
+    memdelete(raycaster);
+}
+
+// The goldens in tests/data/doom_raycaster/golden are make_raycaster() in flat colors at these poses.
+// After an intended change to the output, rewrite them with run_golden_test(..., p_update = true).
+static PackedVector3Array get_golden_poses(){
+    PackedVector3Array poses;
+    poses.push_back(Vector3(1.5f, 1.5f, 0.6f));
+    poses.push_back(Vector3(6.5f, 6.2f, -2.4f));
+    poses.push_back(Vector3(2.5f, 3.5f, 0.0f));
+    poses.push_back(Vector3(4.5f, 6.2f, -1.5708f));
+    return poses;
+}
+
+TEST_CASE("[SceneTree][DoomRaycaster] Golden images") {
+    DoomRaycaster *raycaster = make_raycaster();
+    raycaster->set_screen_size(1152, 648);
+    const PackedVector3Array poses = get_golden_poses();
+    
+    SUBCASE("Scripted poses match the stored frames") {
+        // Float rounding may move a wall edge by a pixel in a few columns
+        Dictionary result = raycaster->run_golden_test(poses, TestUtils::get_data_path("doom_raycaster/golden"), 2, 16);
+        CHECK(bool(result["passed"]));
+        Array frames = result["frames"];
+        REQUIRE(frames.size() == poses.size());
+        for (int i = 0; i < frames.size(); i++) {
+            Dictionary frame = frames[i];
+            CHECK_MESSAGE(bool(frame["passed"]), vformat("Frame %d should match its golden (%d mismatches).", i, int(frame.get("mismatches", -1))));
+        }
+    }
+    
+    SUBCASE("A changed scene fails") {
+        // Compared against a copy, since failures write a diff image next to the golden
+        const String dir = TestUtils::get_temp_path("doom_raycaster_golden");
+        REQUIRE(DirAccess::make_dir_recursive_absolute(dir) == OK);
+        DirAccess::remove_absolute(dir.path_join("frame_000_diff.png"));
+        REQUIRE(DirAccess::copy_absolute(TestUtils::get_data_path("doom_raycaster/golden/frame_000.png"), dir.path_join("frame_000.png")) == OK);
+        
+        PackedVector3Array first;
+        first.push_back(poses[0]);
+        raycaster->set_wall_color(Color(0.7, 0.6, 0.7));
+        Dictionary result = raycaster->run_golden_test(first, dir, 2, 16);
+        CHECK_FALSE(bool(result["passed"]));
+        Dictionary frame = ((Array)result["frames"])[0];
+        CHECK(int(frame["mismatches"]) > 1000);
+        CHECK(FileAccess::exists(dir.path_join("frame_000_diff.png")));
+    }
+    
+    memdelete(raycaster);
+}
+
+} // namespace TestDoomRaycaster
+
+#endif // TEST_DOOM_RAYCASTER_H
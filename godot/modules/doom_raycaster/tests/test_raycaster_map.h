@@ -0,0 +1,89 @@
+#ifndef TEST_RAYCASTER_MAP_H
+#define TEST_RAYCASTER_MAP_H
+
+#include "../doom_raycaster.h"
+#include "../raycaster_map.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestRaycasterMap {
+
+static Ref<RaycasterMap> make_map(int p_width, int p_height){
+    Ref<RaycasterMap> map;
+    map.instantiate();
+    map->set_size(p_width, p_height);
+    for (int y = 0; y < p_height; y++) {
+        for (int x = 0; x < p_width; x++) {
+            bool border = x == 0 || y == 0 || x == p_width - 1 || y == p_height - 1;
+            map->set_cell(Vector2i(x, y), border || (x % 4 == 2 && y % 3 == 1) ? 1 : 0);
+        }
+    }
+    map->set_cell(Vector2i(1, 1), 2);
+    map->set_cell(Vector2i(p_width - 2, p_height - 2), 255);
+    map->add_entity(3, Vector2(1.5f, 2.25f), -7);
+    map->add_entity(0, Vector2(p_width - 1.5f, 1.5f), DoomRaycaster::ENTITY_FLAG_SOLID | DoomRaycaster::ENTITY_FLAG_PICKUP);
+    return map;
+}
+
+static void check_maps_equal(const Ref<RaycasterMap> &p_a, const Ref<RaycasterMap> &p_b){
+    CHECK(p_a->get_width() == p_b->get_width());
+    CHECK(p_a->get_height() == p_b->get_height());
+    CHECK(p_a->get_cells() == p_b->get_cells());
+    REQUIRE(p_a->get_entity_count() == p_b->get_entity_count());
+    for (int i = 0; i < p_a->get_entity_count(); i++) {
+        CHECK(p_a->get_entity(i) == p_b->get_entity(i));
+    }
+}
+
+TEST_CASE("[RaycasterMap] Saving and loading") {
+    // Small maps are stored raw, large ones compress
+    for (Vector2i size : { Vector2i(5, 4), Vector2i(96, 64) }) {
+        Ref<RaycasterMap> map = make_map(size.x, size.y);
+        const String path = TestUtils::get_temp_path(vformat("raycaster_map_%dx%d.rcmap", size.x, size.y));
+        REQUIRE(map->save_file(path) == OK);
+
+        Ref<RaycasterMap> loaded;
+        loaded.instantiate();
+        REQUIRE(loaded->load_file(path) == OK);
+        check_maps_equal(map, loaded);
+
+        Ref<RaycasterMap> resource = ResourceLoader::load(path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+        REQUIRE(resource.is_valid());
+        check_maps_equal(map, resource);
+    }
+}
+
+TEST_CASE("[RaycasterMap] Rejecting other files") {
+    const String path = TestUtils::get_temp_path("raycaster_map_invalid.rcmap");
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+    REQUIRE(file.is_valid());
+    file->store_string("not a maze");
+    file.unref();
+
+    Ref<RaycasterMap> map = make_map(5, 4);
+    ERR_PRINT_OFF;
+    CHECK(map->load_file(path) == ERR_FILE_UNRECOGNIZED);
+    ERR_PRINT_ON;
+    CHECK_MESSAGE(map->get_width() == 5, "A failed load should leave the map unchanged.");
+}
+
+TEST_CASE("[RaycasterMap] Spawning the map's entities") {
+    Ref<RaycasterMap> map = make_map(8, 6);
+    DoomRaycaster *raycaster = memnew(DoomRaycaster);
+    raycaster->add_entity(Vector2(3.5f, 3.5f), 0.5f);
+
+    raycaster->set_map_resource(map);
+    REQUIRE(raycaster->get_entity_count() == map->get_entity_count());
+    for (int i = 0; i < map->get_entity_count(); i++) {
+        const RaycasterMap::Entity &entity = map->get_entity_data(i);
+        CHECK(raycaster->get_entity_position(i) == entity.position);
+        CHECK(raycaster->get_entity_flags(i) == entity.value);
+    }
+
+    memdelete(raycaster);
+}
+
+} // namespace TestRaycasterMap
+
+#endif // TEST_RAYCASTER_MAP_H
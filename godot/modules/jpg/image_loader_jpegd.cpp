@@ -30,11 +30,295 @@
 
 #include "image_loader_jpegd.h"
 
+#include "core/object/worker_thread_pool.h"
+
 #include <jpgd.h>
 #include <jpge.h>
 
 #include <string.h>
 
+// Images smaller than this are always decoded on the calling thread.
+#define JPG_PARALLEL_MIN_PIXELS (512 * 512)
+
+static void _jpgd_copy_scanline(uint8_t *p_dst, const uint8_t *p_scan_line, int p_width, int p_comps) {
+	if (p_comps == 1) {
+		memcpy(p_dst, p_scan_line, p_width);
+		return;
+	}
+	// For images with more than 1 channel p_scan_line will always point to a buffer
+	// containing 32-bit RGBA pixels. Alpha is always 255 and we ignore it.
+	for (int x = 0; x < p_width; x++) {
+		p_dst[0] = p_scan_line[0];
+		p_dst[1] = p_scan_line[1];
+		p_dst[2] = p_scan_line[2];
+		p_dst += 3;
+		p_scan_line += 4;
+	}
+}
+
+// Decodes rows [p_from_row, p_to_row) of the stream into p_dst, which holds p_dst_bpl bytes per row
+// starting at p_from_row. Rows above p_from_row are decoded and dropped.
+static Error _jpgd_decode_rows(const uint8_t *p_buffer, int p_buffer_len, int p_width, int p_height, int p_comps, int p_from_row, int p_to_row, uint8_t *p_dst, int p_dst_bpl) {
+	jpgd::jpeg_decoder_mem_stream mem_stream(p_buffer, p_buffer_len);
+	jpgd::jpeg_decoder decoder(&mem_stream);
+
+	if (decoder.get_error_code() != jpgd::JPGD_SUCCESS) {
+		return ERR_CANT_OPEN;
+	}
+	if (decoder.get_width() != p_width || decoder.get_height() != p_height || decoder.get_num_components() != p_comps) {
+		return ERR_FILE_CORRUPT;
+	}
+	if (decoder.begin_decoding() != jpgd::JPGD_SUCCESS) {
+		return ERR_FILE_CORRUPT;
+	}
+
+	for (int y = 0; y < p_to_row; y++) {
+		const jpgd::uint8 *pScan_line;
+		jpgd::uint scan_line_len;
+		if (decoder.decode((const void **)&pScan_line, &scan_line_len) != jpgd::JPGD_SUCCESS) {
+			return ERR_FILE_CORRUPT;
+		}
+		if (y >= p_from_row) {
+			_jpgd_copy_scanline(p_dst + (y - p_from_row) * p_dst_bpl, pScan_line, p_width, p_comps);
+		}
+	}
+
+	return OK;
+}
+
+// A baseline stream with restart markers split at MCU row boundaries. Each restart resets the DC
+// predictors, so every run of segments can be decoded on its own once it is given the stream's
+// headers, a matching frame height, restart markers renumbered from 0 and an EOI marker.
+struct JPGRestartStream {
+	// Segments and rows fed to the decoder, which reach one row boundary past the kept rows on
+	// each side when chroma is filtered across MCU rows.
+	struct Chunk {
+		int first_segment = 0;
+		int end_segment = 0;
+		int decode_row = 0;
+		int decode_height = 0;
+		int from_row = 0; // Rows written to the image.
+		int to_row = 0;
+	};
+
+	const uint8_t *buffer = nullptr;
+	int sof_offset = 0;
+	int sos_end = 0;
+	LocalVector<int> segment_start;
+	LocalVector<int> segment_end; // Offset of the marker closing each segment.
+
+	int width = 0;
+	int height = 0;
+	int comps = 0;
+	uint8_t *dst = nullptr;
+	int dst_bpl = 0;
+	LocalVector<Chunk> chunks;
+	SafeFlag failed;
+
+	bool parse(const uint8_t *p_buffer, int p_buffer_len, int p_width, int p_height, int p_comps);
+	Error decode_chunk(const Chunk &p_chunk) const;
+	static void decode_task(void *p_userdata, uint32_t p_index);
+};
+
+bool JPGRestartStream::parse(const uint8_t *p_buffer, int p_buffer_len, int p_width, int p_height, int p_comps) {
+	buffer = p_buffer;
+	width = p_width;
+	height = p_height;
+	comps = p_comps;
+
+	if (p_buffer_len < 4 || p_buffer[0] != 0xFF || p_buffer[1] != 0xD8) {
+		return false;
+	}
+
+	int restart_interval = 0;
+	int max_h_samp = 1;
+	int max_v_samp = 1;
+	int frame_comps = 0;
+	sof_offset = -1;
+	sos_end = -1;
+
+	int pos = 2;
+	while (sos_end < 0) {
+		if (pos + 4 > p_buffer_len || p_buffer[pos] != 0xFF) {
+			return false;
+		}
+		while (pos + 4 <= p_buffer_len && p_buffer[pos + 1] == 0xFF) {
+			pos++; // Fill bytes.
+		}
+		const uint8_t marker = p_buffer[pos + 1];
+		const int length = (p_buffer[pos + 2] << 8) | p_buffer[pos + 3];
+		if (length < 2 || pos + 2 + length > p_buffer_len) {
+			return false;
+		}
+		const uint8_t *segment = p_buffer + pos + 4;
+
+		if (marker == 0xC0 || marker == 0xC1) {
+			// Baseline and extended sequential Huffman frames.
+			if (length < 8) {
+				return false;
+			}
+			frame_comps = segment[5];
+			if (length < 8 + frame_comps * 3) {
+				return false;
+			}
+			for (int i = 0; i < frame_comps; i++) {
+				max_h_samp = MAX(max_h_samp, segment[6 + i * 3 + 1] >> 4);
+				max_v_samp = MAX(max_v_samp, segment[6 + i * 3 + 1] & 0xF);
+			}
+			sof_offset = pos;
+		} else if ((marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) || marker == 0xDC) {
+			// Progressive or arithmetic coded frames, or a DNL marker.
+			return false;
+		} else if (marker == 0xDD) {
+			if (length != 4) {
+				return false;
+			}
+			restart_interval = (segment[0] << 8) | segment[1];
+		} else if (marker == 0xDA) {
+			// Interleaved scans only, a stream with several scans needs all of them for every row.
+			if (sof_offset < 0 || segment[0] != frame_comps) {
+				return false;
+			}
+			sos_end = pos + 2 + length;
+		} else if (marker == 0xD8 || marker == 0xD9 || (marker >= 0xD0 && marker <= 0xD7) || marker == 0x01) {
+			return false;
+		}
+		pos += 2 + length;
+	}
+
+	if (restart_interval == 0 || frame_comps != p_comps) {
+		return false;
+	}
+
+	// A single component scan has one block per MCU regardless of its sampling factors.
+	const int mcu_width = p_comps == 1 ? 8 : max_h_samp * 8;
+	const int mcu_height = p_comps == 1 ? 8 : max_v_samp * 8;
+	const int mcus_per_row = (p_width + mcu_width - 1) / mcu_width;
+	const int mcu_rows = (p_height + mcu_height - 1) / mcu_height;
+	const int64_t total_mcus = (int64_t)mcus_per_row * mcu_rows;
+	const int64_t segment_count = (total_mcus + restart_interval - 1) / restart_interval;
+
+	// Walk the entropy coded data for the restart markers, every one must be where the frame puts it.
+	segment_start.clear();
+	segment_end.clear();
+	segment_start.push_back(sos_end);
+	pos = sos_end;
+	while (true) {
+		while (pos < p_buffer_len && p_buffer[pos] != 0xFF) {
+			pos++;
+		}
+		while (pos + 1 < p_buffer_len && p_buffer[pos + 1] == 0xFF) {
+			pos++;
+		}
+		if (pos + 1 >= p_buffer_len) {
+			return false;
+		}
+		const uint8_t marker = p_buffer[pos + 1];
+		if (marker == 0x00) {
+			pos += 2; // Stuffed zero byte.
+		} else if (marker >= 0xD0 && marker <= 0xD7) {
+			if (marker - 0xD0 != (int)((segment_end.size()) & 7) || (int64_t)segment_start.size() >= segment_count) {
+				return false;
+			}
+			segment_end.push_back(pos);
+			pos += 2;
+			segment_start.push_back(pos);
+		} else if (marker == 0xD9) {
+			segment_end.push_back(pos);
+			break;
+		} else {
+			return false;
+		}
+	}
+
+	if ((int64_t)segment_end.size() != segment_count || segment_count < 2) {
+		return false;
+	}
+
+	// Segments that start on an MCU row, plus the end of the stream.
+	LocalVector<int> boundary_segments;
+	LocalVector<int> boundary_rows;
+	for (int i = 0; i <= segment_count; i++) {
+		const int64_t mcu = (int64_t)i * restart_interval;
+		if (i == segment_count) {
+			boundary_segments.push_back(i);
+			boundary_rows.push_back(p_height);
+		} else if (mcu % mcus_per_row == 0) {
+			boundary_segments.push_back(i);
+			boundary_rows.push_back((int)(mcu / mcus_per_row) * mcu_height);
+		}
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	const int chunk_count = MIN(pool->get_thread_count(), (int)boundary_segments.size() - 1);
+	if (chunk_count < 2) {
+		return false;
+	}
+
+	// Filtered chroma upsampling reads the neighboring MCU rows when chroma is vertically subsampled,
+	// so those chunks also decode the rows around them for the seams to match a serial decode.
+	const bool overlap = p_comps == 3 && max_v_samp == 2;
+
+	LocalVector<int> picked; // Indices into the boundary list.
+	picked.push_back(0);
+	for (int i = 1; i < chunk_count; i++) {
+		const int target_row = (int)((int64_t)p_height * i / chunk_count);
+		uint32_t boundary = picked[picked.size() - 1] + 1;
+		while (boundary < boundary_rows.size() - 1 && boundary_rows[boundary] < target_row) {
+			boundary++;
+		}
+		if (boundary < boundary_rows.size() - 1) {
+			picked.push_back(boundary);
+		}
+	}
+	picked.push_back(boundary_rows.size() - 1);
+
+	chunks.clear();
+	for (uint32_t i = 0; i + 1 < picked.size(); i++) {
+		const int first = overlap ? MAX(picked[i] - 1, 0) : picked[i];
+		const int end = overlap ? MIN(picked[i + 1] + 1, (int)boundary_rows.size() - 1) : picked[i + 1];
+		Chunk chunk;
+		chunk.first_segment = boundary_segments[first];
+		chunk.end_segment = boundary_segments[end];
+		chunk.decode_row = boundary_rows[first];
+		chunk.decode_height = boundary_rows[end] - chunk.decode_row;
+		chunk.from_row = boundary_rows[picked[i]];
+		chunk.to_row = boundary_rows[picked[i + 1]];
+		chunks.push_back(chunk);
+	}
+	return chunks.size() >= 2;
+}
+
+Error JPGRestartStream::decode_chunk(const Chunk &p_chunk) const {
+	const int data_from = segment_start[p_chunk.first_segment];
+	const int data_to = segment_end[p_chunk.end_segment - 1];
+
+	Vector<uint8_t> stream;
+	stream.resize(sos_end + (data_to - data_from) + 2);
+	uint8_t *w = stream.ptrw();
+	memcpy(w, buffer, sos_end);
+	memcpy(w + sos_end, buffer + data_from, data_to - data_from);
+	w[sof_offset + 5] = p_chunk.decode_height >> 8;
+	w[sof_offset + 6] = p_chunk.decode_height & 0xFF;
+	for (int i = p_chunk.first_segment; i < p_chunk.end_segment - 1; i++) {
+		w[sos_end + segment_end[i] - data_from + 1] = 0xD0 + ((i - p_chunk.first_segment) & 7);
+	}
+	w[stream.size() - 2] = 0xFF;
+	w[stream.size() - 1] = 0xD9;
+
+	return _jpgd_decode_rows(w, stream.size(), width, p_chunk.decode_height, comps, p_chunk.from_row - p_chunk.decode_row, p_chunk.to_row - p_chunk.decode_row, dst + p_chunk.from_row * dst_bpl, dst_bpl);
+}
+
+void JPGRestartStream::decode_task(void *p_userdata, uint32_t p_index) {
+	JPGRestartStream *restart_stream = (JPGRestartStream *)p_userdata;
+	if (restart_stream->failed.is_set()) {
+		return;
+	}
+	if (restart_stream->decode_chunk(restart_stream->chunks[p_index]) != OK) {
+		restart_stream->failed.set();
+	}
+}
+
 Error jpeg_load_image_from_buffer(Image *p_image, const uint8_t *p_buffer, int p_buffer_len) {
 	jpgd::jpeg_decoder_mem_stream mem_stream(p_buffer, p_buffer_len);
 
@@ -51,10 +335,6 @@ Error jpeg_load_image_from_buffer(Image *p_image, const uint8_t *p_buffer, int p
 		return ERR_FILE_CORRUPT;
 	}
 
-	if (decoder.begin_decoding() != jpgd::JPGD_SUCCESS) {
-		return ERR_FILE_CORRUPT;
-	}
-
 	const int dst_bpl = image_width * comps;
 
 	Vector<uint8_t> data;
@@ -63,28 +343,34 @@ Error jpeg_load_image_from_buffer(Image *p_image, const uint8_t *p_buffer, int p
 
 	uint8_t *dw = data.ptrw();
 
-	jpgd::uint8 *pImage_data = (jpgd::uint8 *)dw;
+	// Streams with restart markers on MCU row boundaries are split into runs of rows decoded in parallel,
+	// each straight into its rows of the image data. Anything else, or a failed run, decodes serially.
+	bool decoded = false;
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if ((int64_t)image_width * image_height >= JPG_PARALLEL_MIN_PIXELS && pool && pool->get_thread_count() > 1 && pool->get_thread_index() == -1) {
+		JPGRestartStream restart_stream;
+		if (restart_stream.parse(p_buffer, p_buffer_len, image_width, image_height, comps)) {
+			restart_stream.dst = dw;
+			restart_stream.dst_bpl = dst_bpl;
+			WorkerThreadPool::GroupID group = pool->add_native_group_task(&JPGRestartStream::decode_task, &restart_stream, restart_stream.chunks.size(), -1, true, SNAME("JPGDecode"));
+			pool->wait_for_group_task_completion(group);
+			decoded = !restart_stream.failed.is_set();
+		}
+	}
 
-	for (int y = 0; y < image_height; y++) {
-		const jpgd::uint8 *pScan_line;
-		jpgd::uint scan_line_len;
-		if (decoder.decode((const void **)&pScan_line, &scan_line_len) != jpgd::JPGD_SUCCESS) {
+	if (!decoded) {
+		if (decoder.begin_decoding() != jpgd::JPGD_SUCCESS) {
 			return ERR_FILE_CORRUPT;
 		}
 
-		jpgd::uint8 *pDst = pImage_data + y * dst_bpl;
-
-		if (comps == 1) {
-			memcpy(pDst, pScan_line, dst_bpl);
-		} else {
-			// For images with more than 1 channel pScan_line will always point to a buffer
-			// containing 32-bit RGBA pixels. Alpha is always 255 and we ignore it.
-			for (int x = 0; x < image_width; x++) {
-				pDst[0] = pScan_line[x * 4 + 0];
-				pDst[1] = pScan_line[x * 4 + 1];
-				pDst[2] = pScan_line[x * 4 + 2];
-				pDst += 3;
+		for (int y = 0; y < image_height; y++) {
+			const jpgd::uint8 *pScan_line;
+			jpgd::uint scan_line_len;
+			if (decoder.decode((const void **)&pScan_line, &scan_line_len) != jpgd::JPGD_SUCCESS) {
+				return ERR_FILE_CORRUPT;
 			}
+
+			_jpgd_copy_scanline(dw + y * dst_bpl, pScan_line, image_width, comps);
 		}
 	}
 
@@ -1,23 +1,206 @@
 #include "summator.h"
 
-void Summator::add(int p_value) {
-	count += p_value;
+static uint64_t sum_int32(const int32_t *p_values, int64_t p_count) {
+	// Independent accumulators so the compiler can keep the lanes in SIMD registers;
+	// every value is widened before adding, so 32-bit input can't overflow.
+	int64_t lanes[4] = { 0, 0, 0, 0 };
+	int64_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		lanes[0] += p_values[i + 0];
+		lanes[1] += p_values[i + 1];
+		lanes[2] += p_values[i + 2];
+		lanes[3] += p_values[i + 3];
+	}
+	for (; i < p_count; i++) {
+		lanes[0] += p_values[i];
+	}
+	return (uint64_t)lanes[0] + (uint64_t)lanes[1] + (uint64_t)lanes[2] + (uint64_t)lanes[3];
 }
 
+static uint64_t sum_int64(const int64_t *p_values, int64_t p_count) {
+	// Summed as unsigned, which wraps like the scalar total instead of being undefined.
+	uint64_t lanes[4] = { 0, 0, 0, 0 };
+	int64_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		lanes[0] += (uint64_t)p_values[i + 0];
+		lanes[1] += (uint64_t)p_values[i + 1];
+		lanes[2] += (uint64_t)p_values[i + 2];
+		lanes[3] += (uint64_t)p_values[i + 3];
+	}
+	for (; i < p_count; i++) {
+		lanes[0] += (uint64_t)p_values[i];
+	}
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+static double sum_float64(const double *p_values, int64_t p_count) {
+	// Four partial sums, added in lane order at the end. The compiler may not reorder
+	// floating point additions itself, so the lanes are what make this vectorizable.
+	double lanes[4] = { 0.0, 0.0, 0.0, 0.0 };
+	int64_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		lanes[0] += p_values[i + 0];
+		lanes[1] += p_values[i + 1];
+		lanes[2] += p_values[i + 2];
+		lanes[3] += p_values[i + 3];
+	}
+	for (; i < p_count; i++) {
+		lanes[0] += p_values[i];
+	}
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// Threads get shard slots round-robin the first time they add.
+int Summator::get_shard_index() {
+	static SafeNumeric<uint32_t> next_shard;
+	thread_local int shard = -1;
+	if (shard < 0) {
+		shard = next_shard.postincrement() % SHARD_COUNT;
+	}
+	return shard;
+}
+
+void Summator::add_partial(uint64_t p_count, double p_float_total) {
+	if (!shards) {
+		count += p_count;
+		float_total += p_float_total;
+		return;
+	}
+
+	Shard &shard = shards[get_shard_index()];
+	if (p_count) {
+		shard.count.add(p_count);
+	}
+	if (p_float_total != 0.0) {
+		double current = shard.float_total.load(std::memory_order_relaxed);
+		while (!shard.float_total.compare_exchange_weak(current, current + p_float_total, std::memory_order_acq_rel)) {
+		}
+	}
+}
+
+void Summator::add(int64_t p_value) {
+	add_partial((uint64_t)p_value, 0.0);
+}
+
+void Summator::add_array(const Variant &p_values) {
+	switch (p_values.get_type()) {
+		case Variant::PACKED_INT32_ARRAY: {
+			const PackedInt32Array values = p_values;
+			add_int32_array(values.ptr(), values.size());
+		} break;
+		case Variant::PACKED_INT64_ARRAY: {
+			const PackedInt64Array values = p_values;
+			add_int64_array(values.ptr(), values.size());
+		} break;
+		case Variant::PACKED_FLOAT64_ARRAY: {
+			const PackedFloat64Array values = p_values;
+			add_float64_array(values.ptr(), values.size());
+		} break;
+		default: {
+			ERR_FAIL_MSG("Summator: add_array() expects a PackedInt32Array, PackedInt64Array or PackedFloat64Array.");
+		}
+	}
+}
+
+void Summator::add_int32_array(const int32_t *p_values, int64_t p_count) {
+	add_partial(sum_int32(p_values, p_count), 0.0);
+}
+
+void Summator::add_int64_array(const int64_t *p_values, int64_t p_count) {
+	add_partial(sum_int64(p_values, p_count), 0.0);
+}
+
+void Summator::add_float64_array(const double *p_values, int64_t p_count) {
+	add_partial(0, sum_float64(p_values, p_count));
+}
+
+// Not atomic with respect to concurrent adds; reset while no task is adding.
 void Summator::reset() {
 	count = 0;
+	float_total = 0.0;
+	if (shards) {
+		for (int i = 0; i < SHARD_COUNT; i++) {
+			shards[i].count.set(0);
+			shards[i].float_total.store(0.0, std::memory_order_release);
+		}
+	}
+}
+
+int64_t Summator::get_total() const {
+	uint64_t total = count;
+	if (shards) {
+		for (int i = 0; i < SHARD_COUNT; i++) {
+			total += shards[i].count.get();
+		}
+	}
+	return (int64_t)total;
+}
+
+double Summator::get_float_total() const {
+	double total = float_total;
+	if (shards) {
+		for (int i = 0; i < SHARD_COUNT; i++) {
+			total += shards[i].float_total.load(std::memory_order_acquire);
+		}
+	}
+	return total;
 }
 
-int Summator::get_total() const {
-	return count;
+// In concurrent mode every add goes to the calling thread's shard with a lock-free atomic add,
+// so one Summator can be shared between WorkerThreadPool tasks. Toggle it while nothing is adding.
+void Summator::set_concurrent(bool p_enabled) {
+	if (p_enabled == (shards != nullptr)) {
+		return;
+	}
+
+	if (p_enabled) {
+		// memnew_arr only aligns to 16 bytes, so the shards get their own aligned block.
+		shards = (Shard *)Memory::alloc_aligned_static(sizeof(Shard) * SHARD_COUNT, alignof(Shard));
+		for (int i = 0; i < SHARD_COUNT; i++) {
+			memnew_placement(&shards[i], Shard);
+			shards[i].count.set(0);
+			shards[i].float_total.store(0.0, std::memory_order_relaxed);
+		}
+	} else {
+		// Fold the shards back into the plain totals.
+		count = (uint64_t)get_total();
+		float_total = get_float_total();
+		free_shards();
+	}
+}
+
+void Summator::free_shards() {
+	for (int i = 0; i < SHARD_COUNT; i++) {
+		shards[i].~Shard();
+	}
+	Memory::free_aligned_static(shards);
+	shards = nullptr;
+}
+
+bool Summator::is_concurrent() const {
+	return shards != nullptr;
 }
 
 void Summator::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("add", "value"), &Summator::add);
+	ClassDB::bind_method(D_METHOD("add_array", "values"), &Summator::add_array);
 	ClassDB::bind_method(D_METHOD("reset"), &Summator::reset);
 	ClassDB::bind_method(D_METHOD("get_total"), &Summator::get_total);
+	ClassDB::bind_method(D_METHOD("get_float_total"), &Summator::get_float_total);
+	ClassDB::bind_method(D_METHOD("set_concurrent", "enabled"), &Summator::set_concurrent);
+	ClassDB::bind_method(D_METHOD("is_concurrent"), &Summator::is_concurrent);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "concurrent"), "set_concurrent", "is_concurrent");
 }
 
 Summator::Summator() {
 	count = 0;
+	float_total = 0.0;
+	shards = nullptr;
+}
+
+Summator::~Summator() {
+	if (shards) {
+		free_shards();
+	}
 }
\ No newline at end of file
@@ -2,21 +2,47 @@
 #define SUMMATOR_H
 
 #include "core/object/ref_counted.h"
+#include "core/templates/safe_refcount.h"
+
+#include <atomic>
 
 class Summator : public RefCounted {
 	GDCLASS(Summator, RefCounted);
 
-	int count;
+	// One per thread slot in concurrent mode, aligned so two threads never write the same cache line.
+	struct alignas(64) Shard {
+		SafeNumeric<uint64_t> count;
+		std::atomic<double> float_total;
+	};
+	static const int SHARD_COUNT = 32;
+
+	// Unsigned so that overflow wraps instead of being undefined; read back as int64_t.
+	uint64_t count;
+	double float_total;
+	Shard *shards;
+
+	static int get_shard_index();
+	void free_shards();
+	void add_partial(uint64_t p_count, double p_float_total);
 
 protected:
 	static void _bind_methods();
 
 public:
-	void add(int p_value);
+	void add(int64_t p_value);
+	void add_array(const Variant &p_values);
+	void add_int32_array(const int32_t *p_values, int64_t p_count);
+	void add_int64_array(const int64_t *p_values, int64_t p_count);
+	void add_float64_array(const double *p_values, int64_t p_count);
 	void reset();
-	int get_total() const;
+	int64_t get_total() const;
+	double get_float_total() const;
+
+	void set_concurrent(bool p_enabled);
+	bool is_concurrent() const;
 
 	Summator();
+	~Summator();
 };
 
 #endif // SUMMATOR_H
\ No newline at end of file
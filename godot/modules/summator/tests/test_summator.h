@@ -0,0 +1,119 @@
+#ifndef TEST_SUMMATOR_H
+#define TEST_SUMMATOR_H
+
+#include "../summator.h"
+
+#include "core/object/worker_thread_pool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSummator {
+
+TEST_CASE("[Summator] Adding packed arrays") {
+	Ref<Summator> summator;
+	summator.instantiate();
+
+	SUBCASE("PackedInt32Array") {
+		// Widened before adding, and a length that leaves a remainder after the lanes.
+		PackedInt32Array values = { INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, -7 };
+		summator->add_array(values);
+		CHECK(summator->get_total() == (int64_t)INT32_MAX * 5 - 7);
+		CHECK(summator->get_float_total() == 0.0);
+	}
+
+	SUBCASE("PackedInt64Array") {
+		PackedInt64Array values = { 1, -2, 3, -4, 5, 6, 7 };
+		summator->add(100);
+		summator->add_array(values);
+		CHECK(summator->get_total() == 116);
+	}
+
+	SUBCASE("PackedFloat64Array") {
+		PackedFloat64Array values = { 0.5, 1.25, -2.0, 4.0, 8.5 };
+		summator->add_array(values);
+		CHECK(summator->get_float_total() == doctest::Approx(12.25));
+		CHECK(summator->get_total() == 0);
+	}
+
+	SUBCASE("Other types are rejected") {
+		summator->add(3);
+		ERR_PRINT_OFF;
+		summator->add_array(PackedFloat32Array({ 1.0f, 2.0f }));
+		summator->add_array(Array());
+		ERR_PRINT_ON;
+		CHECK(summator->get_total() == 3);
+		CHECK(summator->get_float_total() == 0.0);
+	}
+
+	SUBCASE("Empty arrays") {
+		summator->add_array(PackedInt32Array());
+		summator->add_array(PackedInt64Array());
+		summator->add_array(PackedFloat64Array());
+		CHECK(summator->get_total() == 0);
+		CHECK(summator->get_float_total() == 0.0);
+	}
+}
+
+TEST_CASE("[Summator] 64-bit totals wrap around") {
+	Ref<Summator> summator;
+	summator.instantiate();
+
+	summator->add(INT64_MAX);
+	summator->add(1);
+	CHECK(summator->get_total() == INT64_MIN);
+
+	summator->reset();
+	summator->add_array(PackedInt64Array({ INT64_MAX, INT64_MAX, 2 }));
+	CHECK(summator->get_total() == 0);
+
+	summator->reset();
+	summator->set_concurrent(true);
+	summator->add(INT64_MIN);
+	summator->add(-1);
+	CHECK(summator->get_total() == INT64_MAX);
+}
+
+static void add_from_task(void *p_summator, uint32_t p_index) {
+	Summator *summator = (Summator *)p_summator;
+	summator->add(p_index + 1);
+	double half = (p_index + 1) * 0.5;
+	summator->add_float64_array(&half, 1);
+}
+
+TEST_CASE("[Summator] Concurrent adds from worker threads") {
+	Ref<Summator> summator;
+	summator.instantiate();
+	summator->add(10);
+	summator->set_concurrent(true);
+	REQUIRE(summator->is_concurrent());
+	CHECK_MESSAGE(summator->get_total() == 10, "Switching modes should keep the total.");
+
+	// Halves of small integers add up exactly in any order.
+	const int elements = 10000;
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(&add_from_task, summator.ptr(), elements, -1, true, "Summator test");
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK(summator->get_total() == 10 + (int64_t)elements * (elements + 1) / 2);
+	CHECK(summator->get_float_total() == (double)elements * (elements + 1) / 4);
+
+	SUBCASE("Folding the shards back") {
+		summator->set_concurrent(false);
+		CHECK_FALSE(summator->is_concurrent());
+		CHECK(summator->get_total() == 10 + (int64_t)elements * (elements + 1) / 2);
+		CHECK(summator->get_float_total() == (double)elements * (elements + 1) / 4);
+
+		summator->add(-10);
+		CHECK(summator->get_total() == (int64_t)elements * (elements + 1) / 2);
+	}
+
+	SUBCASE("Resetting clears every shard") {
+		summator->reset();
+		CHECK(summator->get_total() == 0);
+		CHECK(summator->get_float_total() == 0.0);
+		summator->add(5);
+		CHECK(summator->get_total() == 5);
+	}
+}
+
+} // namespace TestSummator
+
+#endif // TEST_SUMMATOR_H
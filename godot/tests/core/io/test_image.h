@@ -32,6 +32,8 @@
 #define TEST_IMAGE_H
 
 #include "core/io/image.h"
+#include "core/io/image_loader.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
 #include "tests/test_utils.h"
@@ -443,6 +445,375 @@ TEST_CASE("[Image] Convert image") {
 	CHECK_MESSAGE(image2->get_data() == image_data, "Image conversion to invalid type (Image::FORMAT_MAX + 1) should not alter image.");
 }
 
+static Ref<Image> make_pattern_image(int p_width, int p_height, Image::Format p_format) {
+	Ref<Image> image = Image::create_empty(p_width, p_height, false, p_format);
+	// Values outside [0, 1] only survive in half and float formats and test clamping on the way back.
+	const float range = p_format >= Image::FORMAT_RF ? 1.5 : 1.0;
+	for (int y = 0; y < p_height; y++) {
+		for (int x = 0; x < p_width; x++) {
+			const float r = ((x * 7 + y * 13) % 256) / 255.0 * range;
+			const float g = ((x * 31 + y * 3) % 256) / 255.0 * range;
+			const float b = ((x * 5 + y * 17 + 100) % 256) / 255.0 * range;
+			const float a = ((x + y * 11) % 256) / 255.0;
+			image->set_pixel(x, y, Color(r, g, b, a));
+		}
+	}
+	return image;
+}
+
+static void check_convert_matches_pixels(const Ref<Image> &p_image, Image::Format p_new_format) {
+	Ref<Image> expected = Image::create_empty(p_image->get_width(), p_image->get_height(), false, p_new_format);
+	for (int y = 0; y < p_image->get_height(); y++) {
+		for (int x = 0; x < p_image->get_width(); x++) {
+			expected->set_pixel(x, y, p_image->get_pixel(x, y));
+		}
+	}
+
+	Ref<Image> converted = p_image->duplicate();
+	converted->convert(p_new_format);
+	CHECK_MESSAGE(converted->get_data() == expected->get_data(),
+			vformat("Converting %s to %s should match converting pixel by pixel.", Image::format_names[p_image->get_format()], Image::format_names[p_new_format]));
+}
+
+TEST_CASE("[Image] Convert between bit depths") {
+	const Image::Format formats[] = {
+		Image::FORMAT_L8, Image::FORMAT_LA8, Image::FORMAT_R8, Image::FORMAT_RG8, Image::FORMAT_RGB8, Image::FORMAT_RGBA8,
+		Image::FORMAT_RH, Image::FORMAT_RGH, Image::FORMAT_RGBH, Image::FORMAT_RGBAH,
+		Image::FORMAT_RF, Image::FORMAT_RGF, Image::FORMAT_RGBF, Image::FORMAT_RGBAF
+	};
+
+	for (Image::Format format : formats) {
+		Ref<Image> image = make_pattern_image(33, 17, format);
+		for (Image::Format new_format : formats) {
+			if (new_format != format) {
+				check_convert_matches_pixels(image, new_format);
+			}
+		}
+	}
+
+	SUBCASE("Large images are split into row blocks") {
+		check_convert_matches_pixels(make_pattern_image(300, 260, Image::FORMAT_RGBA8), Image::FORMAT_RGBAF);
+		check_convert_matches_pixels(make_pattern_image(300, 260, Image::FORMAT_RGBAH), Image::FORMAT_RGB8);
+		check_convert_matches_pixels(make_pattern_image(300, 260, Image::FORMAT_L8), Image::FORMAT_RGBH);
+	}
+
+	SUBCASE("Mipmaps are converted too") {
+		Ref<Image> image = make_pattern_image(64, 32, Image::FORMAT_RGBA8);
+		image->generate_mipmaps();
+		Ref<Image> converted = image->duplicate();
+		converted->convert(Image::FORMAT_RGBAF);
+		REQUIRE(converted->has_mipmaps());
+		for (int mip = 0; mip <= image->get_mipmap_count(); mip++) {
+			Ref<Image> expected = image->get_image_from_mipmap(mip);
+			expected->convert(Image::FORMAT_RGBAF);
+			CHECK(converted->get_image_from_mipmap(mip)->get_data() == expected->get_data());
+		}
+	}
+}
+
+TEST_CASE("[Image] sRGB and linear conversion") {
+	Ref<Image> image = make_pattern_image(300, 260, Image::FORMAT_RGBA8);
+	Ref<Image> linear = image->duplicate();
+	linear->srgb_to_linear();
+
+	// Alpha is left alone, color channels go through the 8-bit lookup tables.
+	CHECK(linear->get_pixel(0, 0) == image->get_pixel(0, 0));
+	CHECK(linear->get_pixel(299, 259).a == image->get_pixel(299, 259).a);
+	CHECK(linear->get_pixel(299, 259).r <= image->get_pixel(299, 259).r);
+
+	Ref<Image> small = Image::create_empty(1, 1, false, Image::FORMAT_RGBA8);
+	small->set_pixel(0, 0, image->get_pixel(299, 259));
+	small->srgb_to_linear();
+	CHECK(linear->get_pixel(299, 259) == small->get_pixel(0, 0));
+}
+
+TEST_CASE("[Image] Resizing large images") {
+	const Image::Interpolation interpolations[] = {
+		Image::INTERPOLATE_NEAREST, Image::INTERPOLATE_BILINEAR, Image::INTERPOLATE_CUBIC, Image::INTERPOLATE_TRILINEAR, Image::INTERPOLATE_LANCZOS
+	};
+
+	// Large enough to be split into row blocks. A flat color must stay flat at any size.
+	const Color color = Color::from_rgba8(51, 102, 153, 204);
+	for (Image::Interpolation interpolation : interpolations) {
+		for (const Size2i &size : { Size2i(517, 333), Size2i(120, 90) }) {
+			Ref<Image> image = Image::create_empty(300, 280, false, Image::FORMAT_RGBA8);
+			image->fill(color);
+			const Color expected = image->get_pixel(0, 0);
+			image->resize(size.width, size.height, interpolation);
+			REQUIRE(image->get_size() == size);
+
+			bool flat = true;
+			for (int y = 0; y < size.height; y += 7) {
+				for (int x = 0; x < size.width; x += 5) {
+					flat = flat && image->get_pixel(x, y) == expected;
+				}
+			}
+			CHECK_MESSAGE(flat, vformat("Resizing a flat image with interpolation %d should keep its color.", interpolation));
+		}
+	}
+
+	SUBCASE("Cubic half float matches float") {
+		Ref<Image> image_f = make_pattern_image(64, 48, Image::FORMAT_RGBAF);
+		Ref<Image> image_h = image_f->duplicate();
+		image_h->convert(Image::FORMAT_RGBAH);
+
+		image_f->resize(100, 70, Image::INTERPOLATE_CUBIC);
+		image_h->resize(100, 70, Image::INTERPOLATE_CUBIC);
+
+		bool close = true;
+		for (int y = 0; y < 70; y++) {
+			for (int x = 0; x < 100; x++) {
+				const Color a = image_f->get_pixel(x, y);
+				const Color b = image_h->get_pixel(x, y);
+				close = close && Math::abs(a.r - b.r) < 0.01 && Math::abs(a.g - b.g) < 0.01 && Math::abs(a.b - b.b) < 0.01 && Math::abs(a.a - b.a) < 0.01;
+			}
+		}
+		CHECK(close);
+	}
+}
+
+TEST_CASE("[Image] Generating mipmaps for large images") {
+	// Large enough for the first levels (512x256 and up) to be split into row blocks.
+	Ref<Image> image = make_pattern_image(1024, 512, Image::FORMAT_RGBA8);
+	image->generate_mipmaps();
+	REQUIRE(image->get_mipmap_count() == 10);
+
+	for (int mip = 1; mip <= image->get_mipmap_count(); mip++) {
+		const PackedByteArray src = image->get_image_from_mipmap(mip - 1)->get_data();
+		Ref<Image> level = image->get_image_from_mipmap(mip);
+		const int src_width = MAX(1024 >> (mip - 1), 1);
+		const int src_height = MAX(512 >> (mip - 1), 1);
+		const PackedByteArray dst = level->get_data();
+
+		bool matches = true;
+		for (int y = 0; y < level->get_height(); y++) {
+			for (int x = 0; x < level->get_width(); x++) {
+				const int x0 = MIN(x * 2, src_width - 1);
+				const int x1 = MIN(x * 2 + 1, src_width - 1);
+				const int y0 = MIN(y * 2, src_height - 1);
+				const int y1 = MIN(y * 2 + 1, src_height - 1);
+				for (int c = 0; c < 4; c++) {
+					const int sum = src[(y0 * src_width + x0) * 4 + c] + src[(y0 * src_width + x1) * 4 + c] + src[(y1 * src_width + x0) * 4 + c] + src[(y1 * src_width + x1) * 4 + c];
+					matches = matches && dst[(y * level->get_width() + x) * 4 + c] == (sum + 2) >> 2;
+				}
+			}
+		}
+		CHECK_MESSAGE(matches, vformat("Mipmap level %d should be the 2x2 box average of the previous level.", mip));
+	}
+}
+
+TEST_CASE("[Image] Reading and writing pixel rects") {
+	const Rect2i rect = Rect2i(3, 2, 9, 5);
+
+	for (Image::Format format : { Image::FORMAT_RGBA8, Image::FORMAT_LA8, Image::FORMAT_RGBH, Image::FORMAT_RGBAF, Image::FORMAT_RGB565 }) {
+		Ref<Image> image = make_pattern_image(16, 12, format);
+
+		Vector<Color> colors = image->get_pixels_rect(rect);
+		REQUIRE(colors.size() == rect.size.x * rect.size.y);
+		bool matches = true;
+		for (int y = 0; y < rect.size.y; y++) {
+			for (int x = 0; x < rect.size.x; x++) {
+				matches = matches && colors[y * rect.size.x + x] == image->get_pixel(rect.position.x + x, rect.position.y + y);
+			}
+		}
+		CHECK_MESSAGE(matches, vformat("get_pixels_rect() should match get_pixel() for %s.", Image::format_names[format]));
+
+		// Writing must round trip the same way as set_pixel().
+		Ref<Image> expected = image->duplicate();
+		for (int i = 0; i < colors.size(); i++) {
+			colors.write[i] = colors[i].inverted();
+			expected->set_pixel(rect.position.x + i % rect.size.x, rect.position.y + i / rect.size.x, colors[i]);
+		}
+		image->set_pixels_rect(rect, colors);
+		CHECK_MESSAGE(image->get_data() == expected->get_data(), vformat("set_pixels_rect() should match set_pixel() for %s.", Image::format_names[format]));
+
+		// Raw data round trips into another position.
+		Vector<uint8_t> rect_data = image->get_data_rect(rect);
+		CHECK(rect_data.size() == rect.size.x * rect.size.y * Image::get_format_pixel_size(format));
+		image->set_data_rect(Rect2i(Point2i(), rect.size), rect_data);
+		CHECK(image->get_pixels_rect(Rect2i(Point2i(), rect.size)) == image->get_pixels_rect(rect));
+	}
+
+	Ref<Image> image = Image::create_empty(16, 12, false, Image::FORMAT_RGBA8);
+	ERR_PRINT_OFF;
+	CHECK(image->get_pixels_rect(Rect2i(10, 10, 8, 8)).is_empty());
+	CHECK(image->get_data_rect(Rect2i(0, 0, 0, 4)).is_empty());
+	image->set_pixels_rect(Rect2i(0, 0, 2, 2), Vector<Color>({ Color(1, 0, 0) }));
+	ERR_PRINT_ON;
+	CHECK(image->get_pixel(0, 0) == Color(0, 0, 0, 0));
+}
+
+TEST_CASE("[Image] Pixel spans") {
+	Ref<Image> image = Image::create_empty(8, 4, true, Image::FORMAT_RGB8);
+
+	Image::PixelSpan<uint8_t> span = image->get_pixel_span_w();
+	REQUIRE(span.is_valid());
+	CHECK(span.width == 8);
+	CHECK(span.height == 4);
+	CHECK(span.pixel_size == 3);
+	CHECK(span.stride == 24);
+	span.pixel(5, 2)[1] = 255;
+	CHECK(image->get_pixel(5, 2) == Color(0, 1, 0));
+
+	Image::PixelSpan<const uint8_t> mip_span = image->get_pixel_span(2);
+	REQUIRE(mip_span.is_valid());
+	CHECK(mip_span.width == 2);
+	CHECK(mip_span.height == 1);
+	CHECK(mip_span.data == image->ptr() + image->get_mipmap_offset(2));
+
+	ERR_PRINT_OFF;
+	CHECK_FALSE(image->get_pixel_span(image->get_mipmap_count() + 1).is_valid());
+	ERR_PRINT_ON;
+}
+
+static Ref<Image> blend_rect_per_pixel(const Ref<Image> &p_dst, const Ref<Image> &p_src, const Ref<Image> &p_mask, const Point2i &p_dest) {
+	Ref<Image> expected = p_dst->duplicate();
+	for (int y = 0; y < p_src->get_height(); y++) {
+		for (int x = 0; x < p_src->get_width(); x++) {
+			const Point2i dst = p_dest + Point2i(x, y);
+			if (!Rect2i(Point2i(), p_dst->get_size()).has_point(dst) || (p_mask.is_valid() && p_mask->get_pixel(x, y).a == 0)) {
+				continue;
+			}
+			const Color sc = p_src->get_pixel(x, y);
+			if (sc.a != 0) {
+				expected->set_pixel(dst.x, dst.y, expected->get_pixel(dst.x, dst.y).blend(sc));
+			}
+		}
+	}
+	return expected;
+}
+
+TEST_CASE("[Image] Blending and blitting large RGBA8 rects") {
+	Ref<Image> dst = make_pattern_image(320, 280, Image::FORMAT_RGBA8);
+	// Mostly opaque or fully transparent, like typical UI art, with some translucent pixels.
+	Ref<Image> src = Image::create_empty(300, 260, false, Image::FORMAT_RGBA8);
+	for (int y = 0; y < 260; y++) {
+		for (int x = 0; x < 300; x++) {
+			const int alpha = (x / 8 + y / 8) % 3 == 0 ? 0 : ((x + y) % 5 == 0 ? (x * 7 + y) % 256 : 255);
+			src->set_pixel(x, y, Color::from_rgba8(x % 256, y % 256, (x * y) % 256, alpha));
+		}
+	}
+	const Point2i dest = Point2i(30, -10);
+
+	SUBCASE("blend_rect") {
+		Ref<Image> expected = blend_rect_per_pixel(dst, src, Ref<Image>(), dest);
+		dst->blend_rect(src, Rect2i(Point2i(), src->get_size()), dest);
+		CHECK(dst->get_data() == expected->get_data());
+	}
+
+	SUBCASE("blend_rect_mask") {
+		for (Image::Format mask_format : { Image::FORMAT_LA8, Image::FORMAT_RGBA8, Image::FORMAT_RGBAH, Image::FORMAT_L8 }) {
+			Ref<Image> mask = make_pattern_image(300, 260, mask_format);
+			Ref<Image> image = dst->duplicate();
+			Ref<Image> expected = blend_rect_per_pixel(image, src, mask, dest);
+			image->blend_rect_mask(src, mask, Rect2i(Point2i(), src->get_size()), dest);
+			CHECK_MESSAGE(image->get_data() == expected->get_data(), vformat("blend_rect_mask() with a %s mask should match blending pixel by pixel.", Image::format_names[mask_format]));
+		}
+	}
+
+	SUBCASE("blit_rect_mask") {
+		Ref<Image> mask = make_pattern_image(300, 260, Image::FORMAT_LA8);
+		Ref<Image> expected = dst->duplicate();
+		for (int y = 0; y < 260; y++) {
+			for (int x = 0; x < 300; x++) {
+				const Point2i point = dest + Point2i(x, y);
+				if (Rect2i(Point2i(), dst->get_size()).has_point(point) && mask->get_pixel(x, y).a != 0) {
+					expected->set_pixelv(point, src->get_pixel(x, y));
+				}
+			}
+		}
+		dst->blit_rect_mask(src, mask, Rect2i(Point2i(), src->get_size()), dest);
+		CHECK(dst->get_data() == expected->get_data());
+	}
+
+	SUBCASE("Blitting an image onto itself reads the original pixels") {
+		Ref<Image> expected = dst->duplicate();
+		expected->blit_rect(dst->duplicate(), Rect2i(0, 0, 200, 200), Point2i(7, 5));
+		dst->blit_rect(dst, Rect2i(0, 0, 200, 200), Point2i(7, 5));
+		CHECK(dst->get_data() == expected->get_data());
+	}
+}
+
+TEST_CASE("[Image] Loading a batch of files") {
+	Vector<Ref<Image>> originals;
+	PackedStringArray paths;
+	for (int i = 0; i < 4; i++) {
+		Ref<Image> image = make_pattern_image(40 + i * 13, 30 + i * 7, i % 2 ? Image::FORMAT_RGB8 : Image::FORMAT_RGBA8);
+		const String path = TestUtils::get_temp_path(vformat("batch_image_%d.png", i));
+		REQUIRE(image->save_png(path) == OK);
+		originals.push_back(image);
+		paths.push_back(path);
+	}
+	paths.push_back(TestUtils::get_temp_path("batch_image_missing.png"));
+
+	SUBCASE("Images keep their data and order") {
+		ERR_PRINT_OFF;
+		const Vector<Ref<Image>> images = ImageLoader::load_images(paths);
+		ERR_PRINT_ON;
+		REQUIRE(images.size() == paths.size());
+		for (int i = 0; i < originals.size(); i++) {
+			REQUIRE(images[i].is_valid());
+			CHECK(images[i]->get_format() == originals[i]->get_format());
+			CHECK(images[i]->get_data() == originals[i]->get_data());
+		}
+		CHECK_MESSAGE(images[originals.size()].is_null(), "A file that fails to load should give a null image.");
+	}
+
+	SUBCASE("Converting and generating mipmaps in the same job") {
+		paths.resize(originals.size());
+		const TypedArray<Image> images = Image::load_from_files(paths, Image::FORMAT_RGBA8, true);
+		REQUIRE(images.size() == originals.size());
+		for (int i = 0; i < originals.size(); i++) {
+			Ref<Image> expected = originals[i]->duplicate();
+			expected->convert(Image::FORMAT_RGBA8);
+			expected->generate_mipmaps();
+			Ref<Image> image = images[i];
+			REQUIRE(image.is_valid());
+			CHECK(image->has_mipmaps());
+			CHECK(image->get_data() == expected->get_data());
+		}
+	}
+}
+
+#ifdef MODULE_JPG_ENABLED
+struct JPGDecodeJob {
+	PackedByteArray data;
+	Ref<Image> image;
+};
+
+static void decode_jpg_task(void *p_userdata) {
+	JPGDecodeJob *job = (JPGDecodeJob *)p_userdata;
+	job->image->load_jpg_from_buffer(job->data);
+}
+
+TEST_CASE("[Image] Decoding JPG restart intervals in parallel") {
+	// 512x512, 4:2:0, with a restart marker after every MCU row.
+	const PackedByteArray data = FileAccess::get_file_as_bytes(TestUtils::get_data_path("images/restart_markers.jpg"));
+	REQUIRE(data.size() > 0);
+	bool has_dri = false;
+	for (int i = 0; i + 1 < data.size() && !has_dri; i++) {
+		has_dri = data[i] == 0xFF && data[i + 1] == 0xDD;
+	}
+	REQUIRE_MESSAGE(has_dri, "The test image should define a restart interval.");
+
+	Ref<Image> parallel;
+	parallel.instantiate();
+	REQUIRE(parallel->load_jpg_from_buffer(data) == OK);
+	CHECK(parallel->get_size() == Size2i(512, 512));
+	CHECK(parallel->get_format() == Image::FORMAT_RGB8);
+
+	// Decoding on a pool thread always takes the serial path.
+	JPGDecodeJob job;
+	job.data = data;
+	job.image.instantiate();
+	WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_native_task(decode_jpg_task, &job, true);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+	REQUIRE(job.image->get_size() == parallel->get_size());
+
+	CHECK_MESSAGE(parallel->get_data() == job.image->get_data(), "Decoding the restart intervals in parallel should give the same bytes as a serial decode.");
+}
+#endif // MODULE_JPG_ENABLED
+
 } // namespace TestImage
 
 #endif // TEST_IMAGE_H
@@ -0,0 +1,139 @@
+/**************************************************************************/
+/*  test_work_stealing_deque.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_WORK_STEALING_DEQUE_H
+#define TEST_WORK_STEALING_DEQUE_H
+
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/work_stealing_deque.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkStealingDeque {
+
+TEST_CASE("[WorkStealingDeque] Owner pops LIFO, thieves steal FIFO") {
+	WorkStealingDeque<int, 8> deque;
+	CHECK(deque.is_empty());
+
+	for (int i = 1; i <= 4; i++) {
+		CHECK(deque.push(i));
+	}
+	CHECK(deque.size() == 4);
+
+	int value = 0;
+	CHECK(deque.pop(value));
+	CHECK(value == 4);
+	CHECK(deque.steal(value));
+	CHECK(value == 1);
+	CHECK(deque.pop(value));
+	CHECK(value == 3);
+	CHECK(deque.steal(value));
+	CHECK(value == 2);
+
+	CHECK(deque.is_empty());
+	CHECK_FALSE(deque.pop(value));
+	CHECK_FALSE(deque.steal(value));
+}
+
+TEST_CASE("[WorkStealingDeque] Push fails when full") {
+	WorkStealingDeque<int, 4> deque;
+	for (int i = 0; i < 4; i++) {
+		CHECK(deque.push(i));
+	}
+	CHECK_FALSE(deque.push(4));
+
+	int value = 0;
+	CHECK(deque.steal(value));
+	CHECK(value == 0);
+	CHECK(deque.push(4)); // Wraps around into the freed slot.
+
+	for (int expected = 4; expected >= 1; expected--) {
+		CHECK(deque.pop(value));
+		CHECK(value == expected);
+	}
+	CHECK(deque.is_empty());
+}
+
+static const int STRESS_ELEMENTS = 100000;
+static WorkStealingDeque<int, 64> stress_deque;
+static LocalVector<SafeNumeric<int>> stress_taken;
+static SafeFlag stress_done;
+
+static void stress_thief(void *p_userdata) {
+	int value = 0;
+	while (!stress_done.is_set() || !stress_deque.is_empty()) {
+		if (stress_deque.steal(value)) {
+			stress_taken[value].increment();
+		}
+	}
+}
+
+TEST_CASE("[WorkStealingDeque] Every element is taken exactly once with concurrent thieves") {
+	stress_taken.clear();
+	stress_taken.resize(STRESS_ELEMENTS);
+	stress_done.clear();
+
+	Thread thieves[3];
+	for (Thread &thief : thieves) {
+		thief.start(stress_thief, nullptr);
+	}
+
+	int value = 0;
+	int next = 0;
+	while (next < STRESS_ELEMENTS) {
+		if (stress_deque.push(next)) {
+			next++;
+		}
+		// Pop every few pushes so the owner also races the thieves for the last element.
+		if (next % 3 == 0 && stress_deque.pop(value)) {
+			stress_taken[value].increment();
+		}
+	}
+	while (stress_deque.pop(value)) {
+		stress_taken[value].increment();
+	}
+
+	stress_done.set();
+	for (Thread &thief : thieves) {
+		thief.wait_to_finish();
+	}
+
+	bool all_taken_once = true;
+	for (int i = 0; i < STRESS_ELEMENTS; i++) {
+		// Reduce number of check messages.
+		all_taken_once &= stress_taken[i].get() == 1;
+	}
+	CHECK(all_taken_once);
+}
+
+} // namespace TestWorkStealingDeque
+
+#endif // TEST_WORK_STEALING_DEQUE_H
@@ -32,6 +32,7 @@
 #define TEST_WORKER_THREAD_POOL_H
 
 #include "core/object/worker_thread_pool.h"
+#include "core/templates/parallel_for.h"
 
 #include "tests/test_macros.h"
 
@@ -107,6 +108,218 @@ TEST_CASE("[WorkerThreadPool] Process elements using group tasks") {
 	}
 }
 
+static void static_nested_child(void *p_arg) {
+	counter[(uintptr_t)p_arg].increment();
+}
+
+static void static_nested_parent(void *p_arg) {
+	// Tasks added from a worker go to its local queue; waiting on them runs or steals them back.
+	const uint32_t first = (uintptr_t)p_arg * 8;
+	WorkerThreadPool::TaskID children[8];
+	for (uint32_t i = 0; i < 8; i++) {
+		children[i] = WorkerThreadPool::get_singleton()->add_native_task(static_nested_child, (void *)(uintptr_t)(first + i), true);
+	}
+	for (uint32_t i = 0; i < 8; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(children[i]);
+	}
+}
+
+TEST_CASE("[WorkerThreadPool] Run tasks added from worker threads") {
+	const int parents = 16;
+	counter.clear();
+	counter.resize(parents * 8);
+
+	WorkerThreadPool::get_singleton()->reset_statistics();
+	LocalVector<WorkerThreadPool::TaskID> task_ids;
+	for (int i = 0; i < parents; i++) {
+		task_ids.push_back(WorkerThreadPool::get_singleton()->add_native_task(static_nested_parent, (void *)(uintptr_t)i, true));
+	}
+	for (uint32_t i = 0; i < task_ids.size(); i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_ids[i]);
+	}
+
+	bool all_run_once = true;
+	for (int i = 0; i < parents * 8; i++) {
+		//Reduce number of check messages
+		all_run_once &= counter[i].get() == 1;
+	}
+	CHECK(all_run_once);
+
+#ifdef THREADS_ENABLED
+	Dictionary statistics = WorkerThreadPool::get_singleton()->get_statistics();
+	CHECK_MESSAGE((int64_t)statistics["posted_local"] == parents * 8, "Tasks added from workers should stay on their local queues.");
+	CHECK_MESSAGE((int64_t)statistics["posted_global"] == parents, "Tasks added from the main thread should go to the shared queue.");
+	CHECK_MESSAGE((int64_t)statistics["popped_local"] + (int64_t)statistics["stolen"] == parents * 8, "Every local task should be taken by its owner or stolen.");
+#endif
+}
+
+static SafeNumeric<int> graph_stage;
+static SafeFlag graph_order_ok;
+
+static void static_graph_first(void *p_arg) {
+	if (graph_stage.get() != 0) {
+		graph_order_ok.clear();
+	}
+	graph_stage.increment();
+}
+
+static void static_graph_middle(void *p_arg, uint32_t p_index) {
+	// Runs only after the first node.
+	if (graph_stage.get() < 1) {
+		graph_order_ok.clear();
+	}
+	counter[p_index].increment();
+}
+
+static void static_graph_last(void *p_arg) {
+	// Both middle nodes (2 * elements) must be done.
+	for (uint32_t i = 0; i < counter.size(); i++) {
+		if (counter[i].get() != 2) {
+			graph_order_ok.clear();
+		}
+	}
+	graph_stage.increment();
+}
+
+static void static_graph_completed() {
+	graph_stage.add(10);
+}
+
+TEST_CASE("[WorkerThreadPool] Run a task graph in dependency order") {
+	for (int iterations = 0; iterations < 100; iterations++) {
+		const int count = Math::pow(2.0f, Math::random(0.0f, 6.0f));
+		counter.clear();
+		counter.resize(count);
+		graph_stage.set(0);
+		graph_order_ok.set();
+
+		// first -> (middle A, middle B) -> last
+		WorkerThreadPool::TaskGraphID graph = WorkerThreadPool::get_singleton()->create_task_graph(Math::rand() % 2);
+		int first = WorkerThreadPool::get_singleton()->add_native_graph_task(graph, static_graph_first, nullptr);
+		int middle_a = WorkerThreadPool::get_singleton()->add_native_graph_group_task(graph, static_graph_middle, nullptr, count, { first });
+		int middle_b = WorkerThreadPool::get_singleton()->add_native_graph_group_task(graph, static_graph_middle, nullptr, count, { first }, 2);
+		WorkerThreadPool::get_singleton()->add_native_graph_task(graph, static_graph_last, nullptr, { middle_a, middle_b });
+		WorkerThreadPool::get_singleton()->start_task_graph(graph, callable_mp_static(static_graph_completed));
+		WorkerThreadPool::get_singleton()->wait_for_task_graph_completion(graph);
+
+		CHECK(graph_order_ok.is_set());
+		CHECK(graph_stage.get() == 12);
+	}
+}
+
+TEST_CASE("[WorkerThreadPool] Reject task graph dependencies on later nodes") {
+	WorkerThreadPool::TaskGraphID graph = WorkerThreadPool::get_singleton()->create_task_graph();
+	ERR_PRINT_OFF;
+	CHECK(WorkerThreadPool::get_singleton()->add_native_graph_task(graph, static_graph_first, nullptr, { 0 }) == -1);
+	ERR_PRINT_ON;
+
+	// An empty graph completes right away.
+	WorkerThreadPool::get_singleton()->start_task_graph(graph);
+	WorkerThreadPool::get_singleton()->wait_for_task_graph_completion(graph);
+}
+
+static void static_count_range(int64_t p_from, int64_t p_to) {
+	for (int64_t i = p_from; i < p_to; i++) {
+		counter[i].increment();
+	}
+}
+
+static int64_t static_sum_range(int64_t p_from, int64_t p_to) {
+	int64_t sum = 0;
+	for (int64_t i = p_from; i < p_to; i++) {
+		sum += i;
+	}
+	return sum;
+}
+
+static int64_t static_add(int64_t p_a, int64_t p_b) {
+	return p_a + p_b;
+}
+
+TEST_CASE("[WorkerThreadPool] Split ranges with parallel_for and parallel_reduce") {
+	SUBCASE("Every element is visited once") {
+		for (int64_t grain : { 0, 1, 7, 100000 }) {
+			counter.clear();
+			counter.resize(10000);
+			parallel_for(
+					3, 10000, [](int64_t p_from, int64_t p_to) {
+						static_count_range(p_from, p_to);
+					},
+					grain);
+
+			bool visited_once = counter[0].get() == 0 && counter[1].get() == 0 && counter[2].get() == 0;
+			for (int i = 3; i < 10000; i++) {
+				visited_once = visited_once && counter[i].get() == 1;
+			}
+			CHECK_MESSAGE(visited_once, vformat("Every element should be visited once with a grain of %d.", grain));
+		}
+	}
+
+	SUBCASE("Empty ranges don't call the function") {
+		bool called = false;
+		parallel_for(5, 5, [&called](int64_t p_from, int64_t p_to) {
+			called = true;
+		});
+		CHECK_FALSE(called);
+		CHECK(parallel_reduce(8, 2, (int64_t)42, static_sum_range, static_add) == 42);
+	}
+
+	SUBCASE("Block values are folded in order") {
+		String expected;
+		for (int i = 0; i < 5000; i += 64) {
+			expected += itos(i) + ",";
+		}
+		const String result = parallel_reduce(
+				0, 5000, String(), [](int64_t p_from, int64_t p_to) {
+					return itos(p_from) + ",";
+				},
+				[](const String &p_accumulated, const String &p_value) {
+					return p_accumulated + p_value;
+				},
+				64);
+		CHECK(result == expected);
+		CHECK(parallel_reduce(0, 100000, (int64_t)0, static_sum_range, static_add) == (int64_t)100000 * 99999 / 2);
+	}
+
+	SUBCASE("Pools without threads run inline") {
+		WorkerThreadPool *pool = memnew(WorkerThreadPool(false));
+		REQUIRE(pool->get_thread_count() == 0);
+
+		for (int64_t grain : { 0, 7 }) {
+			counter.clear();
+			counter.resize(1000);
+			parallel_for(
+					0, 1000, [](int64_t p_from, int64_t p_to) {
+						static_count_range(p_from, p_to);
+					},
+					grain, pool);
+
+			bool visited_once = true;
+			for (int i = 0; i < 1000; i++) {
+				visited_once = visited_once && counter[i].get() == 1;
+			}
+			CHECK_MESSAGE(visited_once, vformat("Every element should be visited once with a grain of %d.", grain));
+			CHECK(parallel_reduce(0, 1000, (int64_t)0, static_sum_range, static_add, grain, pool) == 499500);
+		}
+
+		memdelete(pool);
+	}
+
+	SUBCASE("Callables") {
+		counter.clear();
+		counter.resize(1000);
+		WorkerThreadPool::get_singleton()->parallel_for(0, 1000, callable_mp_static(static_count_range), 10);
+		bool visited_once = true;
+		for (int i = 0; i < 1000; i++) {
+			visited_once = visited_once && counter[i].get() == 1;
+		}
+		CHECK(visited_once);
+
+		const Variant sum = WorkerThreadPool::get_singleton()->parallel_reduce(0, 1000, 0, callable_mp_static(static_sum_range), callable_mp_static(static_add), 10);
+		CHECK(sum == Variant(499500));
+	}
+}
+
 static void static_test_daemon(void *p_arg) {
 	while (!exit.is_set()) {
 		counter[0].add(1);